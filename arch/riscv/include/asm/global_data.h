@@ -26,6 +26,7 @@ struct arch_global_data {
 #endif
 #if CONFIG_IS_ENABLED(SMP)
 	struct ipi_data ipi[CONFIG_NR_CPUS];
+	ulong ipi_harts;	/* harts in the device tree, 0 if not scanned */
 #endif
 #ifndef CONFIG_XIP
 	ulong available_harts;
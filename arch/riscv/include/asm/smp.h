@@ -23,16 +23,22 @@
  * first IPI, it is set to 1. This prevents already-pending IPIs not sent by
  * U-Boot from being taken.
  *
+ * @pending is set by the sending hart and cleared by the target hart once it
+ * has taken the IPI. The sender waits on it, since not every IPI driver can
+ * read back whether an IPI is still pending.
+ *
  * @addr: Address of function
  * @arg0: First argument of function
  * @arg1: Second argument of function
  * @valid: Whether this IPI is valid
+ * @pending: Whether this IPI has not been taken yet
  */
 struct ipi_data {
 	ulong addr;
 	ulong arg0;
 	ulong arg1;
 	unsigned int valid;
+	unsigned int pending;
 };
 
 /**
@@ -58,6 +64,17 @@ void handle_ipi(ulong hart);
  */
 int smp_call_function(ulong addr, ulong arg0, ulong arg1, int wait);
 
+/**
+ * smp_get_ipi_harts() - Get the harts which smp_call_function() signals
+ *
+ * These are the available harts in the device tree, other than the one we
+ * are running on. The device tree is only scanned on the first call.
+ *
+ * @maskp: Returns the mask of hart IDs
+ * Return: 0 if OK, -ve on error
+ */
+int smp_get_ipi_harts(ulong *maskp);
+
 /**
  * riscv_init_ipi() - Initialize inter-process interrupt (IPI) driver
  *
@@ -79,6 +96,17 @@ int riscv_init_ipi(void);
  */
 int riscv_send_ipi(int hart);
 
+/**
+ * riscv_send_ipi_mask() - Send inter-processor interrupts (IPIs) to many harts
+ *
+ * Platform code may provide this function if it can signal several harts at
+ * once. The default calls riscv_send_ipi() for each hart.
+ *
+ * @mask: Mask of hart IDs of receiving harts
+ * Return: 0 if OK, -ve on error
+ */
+int riscv_send_ipi_mask(ulong mask);
+
 /**
  * riscv_clear_ipi() - Clear inter-processor interrupt (IPI)
  *
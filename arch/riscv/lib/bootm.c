@@ -9,6 +9,8 @@
 #include <common.h>
 #include <bootstage.h>
 #include <command.h>
+#include <console.h>
+#include <delay_stats.h>
 #include <dm.h>
 #include <fdt_support.h>
 #include <hang.h>
@@ -39,12 +41,16 @@ static void announce_and_cleanup(int fake)
 	printf("\nStarting kernel ...%s\n\n", fake ?
 		"(fake run for tracing)" : "");
 	bootstage_mark_name(BOOTSTAGE_ID_BOOTM_HANDOFF, "start_kernel");
+	/* report any call site which busy-waited for 1ms or more */
+	delay_stats_bootstage(1000);
 #ifdef CONFIG_BOOTSTAGE_FDT
 	bootstage_fdt_add_report();
 #endif
 #ifdef CONFIG_BOOTSTAGE_REPORT
 	bootstage_report();
 #endif
+	/* the OS does not know about the ring, so send it all now */
+	console_defer_enable(false);
 
 #ifdef CONFIG_USB_DEVICE
 	udc_disconnect();
@@ -23,6 +23,13 @@ int riscv_send_ipi(int hart)
 	return 0;
 }
 
+int riscv_send_ipi_mask(ulong mask)
+{
+	sbi_send_ipi(&mask);
+
+	return 0;
+}
+
 int riscv_clear_ipi(int hart)
 {
 	csr_clear(CSR_SIP, SIP_SSIP);
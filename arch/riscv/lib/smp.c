@@ -13,11 +13,20 @@
 
 DECLARE_GLOBAL_DATA_PTR;
 
-static int send_ipi_many(struct ipi_data *ipi, int wait)
+/*
+ * Work out from the device tree which harts can take an IPI. The result is
+ * kept in global data, so the cpus node is only walked once.
+ */
+static int smp_get_dt_harts(ulong *maskp)
 {
 	ofnode node, cpus;
+	ulong mask = 0;
 	u32 reg;
-	int ret, pending;
+
+	if (gd->arch.ipi_harts) {
+		*maskp = gd->arch.ipi_harts;
+		return 0;
+	}
 
 	cpus = ofnode_path("/cpus");
 	if (!ofnode_valid(cpus)) {
@@ -31,12 +40,7 @@ static int send_ipi_many(struct ipi_data *ipi, int wait)
 			continue;
 
 		/* read hart ID of CPU */
-		ret = ofnode_read_u32(node, "reg", &reg);
-		if (ret)
-			continue;
-
-		/* skip if it is the hart we are running on */
-		if (reg == gd->arch.boot_hart)
+		if (ofnode_read_u32(node, "reg", &reg))
 			continue;
 
 		if (reg >= CONFIG_NR_CPUS) {
@@ -45,15 +49,89 @@ static int send_ipi_many(struct ipi_data *ipi, int wait)
 			continue;
 		}
 
+		mask |= 1UL << reg;
+	}
+
+	gd->arch.ipi_harts = mask;
+	*maskp = mask;
+
+	return 0;
+}
+
+int smp_get_ipi_harts(ulong *maskp)
+{
+	ulong mask;
+	int ret;
+
+	ret = smp_get_dt_harts(&mask);
+	if (ret)
+		return ret;
+
+	/* skip the hart we are running on */
+	mask &= ~(1UL << gd->arch.boot_hart);
+
 #ifndef CONFIG_XIP
-		/* skip if hart is not available */
-		if (!(gd->arch.available_harts & (1 << reg)))
-			continue;
+	/* skip harts which are not available */
+	mask &= gd->arch.available_harts;
 #endif
+	*maskp = mask;
+
+	return 0;
+}
+
+__weak int riscv_send_ipi_mask(ulong mask)
+{
+	int reg, ret;
+
+	for (reg = 0; reg < CONFIG_NR_CPUS; reg++) {
+		if (!(mask & (1UL << reg)))
+			continue;
+
+		ret = riscv_send_ipi(reg);
+		if (ret) {
+			pr_err("Cannot send IPI to hart %d\n", reg);
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/* Wait until all harts in @mask have taken their IPI */
+static void wait_ipi_many(ulong mask)
+{
+	int reg;
+
+	while (mask) {
+		for (reg = 0; reg < CONFIG_NR_CPUS; reg++) {
+			if (!(mask & (1UL << reg)))
+				continue;
+
+			if (!__smp_load_acquire(&gd->arch.ipi[reg].pending))
+				mask &= ~(1UL << reg);
+		}
+	}
+}
+
+static int send_ipi_many(struct ipi_data *ipi, int wait)
+{
+	ulong mask;
+	int reg, ret;
+
+	ret = smp_get_ipi_harts(&mask);
+	if (ret)
+		return ret;
+	if (!mask)
+		return 0;
+
+	for (reg = 0; reg < CONFIG_NR_CPUS; reg++) {
+		if (!(mask & (1UL << reg)))
+			continue;
 
 		gd->arch.ipi[reg].addr = ipi->addr;
 		gd->arch.ipi[reg].arg0 = ipi->arg0;
 		gd->arch.ipi[reg].arg1 = ipi->arg1;
+		gd->arch.ipi[reg].pending = 1;
 
 		/*
 		 * Ensure valid only becomes set when the IPI parameters are
@@ -62,22 +140,15 @@ static int send_ipi_many(struct ipi_data *ipi, int wait)
 		 * initialized, and that it is ok to call the function.
 		 */
 		__smp_store_release(&gd->arch.ipi[reg].valid, 1);
+	}
 
-		ret = riscv_send_ipi(reg);
-		if (ret) {
-			pr_err("Cannot send IPI to hart %d\n", reg);
-			return ret;
-		}
+	/* signal all harts at once, then wait for all of them together */
+	ret = riscv_send_ipi_mask(mask);
+	if (ret)
+		return ret;
 
-		if (wait) {
-			pending = 1;
-			while (pending) {
-				ret = riscv_get_ipi(reg, &pending);
-				if (ret)
-					return ret;
-			}
-		}
-	}
+	if (wait)
+		wait_ipi_many(mask);
 
 	return 0;
 }
@@ -110,6 +181,7 @@ void handle_ipi(ulong hart)
 		pr_err("Cannot clear IPI of hart %ld (error %d)\n", hart, ret);
 		return;
 	}
+	__smp_store_release(&gd->arch.ipi[hart].pending, 0);
 
 	smp_function(hart, gd->arch.ipi[hart].arg0, gd->arch.ipi[hart].arg1);
 }
@@ -61,3 +61,11 @@ void __noreturn jump_to_image_no_args(struct spl_image_info *spl_image)
 #endif
 	image_entry(gd->arch.boot_hart, fdt_blob);
 }
+
+#if CONFIG_IS_ENABLED(OS_BOOT)
+/* Linux takes the same boot hart ID and device tree arguments as U-Boot */
+void __noreturn jump_to_image_linux(struct spl_image_info *spl_image)
+{
+	jump_to_image_no_args(spl_image);
+}
+#endif
@@ -25,6 +25,8 @@ cmd_build_spl_platform = \
 		-o $(srctree)/bootinfo_sd.bin && \
 	rm -f $(srctree)/board/$(CONFIG_SYS_VENDOR)/$(CONFIG_SYS_BOARD)/u-boot-spl.bin
 
+# Keep the image data outside the FIT and aligned to the 512-byte block size,
+# so that SPL can read each image straight to its load address
 quiet_cmd_build_itb = BUILD   $2
 cmd_build_itb = \
 	mkdir -p $(srctree)/board/$(CONFIG_SYS_VENDOR)/$(CONFIG_SYS_BOARD)/dtb && \
@@ -33,7 +35,7 @@ cmd_build_itb = \
 		$(srctree)/board/$(CONFIG_SYS_VENDOR)/$(CONFIG_SYS_BOARD)/dtb/ && \
 	cp $(srctree)/u-boot-nodtb.bin \
 		$(srctree)/board/$(CONFIG_SYS_VENDOR)/$(CONFIG_SYS_BOARD)/ && \
-	$(srctree)/tools/mkimage -f \
+	$(srctree)/tools/mkimage -E -B 0x200 -f \
 		$(srctree)/board/$(CONFIG_SYS_VENDOR)/$(CONFIG_SYS_BOARD)/configs/uboot_fdt.its \
 		-r $(srctree)/$2;\
 	rm -rf $(srctree)/board/$(CONFIG_SYS_VENDOR)/$(CONFIG_SYS_BOARD)/dtb && \
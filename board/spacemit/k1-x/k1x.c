@@ -9,6 +9,7 @@
 #include <dm/lists.h>
 #include <env.h>
 #include <fdtdec.h>
+#include <fdt_support.h>
 #include <image.h>
 #include <log.h>
 #include <mapmem.h>
@@ -812,42 +813,37 @@ static int get_chipinfo_from_efuse(uint32_t *product_id, uint32_t *wafer_tid)
 	return 0;
 }
 
-static int ft_board_cpu_fixup(void *blob, struct bd_info *bd)
+static int ft_board_cpu_fixup(struct fdt_edit *edit, struct bd_info *bd)
 {
-	int node, ret;
-	uint32_t dro, product_id, wafer_tid;
+	int node;
+	uint32_t product_id, wafer_tid;
 
-	node = fdt_path_offset(blob, "/");
+	node = fdt_edit_node(edit, "/");
 	if (node < 0) {
 		pr_err("Can't find root node!\n");
 		return -EINVAL;
 	}
 
 	get_chipinfo_from_efuse(&product_id, &wafer_tid);
-	product_id = cpu_to_fdt32(product_id);
-	wafer_tid = cpu_to_fdt32(wafer_tid);
-	fdt_setprop(blob, node, "product-id", &product_id, sizeof(product_id));
-	fdt_setprop(blob, node, "wafer-id", &wafer_tid, sizeof(wafer_tid));
+	fdt_edit_setprop_u32(edit, node, "product-id", product_id);
+	fdt_edit_setprop_u32(edit, node, "wafer-id", wafer_tid);
 
-	node = fdt_path_offset(blob, "/cpus");
+	node = fdt_edit_node(edit, "/cpus");
 	if (node < 0) {
 		pr_err("Can't find cpus node!\n");
 		return -EINVAL;
 	}
 
-	dro = cpu_to_fdt32(get_dro_from_efuse());
-	ret = fdt_setprop(blob, node, "svt-dro", &dro, sizeof(dro));
-	if (ret < 0)
-		return ret;
-	return 0;
+	return fdt_edit_setprop_u32(edit, node, "svt-dro",
+				    get_dro_from_efuse());
 }
 
-static int ft_board_info_fixup(void *blob, struct bd_info *bd)
+static int ft_board_info_fixup(struct fdt_edit *edit, struct bd_info *bd)
 {
 	int node;
 	const char *part_number;
 
-	node = fdt_path_offset(blob, "/");
+	node = fdt_edit_node(edit, "/");
 	if (node < 0) {
 		pr_err("Can't find root node!\n");
 		return -EINVAL;
@@ -855,19 +851,19 @@ static int ft_board_info_fixup(void *blob, struct bd_info *bd)
 
 	part_number = env_get("part#");
 	if (NULL != part_number)
-		fdt_setprop(blob, node, "part-number", part_number, strlen(part_number));
+		fdt_edit_setprop(edit, node, "part-number", part_number, strlen(part_number));
 
 	return 0;
 }
 
-static int ft_board_mac_addr_fixup(void *blob, struct bd_info *bd)
+static int ft_board_mac_addr_fixup(struct fdt_edit *edit, struct bd_info *bd)
 {
 	int node, i;
 	const char *addr_value;
 	// char addr_str[ARP_HLEN_ASCII + 1];
 	const char *mac_item[] = {"wifi_addr", "bt_addr"};
 
-	node = fdt_path_offset(blob, "/soc");
+	node = fdt_edit_node(edit, "/soc");
 	if (node < 0) {
 		pr_err("Can't find soc node!\n");
 		return -EINVAL;
@@ -878,7 +874,7 @@ static int ft_board_mac_addr_fixup(void *blob, struct bd_info *bd)
 		if (NULL != addr_value) {
 			// memset(addr_str, 0, sizeof(addr_str));
 			// sprintf(addr_str, "%pM", addr_value);
-			fdt_setprop(blob, node, mac_item[i], addr_value, strlen(addr_value));
+			fdt_edit_setprop(edit, node, mac_item[i], addr_value, strlen(addr_value));
 		}
 	}
 
@@ -887,6 +883,8 @@ static int ft_board_mac_addr_fixup(void *blob, struct bd_info *bd)
 
 int ft_board_setup(void *blob, struct bd_info *bd)
 {
+	struct fdt_edit edit;
+	int ret;
 
 	static const struct node_info nodes[] = {
 		{ "spacemit,k1x-qspi", MTD_DEV_TYPE_NOR, },  /* SPI flash */
@@ -906,9 +904,22 @@ int ft_board_setup(void *blob, struct bd_info *bd)
 	fdtdec_add_reserved_memory(blob, "framebuffer", &mem, NULL, 0, NULL, 0);
 #endif
 
-	ft_board_cpu_fixup(blob, bd);
-	ft_board_info_fixup(blob, bd);
-	ft_board_mac_addr_fixup(blob, bd);
+	/*
+	 * These only set properties, so write them all in one go. As before,
+	 * a property which cannot be set does not stop the others.
+	 */
+	ret = fdt_edit_open(&edit, blob, 0);
+	if (ret) {
+		pr_err("Failed to fix up board info: %s\n", fdt_strerror(ret));
+		return 0;
+	}
+	ft_board_cpu_fixup(&edit, bd);
+	ft_board_info_fixup(&edit, bd);
+	ft_board_mac_addr_fixup(&edit, bd);
+	ret = fdt_edit_close(&edit);
+	if (ret)
+		pr_err("Failed to fix up board info: %s\n", fdt_strerror(ret));
+
 	return 0;
 }
 
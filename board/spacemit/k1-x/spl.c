@@ -25,6 +25,10 @@
 #include <cpu_func.h>
 #include <dt-bindings/soc/spacemit-k1x.h>
 #include <display_options.h>
+#include <fdt_support.h>
+#include <fdtdec.h>
+#include <image.h>
+#include <stdio.h>
 #include <asm/io.h>
 #include <configs/k1-x.h>
 #include "../../drivers/gpio/k1x_gpio.h"
@@ -505,6 +509,10 @@ static void spl_load_env(void)
 		return;
 	}
 
+	/*
+	 * With CONFIG_SPL_ENV_VIEW this only keeps the loaded data, and
+	 * env_get() reads it in place; no hash table is built in SPL.
+	 */
 	ret = drv->load();
 	if (!ret){
 		pr_info("has init env successful\n");
@@ -561,8 +569,99 @@ void spl_load_error_handler(int bootdev, const char *loader_name)
 	printf("SPL load error: bootdev=%d, loader=%s\n", bootdev, loader_name);
 }
 
+#if CONFIG_IS_ENABLED(OS_BOOT)
+/*
+ * Falcon mode: boot Linux unless a key is held on the console, or U-Boot
+ * proper was asked for, by the USB download boot mode or by the
+ * reboot-to-shell/fastboot flag
+ */
+int spl_start_uboot(void)
+{
+	static int start_uboot = -1;
+	u32 flag;
+
+	/* the loaders may ask more than once, the key is only read once */
+	if (start_uboot >= 0)
+		return start_uboot;
+
+	start_uboot = 1;
+	if (get_boot_mode() == BOOT_MODE_USB)
+		return start_uboot;
+
+	/* leave the flag set, get_reboot_config() clears it in U-Boot */
+	flag = readl((void *)BOOT_CIU_DEBUG_REG0);
+	if (flag == BOOT_MODE_SHELL || flag == BOOT_MODE_USB)
+		return start_uboot;
+
+	if (tstc()) {
+		getchar();
+		puts("Key pressed, starting U-Boot\n");
+		return start_uboot;
+	}
+
+	start_uboot = 0;
+	return start_uboot;
+}
+
+/*
+ * The exported device tree only has the right initrd range if bootm did
+ * not move the ramdisk, so point /chosen at where SPL loaded it
+ */
+static void falcon_fixup_initrd(void *blob)
+{
+	int images, node;
+	const char *type;
+	u64 start;
+	u32 size;
+
+	images = fdt_path_offset(blob, "/fit-images");
+	if (images < 0)
+		return;
+
+	fdt_for_each_subnode(node, blob, images) {
+		type = fdt_getprop(blob, node, FIT_TYPE_PROP, NULL);
+		if (!type || genimg_get_type_id(type) != IH_TYPE_RAMDISK)
+			continue;
+
+		start = fdtdec_get_uint64(blob, node, "load", 0);
+		size = fdtdec_get_uint(blob, node, "size", 0);
+		if (fdt_initrd(blob, start, start + size))
+			pr_err("failed to set the initrd range in /chosen\n");
+		return;
+	}
+}
+#endif
+
+#if CONFIG_IS_ENABLED(SPACEMIT_K1X_EFUSE) && CONFIG_IS_ENABLED(BLOBLIST)
+/*
+ * If SPL has read the efuse banks, make sure that the driver hands its shadow
+ * copy over to U-Boot proper in the bloblist. The bloblist may not have been
+ * set up at the time of the read. The device is only probed by a read, so
+ * skip the slow read of the banks if it is not active.
+ */
+static void efuse_handoff(void)
+{
+	struct udevice *dev;
+	struct uclass *uc;
+	uint8_t fuse;
+
+	uclass_id_foreach_dev(UCLASS_MISC, dev, uc) {
+		if (dev->driver == DM_DRIVER_GET(spacemit_k1x_efuse) &&
+		    device_active(dev))
+			misc_read(dev, 0, &fuse, sizeof(fuse));
+	}
+}
+#endif
+
 void spl_perform_fixups(struct spl_image_info *spl_image)
 {
 	dram_init_banksize();
+#if CONFIG_IS_ENABLED(OS_BOOT)
+	if (spl_image->fdt_addr)
+		falcon_fixup_initrd(spl_image->fdt_addr);
+#endif
 	spl_fixup_fdt(spl_image->fdt_addr);
+#if CONFIG_IS_ENABLED(SPACEMIT_K1X_EFUSE) && CONFIG_IS_ENABLED(BLOBLIST)
+	efuse_handoff();
+#endif
 }
@@ -232,11 +232,13 @@ int do_avb_verify_part(struct cmd_tbl *cmdtp, int flag,
 		       int argc, char *const argv[])
 {
 	const char * const requested_partitions[] = {"boot", NULL};
+	AvbSlotVerifyFlags flags = AVB_SLOT_VERIFY_FLAGS_STREAM_HASH;
 	AvbSlotVerifyResult slot_result;
 	AvbSlotVerifyData *out_data;
 	char *cmdline;
 	char *extra_args;
 	char *slot_suffix = "";
+	char boot_part[PART_NAME_LEN];
 
 	bool unlocked = false;
 	int res = CMD_RET_FAILURE;
@@ -246,12 +248,21 @@ int do_avb_verify_part(struct cmd_tbl *cmdtp, int flag,
 		return CMD_RET_FAILURE;
 	}
 
-	if (argc < 1 || argc > 2)
+	if (argc < 1 || argc > 3)
 		return CMD_RET_USAGE;
 
-	if (argc == 2)
+	if (argc >= 2)
 		slot_suffix = argv[1];
 
+	/* read the boot partition to its load address, verify it there */
+	if (argc == 3) {
+		snprintf(boot_part, sizeof(boot_part), "boot%s", slot_suffix);
+		avb_set_load_addr(avb_ops, boot_part,
+				  hextoul(argv[2], NULL));
+	} else {
+		avb_set_load_addr(avb_ops, NULL, 0);
+	}
+
 	printf("## Android Verified Boot 2.0 version %s\n",
 	       avb_version_string());
 
@@ -260,12 +271,14 @@ int do_avb_verify_part(struct cmd_tbl *cmdtp, int flag,
 		printf("Can't determine device lock state.\n");
 		return CMD_RET_FAILURE;
 	}
+	if (unlocked)
+		flags |= AVB_SLOT_VERIFY_FLAGS_ALLOW_VERIFICATION_ERROR;
 
 	slot_result =
 		avb_slot_verify(avb_ops,
 				requested_partitions,
 				slot_suffix,
-				unlocked,
+				flags,
 				AVB_HASHTREE_ERROR_MODE_RESTART_AND_INVALIDATE,
 				&out_data);
 
@@ -427,7 +440,7 @@ static struct cmd_tbl cmd_avb[] = {
 	U_BOOT_CMD_MKENT(read_part, 5, 0, do_avb_read_part, "", ""),
 	U_BOOT_CMD_MKENT(read_part_hex, 4, 0, do_avb_read_part_hex, "", ""),
 	U_BOOT_CMD_MKENT(write_part, 5, 0, do_avb_write_part, "", ""),
-	U_BOOT_CMD_MKENT(verify, 2, 0, do_avb_verify_part, "", ""),
+	U_BOOT_CMD_MKENT(verify, 3, 0, do_avb_verify_part, "", ""),
 #ifdef CONFIG_OPTEE_TA_AVB
 	U_BOOT_CMD_MKENT(read_pvalue, 3, 0, do_avb_read_pvalue, "", ""),
 	U_BOOT_CMD_MKENT(write_pvalue, 3, 0, do_avb_write_pvalue, "", ""),
@@ -470,7 +483,8 @@ U_BOOT_CMD(
 	"avb read_pvalue <name> <bytes> - read a persistent value <name>\n"
 	"avb write_pvalue <name> <value> - write a persistent value <name>\n"
 #endif
-	"avb verify [slot_suffix] - run verification process using hash data\n"
-	"    from vbmeta structure\n"
+	"avb verify [slot_suffix [addr]] - run verification process using hash\n"
+	"    data from vbmeta structure\n"
 	"    [slot_suffix] - _a, _b, etc (if vbmeta partition is slotted)\n"
+	"    [addr] - load the boot partition to <addr> and verify it there\n"
 	);
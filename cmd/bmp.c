@@ -244,6 +244,20 @@ int bmp_display(ulong addr, int x, int y)
 	void *bmp_alloc_addr = NULL;
 	unsigned long len;
 
+#ifdef CONFIG_VIDEO_IMG
+	/* Pre-converted images are decompressed straight to the display */
+	if (video_img_valid(addr)) {
+		ret = uclass_first_device_err(UCLASS_VIDEO, &dev);
+		if (!ret)
+			ret = video_img_display(dev, addr, x, y,
+					CONFIG_IS_ENABLED(SPLASH_SCREEN_ALIGN) ||
+					x == BMP_ALIGN_CENTER ||
+					y == BMP_ALIGN_CENTER);
+
+		return ret ? CMD_RET_FAILURE : 0;
+	}
+#endif
+
 	if (!((bmp->header.signature[0]=='B') &&
 	      (bmp->header.signature[1]=='M')))
 		bmp = gunzip_bmp(addr, &len, &bmp_alloc_addr);
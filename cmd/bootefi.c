@@ -11,6 +11,7 @@
 #include <bootm.h>
 #include <charset.h>
 #include <command.h>
+#include <console.h>
 #include <dm.h>
 #include <efi_loader.h>
 #include <efi_selftest.h>
@@ -379,6 +380,7 @@ static efi_status_t do_bootefi_exec(efi_handle_t handle, void *load_options)
 	}
 
 	/* Call our payload! */
+	console_defer_flush();
 	ret = EFI_CALL(efi_start_image(handle, &exit_data_size, &exit_data));
 	if (ret != EFI_SUCCESS) {
 		log_err("## Application failed, r = %lu\n",
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * The 'delaystat' command shows where U-Boot spends its time busy-waiting.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <delay_stats.h>
+
+static int do_delaystat_show(struct cmd_tbl *cmdtp, int flag, int argc,
+			     char *const argv[])
+{
+	ulong min_us = 0;
+
+	if (argc > 1)
+		min_us = dectoul(argv[1], NULL);
+	delay_stats_show(min_us);
+
+	return 0;
+}
+
+static int do_delaystat_reset(struct cmd_tbl *cmdtp, int flag, int argc,
+			      char *const argv[])
+{
+	delay_stats_reset();
+
+	return 0;
+}
+
+static int do_delaystat_bootstage(struct cmd_tbl *cmdtp, int flag, int argc,
+				  char *const argv[])
+{
+	ulong min_us = 1000;
+	int ret;
+
+	if (argc > 1)
+		min_us = dectoul(argv[1], NULL);
+	ret = delay_stats_bootstage(min_us);
+	if (ret < 0) {
+		printf("Failed to add records (err=%d)\n", ret);
+		return CMD_RET_FAILURE;
+	}
+	printf("%d bootstage records\n", ret);
+
+	return 0;
+}
+
+static char delaystat_help_text[] =
+	"show [<min_us>]      - show sites which waited at least <min_us>\n"
+	"delaystat reset                - clear the statistics\n"
+	"delaystat bootstage [<min_us>] - add sites which waited at least\n"
+	"                                 <min_us> (default 1000) to bootstage";
+
+U_BOOT_CMD_WITH_SUBCMDS(delaystat, "Busy-wait statistics", delaystat_help_text,
+	U_BOOT_SUBCMD_MKENT(show, 2, 1, do_delaystat_show),
+	U_BOOT_SUBCMD_MKENT(reset, 1, 1, do_delaystat_reset),
+	U_BOOT_SUBCMD_MKENT(bootstage, 2, 1, do_delaystat_bootstage));
@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * The 'dmesg' command shows the console output recorded by CONSOLE_DEFER.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <console.h>
+
+static int do_dmesg(struct cmd_tbl *cmdtp, int flag, int argc,
+		    char *const argv[])
+{
+	bool clear = false;
+
+	if (argc > 1) {
+		if (strcmp(argv[1], "-c"))
+			return CMD_RET_USAGE;
+		clear = true;
+	}
+	console_log_show();
+	if (clear)
+		console_log_clear();
+
+	return 0;
+}
+
+U_BOOT_CMD(dmesg, 2, 1, do_dmesg,
+	   "Show the console output",
+	   "[-c]\n"
+	   "  -c - clear the output after showing it");
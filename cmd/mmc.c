@@ -389,7 +389,7 @@ static lbaint_t mmc_sparse_reserve(struct sparse_storage *info,
 static int do_mmc_sparse_write(struct cmd_tbl *cmdtp, int flag,
 			       int argc, char *const argv[])
 {
-	struct sparse_storage sparse;
+	struct sparse_storage sparse = { .erase = NULL };
 	struct blk_desc *dev_desc;
 	struct mmc *mmc;
 	char dest[11];
@@ -1044,6 +1044,38 @@ static int do_mmc_bkops_enable(struct cmd_tbl *cmdtp, int flag,
 }
 #endif
 
+#ifdef CONFIG_MMC_WRITE_CACHE
+static int do_mmc_cache(struct cmd_tbl *cmdtp, int flag,
+			int argc, char *const argv[])
+{
+	struct mmc *mmc;
+	int ret;
+
+	if (argc != 3)
+		return CMD_RET_USAGE;
+
+	mmc = init_mmc_device(dectoul(argv[1], NULL), false);
+	if (!mmc)
+		return CMD_RET_FAILURE;
+
+	if (!strcmp(argv[2], "on"))
+		ret = mmc_set_cache(mmc, true);
+	else if (!strcmp(argv[2], "off"))
+		ret = mmc_set_cache(mmc, false);
+	else if (!strcmp(argv[2], "flush"))
+		ret = mmc_flush_cache(mmc);
+	else
+		return CMD_RET_USAGE;
+
+	if (ret == -EOPNOTSUPP)
+		puts("Device has no write cache\n");
+	else if (ret)
+		printf("Cache %s failed (%d)\n", argv[2], ret);
+
+	return ret ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
+}
+#endif
+
 static int do_mmc_boot_wp(struct cmd_tbl *cmdtp, int flag,
 			  int argc, char * const argv[])
 {
@@ -1103,6 +1135,9 @@ static struct cmd_tbl cmd_mmc[] = {
 #ifdef CONFIG_CMD_BKOPS_ENABLE
 	U_BOOT_CMD_MKENT(bkops-enable, 2, 0, do_mmc_bkops_enable, "", ""),
 #endif
+#ifdef CONFIG_MMC_WRITE_CACHE
+	U_BOOT_CMD_MKENT(cache, 3, 0, do_mmc_cache, "", ""),
+#endif
 };
 
 static int do_mmcops(struct cmd_tbl *cmdtp, int flag, int argc,
@@ -1188,6 +1223,10 @@ U_BOOT_CMD(
 #ifdef CONFIG_CMD_BKOPS_ENABLE
 	"mmc bkops-enable <dev> - enable background operations handshake on device\n"
 	"   WARNING: This is a write-once setting.\n"
+#endif
+#ifdef CONFIG_MMC_WRITE_CACHE
+	"mmc cache <dev> on|off|flush - turn the eMMC write cache on or off,\n"
+	"   or write it back to the flash\n"
 #endif
 	);
 
@@ -16,6 +16,7 @@
 #include <net.h>
 #include <net/udp.h>
 #include <net/sntp.h>
+#include <net/wget.h>
 
 static int netboot_common(enum proto_t, struct cmd_tbl *, int, char * const []);
 
@@ -124,6 +125,28 @@ U_BOOT_CMD(
 );
 #endif
 
+#if defined(CONFIG_CMD_WGET)
+static int do_wget(struct cmd_tbl *cmdtp, int flag, int argc,
+		   char *const argv[])
+{
+	int ret;
+
+	bootstage_mark_name(BOOTSTAGE_KERNELREAD_START, "wget_start");
+	ret = netboot_common(WGET, cmdtp, argc, argv);
+	bootstage_mark_name(BOOTSTAGE_KERNELREAD_STOP, "wget_done");
+	/* A range set by wget_set_range() only applies to one download */
+	wget_set_range(0, 0);
+
+	return ret;
+}
+
+U_BOOT_CMD(
+	wget,	3,	1,	do_wget,
+	"load file via network using HTTP protocol",
+	"[loadAddress] [[hostIPaddr:]path]"
+);
+#endif
+
 static void netboot_update_env(void)
 {
 	char tmp[22];
@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * The 'ipibench' command measures the latency of smp_call_function().
+ */
+
+#include <common.h>
+#include <command.h>
+#include <time.h>
+#include <asm/barrier.h>
+#include <asm/smp.h>
+#include <linux/math64.h>
+
+/* Round each hart has last run ipibench_ack() for */
+static ulong ipibench_round[CONFIG_NR_CPUS];
+
+static void ipibench_ack(ulong hart, ulong round, ulong arg1)
+{
+	__smp_store_release(&ipibench_round[hart], round);
+}
+
+/* Wait until all harts in @mask have run @round, or time out */
+static int ipibench_wait(ulong mask, ulong round, u64 timeout)
+{
+	int hart;
+
+	while (mask) {
+		for (hart = 0; hart < CONFIG_NR_CPUS; hart++) {
+			if ((mask & (1UL << hart)) &&
+			    __smp_load_acquire(&ipibench_round[hart]) == round)
+				mask &= ~(1UL << hart);
+		}
+		if (mask && get_ticks() > timeout) {
+			printf("Harts %lx did not respond\n", mask);
+			return -ETIMEDOUT;
+		}
+	}
+
+	return 0;
+}
+
+static u64 ipibench_ns(u64 ticks)
+{
+	return div_u64(ticks * 1000000000ULL, get_tbclk());
+}
+
+static void ipibench_show(const char *name, u64 min, u64 total, u64 max,
+			  ulong rounds)
+{
+	printf("%-10s min %6llu  avg %6llu  max %6llu ns\n", name,
+	       ipibench_ns(min), ipibench_ns(div_u64(total, rounds)),
+	       ipibench_ns(max));
+}
+
+static int do_ipibench(struct cmd_tbl *cmdtp, int flag, int argc,
+		       char *const argv[])
+{
+	u64 send_min = ~0ULL, send_max = 0, send_total = 0;
+	u64 done_min = ~0ULL, done_max = 0, done_total = 0;
+	ulong rounds = 1000;
+	ulong round, mask;
+	int ret;
+
+	if (argc > 1)
+		rounds = simple_strtoul(argv[1], NULL, 0);
+	if (!rounds)
+		return CMD_RET_USAGE;
+
+	ret = smp_get_ipi_harts(&mask);
+	if (ret || !mask) {
+		printf("No other harts to signal\n");
+		return CMD_RET_FAILURE;
+	}
+
+	for (round = 1; round <= rounds; round++) {
+		u64 start, sent, done;
+
+		start = get_ticks();
+		ret = smp_call_function((ulong)ipibench_ack, round, 0, 1);
+		sent = get_ticks();
+		if (ret) {
+			printf("smp_call_function() failed (err=%d)\n", ret);
+			return CMD_RET_FAILURE;
+		}
+		if (ipibench_wait(mask, round, sent + get_tbclk()))
+			return CMD_RET_FAILURE;
+		done = get_ticks();
+
+		send_min = min(send_min, sent - start);
+		send_max = max(send_max, sent - start);
+		send_total += sent - start;
+		done_min = min(done_min, done - start);
+		done_max = max(done_max, done - start);
+		done_total += done - start;
+	}
+
+	printf("%lu calls to harts %lx:\n", rounds, mask);
+	ipibench_show("sent", send_min, send_total, send_max, rounds);
+	ipibench_show("completed", done_min, done_total, done_max, rounds);
+
+	return CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	ipibench, 2, 0, do_ipibench,
+	"measure the latency of calling a function on all other harts",
+	"[rounds]\n"
+	"  - call a function on all other harts <rounds> times (default 1000)\n"
+	"    and show the time to send the IPIs and for all harts to run it"
+);
@@ -29,6 +29,7 @@
 #include <fb_mtd.h>
 #include <nvme.h>
 #include <watchdog.h>
+#include <net/wget.h>
 
 static int dev_emmc_num = -1;
 static int dev_sdio_num = -1;
@@ -119,25 +120,42 @@ int check_mmc_exist_and_initialize(void)
 
 #define TFTP_RETRY_COUNT 3
 
-int download_file_via_tftp(char *file_name, char *load_addr) {
+/* net_flash_protocol=http downloads with wget instead of tftp */
+static bool net_flash_use_http(void)
+{
+	char *net_flash_protocol = env_get("net_flash_protocol");
+
+	return IS_ENABLED(CONFIG_CMD_WGET) && net_flash_protocol &&
+		!strcmp(net_flash_protocol, "http");
+}
+
+/*
+ * Download a file, or with HTTP only part of it if size is not 0. Over HTTP
+ * the size of the whole file is returned in *total_size.
+ */
+static int download_file_via_net(char *file_name, char *load_addr, u64 offset,
+				 u64 size, u64 *total_size)
+{
 	char full_path[128];
 	char cmd_buffer[256];
 	char *tftp_server_ip;
 	char *tftp_path_prefix;
 	char *net_flash_protocol;
 	char *eth_mac;
+	bool http = net_flash_use_http();
+	const char *proto_name = http ? "HTTP" : "TFTP";
 	int retry_count = 0;
 	int cmd_ret;
 
 	tftp_server_ip = env_get("serverip");
 	if (!tftp_server_ip) {
-		printf("Error: TFTP server IP not set\n");
+		printf("Error: %s server IP not set\n", proto_name);
 		return -1;
 	}
 
 	tftp_path_prefix = env_get("net_data_path");
 	if (!tftp_path_prefix) {
-		printf("Error: TFTP relative path not set\n");
+		printf("Error: %s relative path not set\n", proto_name);
 		return -1;
 	}
 	// Check if net flash mode is enabled
@@ -154,31 +172,43 @@ int download_file_via_tftp(char *file_name, char *load_addr) {
 		}
 	}
 
-	sprintf(cmd_buffer, "tftpboot %s %s:%s", load_addr, tftp_server_ip, full_path);
+	sprintf(cmd_buffer, "%s %s %s:%s", http ? "wget" : "tftpboot",
+		load_addr, tftp_server_ip, full_path);
 
 	while (retry_count < TFTP_RETRY_COUNT) {
+		if (http)
+			wget_set_range(offset, size);
 		cmd_ret = run_command(cmd_buffer, 0);
 		if (cmd_ret == 0) {
+			if (http && total_size)
+				*total_size = wget_get_total_size();
 			return RESULT_OK;
 		}
 
 		const char *tftp_err = env_get("tftp_err");
-		if (tftp_err && strcmp(tftp_err, "file_not_found") == 0) {
+		if ((http && wget_get_status() == 404) ||
+		    (!http && tftp_err && strcmp(tftp_err, "file_not_found") == 0)) {
 			printf("No more files to download, finishing...\n");
 			return CMD_RET_FAILURE;
 		}
 
 		retry_count++;
 		if (retry_count < TFTP_RETRY_COUNT) {
-			printf("TFTP download failed, retrying (%d/%d)...\n", 
-					retry_count, TFTP_RETRY_COUNT);
+			printf("%s download failed, retrying (%d/%d)...\n",
+					proto_name, retry_count, TFTP_RETRY_COUNT);
 		}
 	}
 
-	printf("Error: TFTP download failed after %d attempts\n", TFTP_RETRY_COUNT);
+	printf("Error: %s download failed after %d attempts\n", proto_name,
+	       TFTP_RETRY_COUNT);
 	return RESULT_FAIL;
 }
 
+int download_file_via_tftp(char *file_name, char *load_addr)
+{
+	return download_file_via_net(file_name, load_addr, 0, 0, NULL);
+}
+
 static int _find_partition_file(struct flash_dev *fdev, char *tmp_file, char *temp_fname, u32 temp_fname_size)
 {
 	if (strlen(FLASH_IMG_FOLDER) > 0){
@@ -489,6 +519,14 @@ int mtd_write_raw_image(struct mtd_info *mtd, const char *part_name, void *buffe
 {
 	int ret;
 
+	if (CONFIG_IS_ENABLED(FASTBOOT_MTD_NOR_UPDATE)) {
+		if (_fb_mtd_update(mtd, buffer, download_bytes)) {
+			printf("Failed to write mtd part:%s\n", part_name);
+			return RESULT_FAIL;
+		}
+		return 0;
+	}
+
 	printf("Erasing MTD partition %s\n", part_name);
 	ret = _fb_mtd_erase(mtd, download_bytes);
 	if (ret) {
@@ -564,6 +602,44 @@ void specific_flash_mmc_opt(struct cmd_tbl *cmdtp, struct flash_dev *fdev)
 #endif
 }
 
+/*
+ * Load the block-hash manifest "<file_name>.bhm" that may come with an image,
+ * so that only the chunks that changed are written. Without one the image is
+ * flashed whole.
+ */
+static void load_blockhash_manifest(struct cmd_tbl *cmdtp, struct flash_dev *fdev,
+				    char *file_name, char *partition,
+				    struct fb_blockhash *bh)
+{
+	char bhm_name[128];
+	char load_str[20];
+	char blk_dev_str[16];
+	void *load_addr = (void *)map_sysmem(RECOVERY_LOAD_IMG_ADDR, 0);
+
+	snprintf(bhm_name, sizeof(bhm_name), "%s%s", file_name,
+		 FB_BLOCKHASH_SUFFIX);
+	strcpy(load_str, simple_xtoa((ulong)load_addr));
+	sprintf(blk_dev_str, "%d:%d", fdev->dev_index, bootfs_part_index);
+
+	if (strcmp(fdev->device_name, "net") == 0) {
+		if (download_file_via_tftp(bhm_name, load_str) != RESULT_OK)
+			return;
+	} else {
+		char *const argv_bhm[] = {"fatload", fdev->device_name, blk_dev_str,
+					  load_str, bhm_name};
+
+		if (!file_exists(fdev->device_name, blk_dev_str, bhm_name, FS_TYPE_FAT) ||
+		    do_load(cmdtp, 0, 5, argv_bhm, FS_TYPE_FAT))
+			return;
+	}
+
+	if (fb_blockhash_load(bh, partition, load_addr, env_get_hex("filesize", 0)))
+		printf("ignore invalid block-hash manifest %s\n", bhm_name);
+	else
+		printf("flash %s by block hash, %u chunks of %u bytes\n", file_name,
+		       bh->count, bh->chunk_size);
+}
+
 int load_and_flash_file(struct cmd_tbl *cmdtp, struct flash_dev *fdev, char *file_name, char *partition, uint64_t *partition_offset)
 {
 	char load_str[20];
@@ -580,6 +656,9 @@ int load_and_flash_file(struct cmd_tbl *cmdtp, struct flash_dev *fdev, char *fil
 	uint64_t download_offset, download_bytes, bytes_read;
 	u64 compare_value = 0;
 	int div_times, data_source;
+	struct fb_blockhash bh = {0};
+	bool bh_all = true;
+	int ret = RESULT_OK;
 
 	memset(load_str, 0, sizeof(load_str));
 	memset(offset_str, 0, sizeof(offset_str));
@@ -602,8 +681,9 @@ int load_and_flash_file(struct cmd_tbl *cmdtp, struct flash_dev *fdev, char *fil
 	} else if (strcmp(fdev->device_name, "net") == 0) {
 		// load data from net with tftp
 		data_source = 1;
-		/* Temporarily, the logic for network fragment download has not been added,
-		so set the number of downloads to 1 and directly download the entire file. */
+		/* TFTP downloads the entire file at once. Over HTTP, the file is
+		downloaded in parts like the FAT path; the count is updated once the
+		first part gives the file size. */
 		div_times = 1;
 	} else {
 		printf("NOT support data source %s\n", fdev->device_name);
@@ -629,6 +709,11 @@ int load_and_flash_file(struct cmd_tbl *cmdtp, struct flash_dev *fdev, char *fil
 	compare_value = 0;
 	info.start += *partition_offset;
 
+	/* only an image written from the partition start can be compared by chunk */
+	if (CONFIG_IS_ENABLED(SPACEMIT_FLASH_BLOCKHASH) && fdev->blk_write &&
+	    !*partition_offset)
+		load_blockhash_manifest(cmdtp, fdev, file_name, partition, &bh);
+
 	/* save the partition start cnt */
 	part_start_addr = info.start;
 	for (int j = 0; j < div_times; j++) {
@@ -641,20 +726,43 @@ int load_and_flash_file(struct cmd_tbl *cmdtp, struct flash_dev *fdev, char *fil
 			char *const argv_image[] = {"fatload", fdev->device_name, blk_dev_str,
 										load_str, file_name, addr_str, offset_str};
 			printf("load from %llx, bytes:%llx\n", download_offset, download_bytes);
-			if (do_load(cmdtp, 0, 7, argv_image, FS_TYPE_FAT))
-				return RESULT_FAIL;
+			if (do_load(cmdtp, 0, 7, argv_image, FS_TYPE_FAT)) {
+				ret = RESULT_FAIL;
+				goto out;
+			}
 
 			bytes_read = env_get_hex("filesize", 0);
 			printf("read data size %lld\n", bytes_read);
 			if (bytes_read != download_bytes) {
 				printf("download file size is not equal require\n");
-				return RESULT_FAIL;
+				ret = RESULT_FAIL;
+				goto out;
+			}
+		} else if (net_flash_use_http()) {
+			u64 total_size = 0;
+			ret = download_file_via_net(file_name, load_str, download_offset,
+						    RECOVERY_LOAD_IMG_SIZE, &total_size);
+			if (ret != RESULT_OK) {
+				printf("Failed to download file via HTTP, error code: %d\n", ret);
+				goto out;
+			}
+			download_bytes = env_get_hex("filesize", 0);
+			if (j == 0) {
+				image_size = total_size ? total_size : download_bytes;
+				byte_remain = image_size;
+				div_times = (image_size + RECOVERY_LOAD_IMG_SIZE - 1) / RECOVERY_LOAD_IMG_SIZE;
+				pr_info("\n\ndev_times:%d\n", div_times);
+			}
+			if (download_bytes != min(byte_remain, (uint64_t)RECOVERY_LOAD_IMG_SIZE)) {
+				printf("download file size is not equal require\n");
+				ret = RESULT_FAIL;
+				goto out;
 			}
 		} else {
-			int ret = download_file_via_tftp(file_name, load_str);
+			ret = download_file_via_tftp(file_name, load_str);
 			if (ret != RESULT_OK) {
 				printf("Failed to download file via TFTP, error code: %d\n", ret);
-				return ret;
+				goto out;
 			}
 			image_size = download_bytes = env_get_hex("filesize", 0);
 		}
@@ -664,14 +772,29 @@ int load_and_flash_file(struct cmd_tbl *cmdtp, struct flash_dev *fdev, char *fil
 		info.size = (download_bytes + (info.blksz - 1)) / info.blksz;
 		printf("write storage at block: 0x%lx, size: %lx\n", info.start, info.size);
 
-		if (fdev->blk_write != NULL){
+		if (CONFIG_IS_ENABLED(SPACEMIT_FLASH_BLOCKHASH) && bh.hash &&
+		    bh.image_size != image_size) {
+			printf("block-hash manifest is for another image, ignore it\n");
+			fb_blockhash_free(&bh);
+		}
+		if (fb_blockhash_covers(&bh, download_offset, download_bytes, info.blksz)) {
+			if (fb_blockhash_write_blk(&bh, fdev->dev_desc, info.start,
+						   download_offset, load_addr, download_bytes)) {
+				ret = RESULT_FAIL;
+				goto out;
+			}
+		} else if (fdev->blk_write != NULL){
+			bh_all = false;
 			if (fdev->blk_write(fdev->dev_desc, &info, partition, load_addr, download_bytes)){
-				return RESULT_FAIL;
+				ret = RESULT_FAIL;
+				goto out;
 			}
 		}else{
 			/*write to mtd dev*/
-			if (fdev->mtd_write(mtd, partition, load_addr, download_bytes))
-				return RESULT_FAIL;
+			if (fdev->mtd_write(mtd, partition, load_addr, download_bytes)) {
+				ret = RESULT_FAIL;
+				goto out;
+			}
 		}
 
 		info.start += info.size;
@@ -680,6 +803,12 @@ int load_and_flash_file(struct cmd_tbl *cmdtp, struct flash_dev *fdev, char *fil
 		byte_remain -= download_bytes;
 	}
 
+	/* every chunk written by block hash was read back already */
+	if (CONFIG_IS_ENABLED(SPACEMIT_FLASH_BLOCKHASH) && bh.hash && bh_all) {
+		fb_blockhash_report(&bh);
+		goto out;
+	}
+
 	/* read from device and check crc */
 	debug("check crc, read %lx, imagesize:%lld\n", part_start_addr, image_size);
 #if CONFIG_IS_ENABLED(FASTBOOT_FLASH_MMC) || CONFIG_IS_ENABLED(FASTBOOT_MULTI_FLASH_OPTION_MMC)
@@ -687,16 +816,19 @@ int load_and_flash_file(struct cmd_tbl *cmdtp, struct flash_dev *fdev, char *fil
 	if (fdev->blk_write){
 		if (compare_blk_image_val(fdev->dev_desc, compare_value, part_start_addr, info.blksz, image_size)) {
 			printf("check image crc32 fail, \n");
-			return RESULT_FAIL;
+			ret = RESULT_FAIL;
 		}
 	}else{
 		if (compare_mtd_image_val(mtd, compare_value, image_size)) {
 			printf("check image crc32 fail, \n");
-			return RESULT_FAIL;
+			ret = RESULT_FAIL;
 		}
 	}
 #endif
-	return RESULT_OK;
+out:
+	if (CONFIG_IS_ENABLED(SPACEMIT_FLASH_BLOCKHASH) && bh.hash)
+		fb_blockhash_free(&bh);
+	return ret;
 }
 
 int flash_volume_from_file(struct cmd_tbl *cmdtp, struct flash_dev *fdev, const char *volume_name, const char *file_name, const char *partition, uint64_t *partition_offset) {
@@ -912,6 +1044,8 @@ static int perform_flash_operations(struct cmd_tbl *cmdtp, struct flash_dev *fde
 {
 	char *blk_dev;
 	int blk_index;
+	struct mmc *mmc __maybe_unused;
+	int ret __maybe_unused;
 
 	u32 boot_mode = get_boot_pin_select();
 	switch(boot_mode){
@@ -945,7 +1079,20 @@ static int perform_flash_operations(struct cmd_tbl *cmdtp, struct flash_dev *fde
 			return -1;
 		}
 
-		if (flash_image(cmdtp, fdev)) {
+		/* keep the eMMC write cache on for the whole session */
+		mmc = NULL;
+		if (IS_ENABLED(CONFIG_MMC_WRITE_CACHE)) {
+			mmc = find_mmc_device(CONFIG_FASTBOOT_FLASH_MMC_DEV);
+			if (mmc && mmc_set_cache(mmc, true))
+				mmc = NULL;
+		}
+
+		ret = flash_image(cmdtp, fdev);
+		if (mmc && mmc_set_cache(mmc, false)) {
+			printf("flush emmc write cache fail\n");
+			ret = RESULT_FAIL;
+		}
+		if (ret) {
 			return RESULT_FAIL;
 		}
 		/*if flash to emmc，it should write bootinfo to boot0/boot1*/
@@ -483,6 +483,31 @@ static int ubi_set_skip_check(char *volume, bool skip_check)
 	return ubi_change_vtbl_record(ubi, vol->vol_id, &vtbl_rec);
 }
 
+#ifdef CONFIG_MTD_UBI_FASTMAP
+static int ubi_fastmap(void)
+{
+	int err;
+
+	if ((int)mtd_div_by_eb(ubi->mtd->size, ubi->mtd) <= UBI_FM_MAX_START) {
+		printf("Partition %s is too small for a fastmap\n",
+		       ubi->mtd->name);
+		return 1;
+	}
+
+	/* also on images attached by scanning, which have none yet */
+	ubi->fm_disabled = 0;
+	err = ubi_update_fastmap(ubi);
+	if (err) {
+		printf("Cannot write fastmap: %d\n", err);
+		return 1;
+	}
+
+	printf("Wrote fastmap of partition %s\n", ubi->mtd->name);
+
+	return 0;
+}
+#endif
+
 static int ubi_detach(void)
 {
 #ifdef CONFIG_CMD_UBIFS
@@ -586,6 +611,11 @@ static int do_ubi(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 		return ubi_info(layout);
 	}
 
+#ifdef CONFIG_MTD_UBI_FASTMAP
+	if (strcmp(argv[1], "fastmap") == 0)
+		return ubi_fastmap();
+#endif
+
 	if (strcmp(argv[1], "check") == 0) {
 		if (argc > 2)
 			return ubi_check(argv[2]);
@@ -727,6 +757,10 @@ U_BOOT_CMD(
 		" - Display volume and ubi layout information\n"
 	"ubi check volumename"
 		" - check if volumename exists\n"
+#ifdef CONFIG_MTD_UBI_FASTMAP
+	"ubi fastmap"
+		" - write a fastmap, for later attaches to skip the scan\n"
+#endif
 	"ubi create[vol] volume [size] [type] [id] [--skipcheck]\n"
 		" - create volume name with size ('-' for maximum"
 		" available size)\n"
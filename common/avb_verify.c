@@ -7,11 +7,17 @@
 #include <avb_verify.h>
 #include <blk.h>
 #include <cpu_func.h>
+#include <hash.h>
 #include <image.h>
+#include <lmb.h>
+#include <log.h>
 #include <malloc.h>
 #include <part.h>
 #include <tee.h>
 #include <tee/optee_ta_avb.h>
+#include <asm/global_data.h>
+
+DECLARE_GLOBAL_DATA_PTR;
 
 static const unsigned char avb_root_pub[1032] = {
 	0x0, 0x0, 0x10, 0x0, 0x55, 0xd9, 0x4, 0xad, 0xd8, 0x4,
@@ -539,6 +545,176 @@ static AvbIOResult read_from_partition(AvbOps *ops,
 			   num_bytes, buffer, out_num_read, IO_READ);
 }
 
+#ifdef CONFIG_LMB
+/* Check that a partition may be read to the given address */
+static bool load_addr_is_free(ulong addr, size_t size)
+{
+	struct lmb lmb;
+
+	lmb_init_and_reserve(&lmb, gd->bd, (void *)gd->fdt_blob);
+
+	return lmb_alloc_addr(&lmb, addr, size) == addr;
+}
+#endif
+
+/**
+ * get_preloaded_partition() - reads a partition to its load address
+ *
+ * A partition to be booted is read straight to its load address, so that it
+ * is hashed there and not copied again after verification. The load address
+ * must not overlap memory reserved by U-Boot or the device tree.
+ *
+ * @ops: contains AVB ops handlers
+ * @partition: partition name, NUL-terminated UTF-8 string
+ * @num_bytes: amount of bytes to read
+ * @out_pointer: returns the load address, or NULL if the partition has none
+ * @out_num_bytes_preloaded: returns the amount of bytes read
+ *
+ * @return:
+ *      AVB_IO_RESULT_OK, if the partition has no load address or was read
+ *      AVB_IO_RESULT_ERROR_INSUFFICIENT_SPACE, if reading the partition
+ *            would overwrite reserved memory
+ *      AVB_IO_RESULT_ERROR_IO, if i/o error occurred from the underlying i/o
+ *            subsystem
+ *      AVB_IO_RESULT_ERROR_NO_SUCH_PARTITION, if there is no partition with
+ *      the given name
+ */
+static AvbIOResult get_preloaded_partition(AvbOps *ops,
+					   const char *partition,
+					   size_t num_bytes,
+					   u8 **out_pointer,
+					   size_t *out_num_bytes_preloaded)
+{
+	struct AvbOpsData *data = ops->user_data;
+	AvbIOResult ret;
+	void *buffer;
+
+	*out_pointer = NULL;
+	if (!data->load_part[0] || strcmp(partition, data->load_part))
+		return AVB_IO_RESULT_OK;
+
+#ifdef CONFIG_LMB
+	if (!load_addr_is_free(data->load_addr, num_bytes)) {
+		log_err("** Reading %s would overwrite reserved memory **\n",
+			partition);
+		return AVB_IO_RESULT_ERROR_INSUFFICIENT_SPACE;
+	}
+#endif
+
+	buffer = map_sysmem(data->load_addr, num_bytes);
+	ret = read_from_partition(ops, partition, 0, num_bytes, buffer,
+				  out_num_bytes_preloaded);
+	if (ret != AVB_IO_RESULT_OK) {
+		unmap_sysmem(buffer);
+		return ret;
+	}
+	*out_pointer = buffer;
+
+	return AVB_IO_RESULT_OK;
+}
+
+#if CONFIG_IS_ENABLED(HASH)
+/**
+ * hash_partition() - hashes data from the beginning of a partition
+ *
+ * The partition is read and hashed a buffer at a time, using the hash
+ * algorithms of U-Boot, and so any hardware acceleration they have.
+ *
+ * @ops: contains AVB ops handlers
+ * @partition: partition name, NUL-terminated UTF-8 string
+ * @hash_algorithm: "sha256" or "sha512"
+ * @salt: data hashed before the partition
+ * @salt_len: length of @salt
+ * @num_bytes: amount of bytes of the partition to hash
+ * @out_digest: destination buffer for the digest
+ * @digest_len: length of the digest
+ *
+ * @return:
+ *      AVB_IO_RESULT_OK, if the partition was hashed
+ *      AVB_IO_RESULT_ERROR_NO_SUCH_VALUE, if the algorithm is not supported
+ *      AVB_IO_RESULT_ERROR_RANGE_OUTSIDE_PARTITION, if @num_bytes is larger
+ *            than the partition
+ *      AVB_IO_RESULT_ERROR_INSUFFICIENT_SPACE, if the AVB buffer is smaller
+ *            than a block
+ *      AVB_IO_RESULT_ERROR_IO, if i/o error occurred from the underlying i/o
+ *            subsystem
+ *      AVB_IO_RESULT_ERROR_NO_SUCH_PARTITION, if there is no partition with
+ *      the given name
+ */
+static AvbIOResult hash_partition(AvbOps *ops,
+				  const char *partition,
+				  const char *hash_algorithm,
+				  const u8 *salt,
+				  size_t salt_len,
+				  u64 num_bytes,
+				  u8 *out_digest,
+				  size_t digest_len)
+{
+	struct hash_algo *algo;
+	struct mmc_part *part;
+	AvbIOResult ret = AVB_IO_RESULT_OK;
+	lbaint_t start, blks, max_blks;
+	size_t len;
+	void *buf, *ctx;
+
+	if (hash_progressive_lookup_algo(hash_algorithm, &algo) ||
+	    (size_t)algo->digest_size != digest_len)
+		return AVB_IO_RESULT_ERROR_NO_SUCH_VALUE;
+
+	part = get_partition(ops, partition);
+	if (!part)
+		return AVB_IO_RESULT_ERROR_NO_SUCH_PARTITION;
+
+	if (num_bytes > (u64)part->info.size * part->info.blksz) {
+		ret = AVB_IO_RESULT_ERROR_RANGE_OUTSIDE_PARTITION;
+		goto out;
+	}
+
+	buf = get_sector_buf();
+	max_blks = get_sector_buf_size() / part->info.blksz;
+	if (!max_blks) {
+		ret = AVB_IO_RESULT_ERROR_INSUFFICIENT_SPACE;
+		goto out;
+	}
+
+	if (algo->hash_init(algo, &ctx)) {
+		ret = AVB_IO_RESULT_ERROR_OOM;
+		goto out;
+	}
+	if (algo->hash_update(algo, ctx, salt, salt_len, !num_bytes)) {
+		ret = AVB_IO_RESULT_ERROR_IO;
+		goto err_ctx;
+	}
+
+	for (start = part->info.start; num_bytes; start += blks) {
+		len = min_t(u64, num_bytes, max_blks * part->info.blksz);
+		blks = DIV_ROUND_UP(len, part->info.blksz);
+		num_bytes -= len;
+
+		if (mmc_read_and_flush(part, start, blks, buf) != blks) {
+			printf("%s: read error (" LBAF ")\n", __func__, start);
+			ret = AVB_IO_RESULT_ERROR_IO;
+			goto err_ctx;
+		}
+		if (algo->hash_update(algo, ctx, buf, len, !num_bytes)) {
+			ret = AVB_IO_RESULT_ERROR_IO;
+			goto err_ctx;
+		}
+	}
+
+	if (algo->hash_finish(algo, ctx, out_digest, digest_len))
+		ret = AVB_IO_RESULT_ERROR_IO;
+	goto out;
+
+err_ctx:
+	/* hash_finish() also frees the context */
+	algo->hash_finish(algo, ctx, out_digest, digest_len);
+out:
+	free(part);
+	return ret;
+}
+#endif
+
 /**
  * write_to_partition() - writes N bytes to a partition identified by a string
  * name
@@ -987,6 +1163,10 @@ AvbOps *avb_ops_alloc(int boot_device)
 	ops_data->ops.user_data = ops_data;
 
 	ops_data->ops.read_from_partition = read_from_partition;
+	ops_data->ops.get_preloaded_partition = get_preloaded_partition;
+#if CONFIG_IS_ENABLED(HASH)
+	ops_data->ops.hash_partition = hash_partition;
+#endif
 	ops_data->ops.write_to_partition = write_to_partition;
 	ops_data->ops.validate_vbmeta_public_key = validate_vbmeta_public_key;
 	ops_data->ops.read_rollback_index = read_rollback_index;
@@ -1004,6 +1184,26 @@ AvbOps *avb_ops_alloc(int boot_device)
 	return &ops_data->ops;
 }
 
+/**
+ * avb_set_load_addr() - set where a partition is to be loaded
+ *
+ * The partition is then read to @addr and hashed there when verified, and
+ * left there for booting. Only one partition has a load address at a time.
+ *
+ * @ops: AvbOps, contains AVB ops handlers
+ * @partition: partition name, with its slot suffix if any, or NULL to load
+ *             no partition
+ * @addr: load address
+ */
+void avb_set_load_addr(AvbOps *ops, const char *partition, ulong addr)
+{
+	struct AvbOpsData *data = ops->user_data;
+
+	strlcpy(data->load_part, partition ? partition : "",
+		sizeof(data->load_part));
+	data->load_addr = addr;
+}
+
 void avb_ops_free(AvbOps *ops)
 {
 	struct AvbOpsData *ops_data;
@@ -54,6 +54,7 @@ static struct tag_name {
 	{ BLOBLISTT_U_BOOT_SPL_HANDOFF, "SPL hand-off" },
 
 	/* BLOBLISTT_VENDOR_AREA */
+	{ BLOBLISTT_SPACEMIT_EFUSE, "SpacemiT K1 efuse" },
 };
 
 const char *bloblist_tag_name(enum bloblist_tag_t tag)
@@ -760,6 +760,7 @@ static init_fnc_t init_sequence_r[] = {
 	api_init,
 #endif
 	console_init_r,		/* fully init console as a device */
+	console_defer_init,
 #ifdef CONFIG_DISPLAY_BOARDINFO_LATE
 	console_announce_r,
 	show_board_info,
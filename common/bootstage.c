@@ -218,6 +218,30 @@ uint32_t bootstage_accum(enum bootstage_id id)
 	return duration;
 }
 
+enum bootstage_id bootstage_set_accum(enum bootstage_id id, const char *name,
+				      uint32_t time_us)
+{
+	struct bootstage_data *data = gd->bootstage;
+	struct bootstage_record *rec;
+
+	if (!data)
+		return 0;
+	if (id == BOOTSTAGE_ID_ALLOC)
+		id = data->next_id++;
+	rec = ensure_id(data, id);
+	if (!rec)
+		return 0;
+
+	/* a non-zero start time marks this as an accumulator */
+	if (!rec->start_us)
+		rec->start_us = timer_get_boot_us() ? : 1;
+	if (name)
+		rec->name = name;
+	rec->time_us = time_us;
+
+	return id;
+}
+
 /**
  * Get a record name as a printable string
  *
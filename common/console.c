@@ -365,6 +365,19 @@ static void console_puts(int file, const char *s)
 	}
 }
 
+static bool __maybe_unused console_has_serial(int file)
+{
+	int i;
+	struct stdio_dev *dev;
+
+	for_each_console_dev(i, file, dev) {
+		if (console_dev_is_serial(dev))
+			return true;
+	}
+
+	return false;
+}
+
 #if CONFIG_IS_ENABLED(SYS_CONSOLE_IS_IN_ENV)
 static inline void console_doenv(int file, struct stdio_dev *dev)
 {
@@ -414,6 +427,11 @@ static inline void console_puts(int file, const char *s)
 	stdio_devices[file]->puts(stdio_devices[file], s);
 }
 
+static inline bool console_has_serial(int file)
+{
+	return console_dev_is_serial(stdio_devices[file]);
+}
+
 #if CONFIG_IS_ENABLED(SYS_CONSOLE_IS_IN_ENV)
 static inline void console_doenv(int file, struct stdio_dev *dev)
 {
@@ -482,6 +500,7 @@ int fgetc(int file)
 		 */
 		for (;;) {
 			WATCHDOG_RESET();
+			console_defer_poll();
 			if (CONFIG_IS_ENABLED(CONSOLE_MUX)) {
 				/*
 				 * Upper layer may have already called tstc() so
@@ -517,14 +536,19 @@ int ftstc(int file)
 
 void fputc(int file, const char c)
 {
-	if (file < MAX_FILES)
+	if (file < MAX_FILES) {
+		/* keep things in order with the output in the ring */
+		console_defer_flush();
 		console_putc(file, c);
+	}
 }
 
 void fputs(int file, const char *s)
 {
-	if (file < MAX_FILES)
+	if (file < MAX_FILES) {
+		console_defer_flush();
 		console_puts(file, s);
+	}
 }
 
 int fprintf(int file, const char *fmt, ...)
@@ -582,6 +606,8 @@ int tstc(void)
 	if (console_record_tstc())
 		return 1;
 
+	console_defer_poll();
+
 	if (gd->flags & GD_FLG_DEVINIT) {
 		/* Test the standard input */
 		return ftstc(stdin);
@@ -656,6 +682,181 @@ static inline void pre_console_puts(const char *s) {}
 static inline void print_pre_console_buffer(int flushpoint) {}
 #endif
 
+#if CONFIG_IS_ENABLED(CONSOLE_DEFER)
+/*
+ * Output for the serial console is written to a ring buffer in RAM and sent
+ * to the UART whenever its transmit FIFO has room, rather than waiting for
+ * each character to go out. The ring also holds a history of the output,
+ * which 'dmesg' can show again.
+ *
+ * Positions are free-running byte counts: the data from @sent to @head is
+ * still to be sent and the data from @start to @head is the history.
+ */
+struct console_defer {
+	char *buf;
+	ulong size;
+	ulong head;
+	ulong sent;
+	ulong start;
+	bool cr_sent;
+	bool enabled;
+	bool busy;
+};
+
+static struct console_defer con_defer;
+
+static bool console_defer_active(void)
+{
+	/* BSS is not available before relocation */
+	if (!(gd->flags & GD_FLG_RELOC))
+		return false;
+
+	return con_defer.enabled;
+}
+
+/* Send pending output until done or, if !@wait, until the UART is full */
+static void console_defer_send(bool wait)
+{
+	struct console_defer *cd = &con_defer;
+	int ret;
+
+	/* serial drivers may call udelay(), which calls back into here */
+	if (cd->busy)
+		return;
+	cd->busy = true;
+	while (cd->sent != cd->head) {
+		char ch = cd->buf[cd->sent % cd->size];
+
+		if (ch == '\n' && !cd->cr_sent) {
+			ret = serial_try_putc('\r');
+			if (!ret)
+				cd->cr_sent = true;
+		} else {
+			ret = serial_try_putc(ch);
+			if (!ret) {
+				cd->cr_sent = false;
+				cd->sent++;
+			}
+		}
+		if (ret == -EAGAIN && !wait)
+			break;
+		else if (ret && ret != -EAGAIN)
+			cd->sent = cd->head;	/* no UART, so drop it */
+	}
+	cd->busy = false;
+}
+
+static void console_defer_putc(const char c)
+{
+	struct console_defer *cd = &con_defer;
+
+	if (cd->head - cd->sent == cd->size) {
+		/* full, so the UART is holding things up anyway */
+		console_defer_send(true);
+		if (cd->head - cd->sent == cd->size)
+			cd->sent++;
+	}
+	cd->buf[cd->head++ % cd->size] = c;
+	if (cd->head - cd->start > cd->size)
+		cd->start = cd->head - cd->size;
+}
+
+/**
+ * console_defer_puts() - Write a string to the ring, if in use
+ *
+ * Non-serial devices get the output straight away, as usual.
+ *
+ * @s: String to write
+ * Return: true if the string was handled, false to write it to stdout as usual
+ */
+static bool console_defer_puts(const char *s)
+{
+	if (!console_defer_active() || !console_has_serial(stdout))
+		return false;
+
+	console_puts_select(stdout, false, s);
+	while (*s)
+		console_defer_putc(*s++);
+	console_defer_send(false);
+
+	return true;
+}
+
+int console_defer_init(void)
+{
+	struct console_defer *cd = &con_defer;
+
+	cd->size = CONFIG_CONSOLE_DEFER_SIZE;
+	cd->buf = malloc(cd->size);
+	if (!cd->buf)
+		return -ENOMEM;
+	cd->enabled = true;
+
+	return 0;
+}
+
+int console_defer_enable(bool enable)
+{
+	struct console_defer *cd = &con_defer;
+
+	if (!cd->buf)
+		return -ENOSYS;
+	if (!enable)
+		console_defer_flush();
+	cd->enabled = enable;
+
+	return 0;
+}
+
+void console_defer_poll(void)
+{
+	if (console_defer_active() && con_defer.sent != con_defer.head)
+		console_defer_send(false);
+}
+
+void console_defer_flush(void)
+{
+	if (console_defer_active())
+		console_defer_send(true);
+}
+
+void console_log_show(void)
+{
+	struct console_defer *cd = &con_defer;
+	ulong pos, end;
+	bool enabled;
+	char out[65];
+
+	if (!cd->buf)
+		return;
+
+	/* write the history straight out, so it is not added to itself */
+	console_defer_flush();
+	enabled = cd->enabled;
+	cd->enabled = false;
+	for (pos = cd->start, end = cd->head; pos != end;) {
+		int len = min(end - pos, (ulong)sizeof(out) - 1);
+		int i;
+
+		for (i = 0; i < len; i++)
+			out[i] = cd->buf[pos++ % cd->size];
+		out[len] = '\0';
+		puts(out);
+	}
+	cd->enabled = enabled;
+}
+
+void console_log_clear(void)
+{
+	con_defer.start = con_defer.head;
+}
+#else
+static inline bool console_defer_puts(const char *s)
+{
+	return false;
+}
+#endif
+
 #ifdef CONFIG_FASTBOOT_CMD_OEM_READ
 void handle_console_log(const char *s) {
 	if (!gd || !gd->console_log.buffer) {
@@ -717,6 +918,10 @@ void putc(const char c)
 		return pre_console_putc(c);
 
 	if (gd->flags & GD_FLG_DEVINIT) {
+		char str[2] = {c, '\0'};
+
+		if (console_defer_puts(str))
+			return;
 		/* Send to the standard output */
 		fputc(stdout, c);
 	} else {
@@ -764,6 +969,8 @@ void puts(const char *s)
 		return pre_console_puts(s);
 
 	if (gd->flags & GD_FLG_DEVINIT) {
+		if (console_defer_puts(s))
+			return;
 		/* Send to the standard output */
 		fputs(stdout, s);
 	} else {
@@ -12,6 +12,7 @@
 #include <fdt_support.h>
 #include <asm/global_data.h>
 #include <linux/libfdt.h>
+#include <mapmem.h>
 #include <video.h>
 
 DECLARE_GLOBAL_DATA_PTR;
@@ -37,6 +38,9 @@ static int fdt_simplefb_configure_node(void *blob, int off)
 	ysize = uc_priv->ysize;
 	bpix = uc_priv->bpix;
 	fb_base = plat->base;
+	/* After hardware scrolling the display shows a later part of memory */
+	if (uc_priv->scroll_base)
+		fb_base = map_to_sysmem(uc_priv->fb);
 #else
 	xsize = lcd_get_pixel_width();
 	ysize = lcd_get_pixel_height();
@@ -10,6 +10,7 @@
 #include <abuf.h>
 #include <env.h>
 #include <log.h>
+#include <malloc.h>
 #include <mapmem.h>
 #include <net.h>
 #include <stdio_dev.h>
@@ -129,33 +130,30 @@ int fdt_find_or_add_subnode(void *fdt, int parentoffset, const char *name)
 }
 
 #if defined(CONFIG_OF_STDOUT_VIA_ALIAS) && defined(CONFIG_CONS_INDEX)
-static int fdt_fixup_stdout(void *fdt, int chosenoff)
+static int fdt_fixup_stdout(struct fdt_edit *edit, int chosenoff)
 {
 	int err;
 	int aliasoff;
 	char sername[9] = { 0 };
 	const void *path;
 	int len;
-	char tmp[256]; /* long enough */
 
 	sprintf(sername, "serial%d", CONFIG_CONS_INDEX - 1);
 
-	aliasoff = fdt_path_offset(fdt, "/aliases");
+	aliasoff = fdt_edit_node(edit, "/aliases");
 	if (aliasoff < 0) {
 		err = aliasoff;
 		goto noalias;
 	}
 
-	path = fdt_getprop(fdt, aliasoff, sername, &len);
+	path = fdt_getprop(edit->fdt, aliasoff, sername, &len);
 	if (!path) {
 		err = len;
 		goto noalias;
 	}
 
-	/* fdt_setprop may break "path" so we copy it to tmp buffer */
-	memcpy(tmp, path, len);
-
-	err = fdt_setprop(fdt, chosenoff, "linux,stdout-path", tmp, len);
+	/* The value is copied, so "path" need not stay valid */
+	err = fdt_edit_setprop(edit, chosenoff, "linux,stdout-path", path, len);
 	if (err < 0){
 		pr_debug("WARNING: could not set linux,stdout-path %s.\n",
 		       fdt_strerror(err));
@@ -170,7 +168,7 @@ noalias:
 	return 0;
 }
 #else
-static int fdt_fixup_stdout(void *fdt, int chosenoff)
+static int fdt_fixup_stdout(struct fdt_edit *edit, int chosenoff)
 {
 	return 0;
 }
@@ -283,6 +281,7 @@ __weak char *board_fdt_chosen_bootargs(void)
 int fdt_chosen(void *fdt)
 {
 	struct abuf buf = {};
+	struct fdt_edit edit;
 	int   nodeoffset;
 	int   err;
 	char  *str;		/* used to set string properties */
@@ -298,40 +297,37 @@ int fdt_chosen(void *fdt)
 	if (nodeoffset < 0)
 		return nodeoffset;
 
+	/* Queue the properties and write them all at once */
+	err = fdt_edit_open(&edit, fdt, 0);
+	if (err < 0)
+		return err;
+
 	if (IS_ENABLED(CONFIG_BOARD_RNG_SEED) && !board_rng_seed(&buf)) {
-		err = fdt_setprop(fdt, nodeoffset, "rng-seed",
-				  abuf_data(&buf), abuf_size(&buf));
+		fdt_edit_setprop(&edit, nodeoffset, "rng-seed",
+				 abuf_data(&buf), abuf_size(&buf));
 		abuf_uninit(&buf);
-		if (err < 0) {
-			pr_debug("WARNING: could not set rng-seed %s.\n",
-			       fdt_strerror(err));
-			return err;
-		}
 	}
 
 	env_set_hex("fdt_addr", (ulong)fdt);
 	str = board_fdt_chosen_bootargs();
 
-	if (str) {
-		err = fdt_setprop(fdt, nodeoffset, "bootargs", str,
-				  strlen(str) + 1);
-		if (err < 0) {
-			pr_debug("WARNING: could not set bootargs %s.\n",
-			       fdt_strerror(err));
-			return err;
-		}
-	}
+	if (str)
+		fdt_edit_setprop_string(&edit, nodeoffset, "bootargs", str);
 
 	/* add u-boot version */
-	err = fdt_setprop(fdt, nodeoffset, "u-boot,version", PLAIN_VERSION,
-			  strlen(PLAIN_VERSION) + 1);
+	fdt_edit_setprop_string(&edit, nodeoffset, "u-boot,version",
+				PLAIN_VERSION);
+
+	fdt_fixup_stdout(&edit, nodeoffset);
+
+	err = fdt_edit_close(&edit);
 	if (err < 0) {
-		pr_debug("WARNING: could not set u-boot,version %s.\n",
-		       fdt_strerror(err));
+		pr_debug("WARNING: could not set chosen properties %s.\n",
+			 fdt_strerror(err));
 		return err;
 	}
 
-	return fdt_fixup_stdout(fdt, nodeoffset);
+	return 0;
 }
 
 void do_fixup_by_path(void *fdt, const char *path, const char *prop,
@@ -824,6 +820,333 @@ int fdt_increase_size(void *fdt, int add_len)
 	return fdt_open_into(fdt, fdt, newlen);
 }
 
+int fdt_edit_open(struct fdt_edit *edit, void *fdt, int add_len)
+{
+	memset(edit, '\0', sizeof(*edit));
+	edit->fdt = fdt;
+
+	/*
+	 * This puts the blocks in the usual order with the free space at the
+	 * end, which fdt_edit_apply() relies on
+	 */
+	return fdt_increase_size(fdt, add_len);
+}
+
+int fdt_edit_node(struct fdt_edit *edit, const char *path)
+{
+	struct fdt_edit_node *node;
+	int i, offset;
+
+	for (i = 0; i < edit->num_nodes; i++) {
+		node = &edit->nodes[i];
+		if (!strcmp(node->path, path))
+			return node->offset;
+	}
+
+	offset = fdt_path_offset(edit->fdt, path);
+	if (offset >= 0 && edit->num_nodes < FDT_EDIT_MAX_NODES) {
+		node = &edit->nodes[edit->num_nodes++];
+		node->path = path;
+		node->offset = offset;
+	}
+
+	return offset;
+}
+
+int fdt_edit_setprop(struct fdt_edit *edit, int node, const char *name,
+		     const void *val, int len)
+{
+	int name_len = strlen(name) + 1;
+	struct fdt_edit_prop *prop;
+	int i;
+
+	if (node < 0) {
+		if (!edit->err)
+			edit->err = node;
+		return node;
+	}
+
+	/* A property set twice keeps its place in the queue */
+	for (i = 0; i < edit->num_props; i++) {
+		if (edit->props[i]->node == node &&
+		    !strcmp(edit->props[i]->name, name))
+			break;
+	}
+	if (i == edit->max_props) {
+		struct fdt_edit_prop **props;
+		int max = edit->max_props ? edit->max_props * 2 : 16;
+
+		props = realloc(edit->props, max * sizeof(*props));
+		if (!props)
+			goto nomem;
+		edit->props = props;
+		edit->max_props = max;
+	}
+
+	prop = malloc(sizeof(*prop) + name_len + len);
+	if (!prop)
+		goto nomem;
+	prop->node = node;
+	prop->name = memcpy(prop + 1, name, name_len);
+	prop->val = memcpy((char *)(prop + 1) + name_len, val, len);
+	prop->len = len;
+
+	if (i < edit->num_props)
+		free(edit->props[i]);
+	else
+		edit->num_props++;
+	edit->props[i] = prop;
+
+	return 0;
+
+nomem:
+	if (!edit->err)
+		edit->err = -FDT_ERR_NOSPACE;
+	return -FDT_ERR_NOSPACE;
+}
+
+static void fdt_edit_drop(struct fdt_edit *edit)
+{
+	int i;
+
+	for (i = 0; i < edit->num_props; i++)
+		free(edit->props[i]);
+	edit->num_props = 0;
+}
+
+/* Size of a property with a value of @len bytes, in the struct block */
+static int fdt_edit_prop_size(int len)
+{
+	return sizeof(struct fdt_property) + ALIGN(len, FDT_TAGSIZE);
+}
+
+/* Find a string in the first @size bytes of the strings block, or return -1 */
+static int fdt_edit_find_string(const void *fdt, int size, const char *name)
+{
+	const char *strings = (const char *)fdt + fdt_off_dt_strings(fdt);
+	const char *p;
+
+	for (p = strings; p < strings + size; p += strlen(p) + 1) {
+		if (!strcmp(p, name))
+			return p - strings;
+	}
+
+	return -1;
+}
+
+/*
+ * Work out where a queued property goes in the struct block and which name
+ * it uses in the strings block, adding to *@strings_size if the name is new.
+ */
+static int fdt_edit_place(struct fdt_edit *edit, int idx, int *strings_size)
+{
+	struct fdt_edit_prop *prop = edit->props[idx];
+	const void *fdt = edit->fdt;
+	const struct fdt_property *old;
+	int i, len;
+
+	old = fdt_get_property(fdt, prop->node, prop->name, &len);
+	if (old) {
+		prop->pos = (const char *)old -
+			((const char *)fdt + fdt_off_dt_struct(fdt));
+		prop->old_size = fdt_edit_prop_size(len);
+		prop->nameoff = fdt32_to_cpu(old->nameoff);
+
+		return 0;
+	}
+	if (len != -FDT_ERR_NOTFOUND)
+		return len;
+
+	/* Like fdt_setprop(), add new properties at the start of the node */
+	if (fdt_next_tag(fdt, prop->node, &prop->pos) != FDT_BEGIN_NODE)
+		return -FDT_ERR_BADOFFSET;
+	prop->old_size = 0;
+
+	prop->nameoff = fdt_edit_find_string(fdt, fdt_size_dt_strings(fdt),
+					     prop->name);
+	for (i = 0; prop->nameoff < 0 && i < idx; i++) {
+		if (!strcmp(edit->props[i]->name, prop->name))
+			prop->nameoff = edit->props[i]->nameoff;
+	}
+	if (prop->nameoff < 0) {
+		prop->nameoff = *strings_size;
+		*strings_size += strlen(prop->name) + 1;
+	}
+
+	return 0;
+}
+
+/*
+ * Sort by position. A new property goes before a replaced one at the same
+ * position, since it is inserted in front of it.
+ */
+static void fdt_edit_sort(struct fdt_edit *edit)
+{
+	struct fdt_edit_prop *prop;
+	int i, j;
+
+	for (i = 1; i < edit->num_props; i++) {
+		prop = edit->props[i];
+		for (j = i; j > 0; j--) {
+			struct fdt_edit_prop *prev = edit->props[j - 1];
+
+			if (prev->pos < prop->pos ||
+			    (prev->pos == prop->pos &&
+			     (!prev->old_size || prop->old_size)))
+				break;
+			edit->props[j] = prev;
+		}
+		edit->props[j] = prop;
+	}
+}
+
+/*
+ * Make the sorted changes one at a time with fdt_setprop(), for when they
+ * cannot be written in one pass. Working from the end of the struct block
+ * back, each change only moves what comes after it, so the node offsets of
+ * the changes still to be made stay valid.
+ */
+static int fdt_edit_apply_each(struct fdt_edit *edit)
+{
+	struct fdt_edit_prop *prop;
+	int i, err, ret = 0;
+
+	for (i = edit->num_props - 1; i >= 0; i--) {
+		prop = edit->props[i];
+		err = fdt_setprop(edit->fdt, prop->node, prop->name, prop->val,
+				  prop->len);
+		if (err && !ret)
+			ret = err;
+	}
+	/* Node offsets are no longer known */
+	edit->num_nodes = 0;
+	fdt_edit_drop(edit);
+
+	return ret;
+}
+
+int fdt_edit_apply(struct fdt_edit *edit)
+{
+	void *fdt = edit->fdt;
+	int struct_size = fdt_size_dt_struct(fdt);
+	int strings_size = fdt_size_dt_strings(fdt);
+	int new_struct = struct_size, new_strings = strings_size;
+	char *base = fdt + fdt_off_dt_struct(fdt);
+	struct fdt_edit_prop *prop;
+	int i, j, pos, err, ret = 0;
+	char *buf, *out;
+
+	if (!edit->num_props)
+		return 0;
+
+	/* Drop any change which cannot be made, but carry on with the rest */
+	for (i = 0, j = 0; i < edit->num_props; i++) {
+		prop = edit->props[i];
+		edit->props[j] = prop;
+		err = fdt_edit_place(edit, j, &new_strings);
+		if (err) {
+			if (!ret)
+				ret = err;
+			free(prop);
+			continue;
+		}
+		new_struct += fdt_edit_prop_size(prop->len) - prop->old_size;
+		j++;
+	}
+	edit->num_props = j;
+	if (!edit->num_props)
+		return ret;
+	fdt_edit_sort(edit);
+
+	/*
+	 * If there is no room for all the changes, fdt_setprop() makes as many
+	 * of them as fit
+	 */
+	buf = NULL;
+	if (!edit->in_place && fdt_off_dt_struct(fdt) + new_struct +
+	    new_strings <= fdt_totalsize(fdt))
+		buf = malloc(new_struct + new_strings);
+	if (!buf) {
+		err = fdt_edit_apply_each(edit);
+
+		return ret ? ret : err;
+	}
+
+	/* Copy the struct block, writing each property as we reach it */
+	out = buf;
+	pos = 0;
+	for (i = 0; i < edit->num_props; i++) {
+		struct fdt_property *hdr;
+		int size;
+
+		prop = edit->props[i];
+		memcpy(out, base + pos, prop->pos - pos);
+		out += prop->pos - pos;
+
+		hdr = (struct fdt_property *)out;
+		hdr->tag = cpu_to_fdt32(FDT_PROP);
+		hdr->len = cpu_to_fdt32(prop->len);
+		hdr->nameoff = cpu_to_fdt32(prop->nameoff);
+		memcpy(hdr->data, prop->val, prop->len);
+		size = fdt_edit_prop_size(prop->len);
+		memset(hdr->data + prop->len, '\0',
+		       size - sizeof(*hdr) - prop->len);
+		out += size;
+		pos = prop->pos + prop->old_size;
+	}
+	memcpy(out, base + pos, struct_size - pos);
+
+	/* Then the strings block, with any new names on the end */
+	out = buf + new_struct;
+	memcpy(out, base + struct_size, strings_size);
+	for (i = 0; i < edit->num_props; i++) {
+		prop = edit->props[i];
+		if (prop->nameoff >= strings_size)
+			strcpy(out + prop->nameoff, prop->name);
+	}
+
+	memcpy(base, buf, new_struct + new_strings);
+	free(buf);
+	fdt_set_size_dt_struct(fdt, new_struct);
+	fdt_set_off_dt_strings(fdt, fdt_off_dt_struct(fdt) + new_struct);
+	fdt_set_size_dt_strings(fdt, new_strings);
+
+	/*
+	 * Move remembered nodes along by the changes before them. A property
+	 * added to an empty node goes at the same position as the node's first
+	 * subnode, and ends up before it.
+	 */
+	for (i = 0; i < edit->num_nodes; i++) {
+		struct fdt_edit_node *node = &edit->nodes[i];
+		int shift = 0;
+
+		for (j = 0; j < edit->num_props; j++) {
+			prop = edit->props[j];
+			if (prop->pos > node->offset)
+				break;
+			shift += fdt_edit_prop_size(prop->len) - prop->old_size;
+		}
+		node->offset += shift;
+	}
+	fdt_edit_drop(edit);
+
+	return ret;
+}
+
+int fdt_edit_close(struct fdt_edit *edit)
+{
+	int ret;
+
+	ret = fdt_edit_apply(edit);
+	if (edit->err)
+		ret = edit->err;
+	free(edit->props);
+	edit->props = NULL;
+	edit->max_props = 0;
+
+	return ret;
+}
+
 #ifdef CONFIG_FDT_FIXUP_PARTITIONS
 #include <jffs2/load_kernel.h>
 #include <mtd_node.h>
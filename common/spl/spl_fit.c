@@ -220,6 +220,81 @@ static int get_aligned_image_size(struct spl_load_info *info, int data_size,
 	return (data_size + info->bl_len - 1) / info->bl_len;
 }
 
+/**
+ * spl_load_fit_data_direct(): read external data straight to its load address
+ * @info:	points to information about the device to load data from
+ * @sector:	the start sector of the FIT image on the device
+ * @offset:	offset of the data from the start of the FIT image
+ * @dst:	where to put the data
+ * @len:	length of the data
+ *
+ * Whole blocks are read in place. A partial block at the start or end of the
+ * data is read into a one-block buffer and only the part belonging to the
+ * data is copied, so nothing outside @dst is overwritten. Building the FIT
+ * with 'mkimage -E -B <block size>' avoids partial blocks altogether.
+ *
+ * Return:	0 on success, -EAGAIN if the data cannot be read in place (the
+ *		caller should fall back to reading it elsewhere and copying it),
+ *		or other negative error number
+ */
+static int spl_load_fit_data_direct(struct spl_load_info *info, ulong sector,
+				    int offset, void *dst, size_t len)
+{
+	ulong bl_len = info->bl_len;
+	ulong skip, head, count, tail;
+	u8 *buf = NULL;
+	int ret = 0;
+
+	if (info->filename || !bl_len)
+		return -EAGAIN;
+
+	sector += offset / bl_len;
+	skip = offset % bl_len;
+	head = skip ? min_t(ulong, bl_len - skip, len) : 0;
+	count = (len - head) / bl_len;
+	tail = (len - head) % bl_len;
+
+	/* The device must be able to DMA to the whole blocks */
+	if (count && !IS_ALIGNED((ulong)dst + head, ARCH_DMA_MINALIGN))
+		return -EAGAIN;
+
+	if (head || tail) {
+		buf = memalign(ARCH_DMA_MINALIGN, bl_len);
+		if (!buf)
+			return -EAGAIN;
+	}
+
+	if (head) {
+		if (info->read(info, sector, 1, buf) != 1) {
+			ret = -EIO;
+			goto out;
+		}
+		memcpy(dst, buf + skip, head);
+		sector++;
+	}
+
+	if (count) {
+		if (info->read(info, sector, count, dst + head) != count) {
+			ret = -EIO;
+			goto out;
+		}
+		sector += count;
+	}
+
+	if (tail) {
+		if (info->read(info, sector, 1, buf) != 1) {
+			ret = -EIO;
+			goto out;
+		}
+		memcpy(dst + head + count * bl_len, buf, tail);
+	}
+
+out:
+	free(buf);
+
+	return ret;
+}
+
 /**
  * spl_load_fit_image(): load the image described in a certain FIT node
  * @info:	points to information about the device to load data from
@@ -253,6 +328,7 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 	bool external_data = false;
 	ulong flush_dcache_addr;
 	ulong flush_lenth;
+	int ret;
 
 	if (IS_ENABLED(CONFIG_SPL_FPGA) ||
 	    (IS_ENABLED(CONFIG_SPL_OS_BOOT) && IS_ENABLED(CONFIG_SPL_GZIP))) {
@@ -297,20 +373,39 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 			return 0;
 		}
 
-		src_ptr = map_sysmem(ALIGN(load_addr, ARCH_DMA_MINALIGN), len);
 		length = len;
 
-		overhead = get_aligned_image_overhead(info, offset);
-		nr_sectors = get_aligned_image_size(info, length, offset);
+		/*
+		 * Uncompressed data which needs no post-processing can be read
+		 * straight to where it belongs
+		 */
+		ret = -EAGAIN;
+		if (image_comp != IH_COMP_GZIP &&
+		    !CONFIG_IS_ENABLED(FIT_IMAGE_POST_PROCESS)) {
+			src_ptr = map_sysmem(load_addr, length);
+			ret = spl_load_fit_data_direct(info, sector, offset,
+						       src_ptr, length);
+			if (ret && ret != -EAGAIN)
+				return ret;
+			src = src_ptr;
+		}
 
-		if (info->read(info,
-			       sector + get_aligned_image_offset(info, offset),
-			       nr_sectors, src_ptr) != nr_sectors)
-			return -EIO;
+		if (ret) {
+			src_ptr = map_sysmem(ALIGN(load_addr, ARCH_DMA_MINALIGN),
+					     len);
+			overhead = get_aligned_image_overhead(info, offset);
+			nr_sectors = get_aligned_image_size(info, length,
+							    offset);
+
+			if (info->read(info,
+				       sector + get_aligned_image_offset(info, offset),
+				       nr_sectors, src_ptr) != nr_sectors)
+				return -EIO;
+			src = src_ptr + overhead;
+		}
 
 		pr_debug("External data: dst=%p, offset=%x, size=%lx\n",
 		      src_ptr, offset, (unsigned long)length);
-		src = src_ptr + overhead;
 	} else {
 		/* Embedded data */
 		if (fit_image_get_data(fit, node, &data, &length)) {
@@ -342,7 +437,7 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 			return -EIO;
 		}
 		length = size;
-	} else {
+	} else if (src != load_ptr) {
 		memcpy(load_ptr, src, length);
 	}
 
@@ -813,7 +908,9 @@ int spl_load_simple_fit(struct spl_image_info *spl_image,
 		if (!spl_fit_image_get_os(ctx.fit, node, &os_type))
 			pr_debug("Loadable is %s\n", genimg_get_os_name(os_type));
 
-		if (os_takes_devicetree(os_type)) {
+		/* an initrd may be marked as os = "linux" too */
+		if (os_takes_devicetree(os_type) &&
+		    !fit_image_check_type(ctx.fit, node, IH_TYPE_RAMDISK)) {
 			spl_fit_append_fdt(&image_info, info, sector, &ctx);
 			spl_image->fdt_addr = image_info.fdt_addr;
 		}
@@ -183,6 +183,24 @@ static int spl_mmc_find_device(struct mmc **mmcp, u32 boot_device)
 }
 
 #ifdef CONFIG_SYS_MMCSD_RAW_MODE_U_BOOT_USE_PARTITION
+static int mmc_load_image_raw_part_name(struct spl_image_info *spl_image,
+					struct spl_boot_device *bootdev,
+					struct mmc *mmc, const char *part_name)
+{
+	struct disk_partition info;
+	int p;
+
+	for (p = 1; p <= MAX_SEARCH_PARTITIONS; p++) {
+		if (part_get_info(mmc_get_blk_desc(mmc), p, &info))
+			continue;
+		if (!strcmp(part_name, info.name))
+			return mmc_load_image_raw_sector(spl_image, bootdev,
+							 mmc, info.start);
+	}
+
+	return -ENOENT;
+}
+
 static int mmc_load_image_raw_partition(struct spl_image_info *spl_image,
 					struct spl_boot_device *bootdev,
 					struct mmc *mmc, int partition,
@@ -190,7 +208,7 @@ static int mmc_load_image_raw_partition(struct spl_image_info *spl_image,
 {
 	struct disk_partition info;
 	int err;
-	const char *part_name;
+	const char *part_name = NULL;
 
 #ifdef CONFIG_SYS_MMCSD_RAW_MODE_U_BOOT_USE_PARTITION_TYPE
 	int type_part;
@@ -223,16 +241,9 @@ static int mmc_load_image_raw_partition(struct spl_image_info *spl_image,
 	}
 #endif
 
-	for (int p = 1; p <= MAX_SEARCH_PARTITIONS; p++) {
-		err = part_get_info(mmc_get_blk_desc(mmc), p, &info);
-		if (err)
-			continue;
-		if (!strcmp(part_name, info.name)){
-			if (mmc_load_image_raw_sector(spl_image, bootdev, mmc, info.start) == 0)
-				return 0;
-			break;
-		}
-	}
+	if (part_name &&
+	    !mmc_load_image_raw_part_name(spl_image, bootdev, mmc, part_name))
+		return 0;
 
 	err = part_get_info(mmc_get_blk_desc(mmc), partition, &info);
 	if (err) {
@@ -492,6 +503,16 @@ int spl_mmc_load(struct spl_image_info *spl_image,
 			err = mmc_load_image_raw_os(spl_image, bootdev, mmc);
 			if (!err)
 				return err;
+#ifdef CONFIG_SYS_LOAD_IMAGE_OS_PARTITION_NAME
+			if (strlen(CONFIG_SYS_LOAD_IMAGE_OS_PARTITION_NAME) > 0) {
+				err = mmc_load_image_raw_part_name(spl_image,
+						bootdev, mmc,
+						CONFIG_SYS_LOAD_IMAGE_OS_PARTITION_NAME);
+				if (!err)
+					return err;
+				debug("spl: no Falcon mode image, starting U-Boot\n");
+			}
+#endif
 		}
 
 		raw_sect = spl_mmc_get_uboot_raw_sector(mmc, raw_sect);
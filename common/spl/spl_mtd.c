@@ -160,6 +160,17 @@ static int spl_spi_load_image(struct spl_image_info *spl_image,
 
 	mtd_probe_devices();
 
+#ifdef CONFIG_SYS_LOAD_IMAGE_OS_PARTITION_NAME
+	if (strlen(CONFIG_SYS_LOAD_IMAGE_OS_PARTITION_NAME) > 0 &&
+	    !spl_start_uboot()) {
+		mtd = get_mtd_device_nm(CONFIG_SYS_LOAD_IMAGE_OS_PARTITION_NAME);
+		if (!IS_ERR_OR_NULL(mtd) &&
+		    !mtd_load_image(spl_image, bootdev, mtd))
+			return 0;
+		debug("spl: no Falcon mode image, starting U-Boot\n");
+	}
+#endif
+
 #ifdef CONFIG_SYS_LOAD_IMAGE_SEC_PARTITION_NAME
 	mtd = get_mtd_device_nm(CONFIG_SYS_LOAD_IMAGE_SEC_PARTITION_NAME);
 	if (IS_ERR_OR_NULL(mtd)){
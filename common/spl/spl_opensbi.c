@@ -22,7 +22,7 @@ DECLARE_GLOBAL_DATA_PTR;
 
 struct fw_dynamic_info opensbi_info;
 
-static int spl_opensbi_find_uboot_node(void *blob, int *uboot_node)
+static int spl_opensbi_find_os_node(void *blob, int *os_node, int os_type)
 {
 	int fit_images_node, node;
 	const char *fit_os;
@@ -36,8 +36,8 @@ static int spl_opensbi_find_uboot_node(void *blob, int *uboot_node)
 		if (!fit_os)
 			continue;
 
-		if (genimg_get_os_id(fit_os) == IH_OS_U_BOOT) {
-			*uboot_node = node;
+		if (genimg_get_os_id(fit_os) == os_type) {
+			*os_node = node;
 			return 0;
 		}
 	}
@@ -130,6 +130,7 @@ void spl_invoke_opensbi(struct spl_image_info *spl_image)
 {
 	int ret, uboot_node;
 	ulong uboot_entry;
+	__maybe_unused bool os_boot = false;
 	void (*opensbi_entry)(ulong hartid, ulong dtb, ulong info);
 
 	if (!spl_image->fdt_addr) {
@@ -138,7 +139,14 @@ void spl_invoke_opensbi(struct spl_image_info *spl_image)
 	}
 
 	/* Find U-Boot image in /fit-images */
-	ret = spl_opensbi_find_uboot_node(spl_image->fdt_addr, &uboot_node);
+	ret = spl_opensbi_find_os_node(spl_image->fdt_addr, &uboot_node,
+				       IH_OS_U_BOOT);
+	if (ret && IS_ENABLED(CONFIG_SPL_LOAD_FIT_OPENSBI_OS_BOOT)) {
+		/* Falcon mode: no U-Boot was loaded, go straight to Linux */
+		ret = spl_opensbi_find_os_node(spl_image->fdt_addr,
+					       &uboot_node, IH_OS_LINUX);
+		os_boot = !ret;
+	}
 	if (ret) {
 		debug("Can't find U-Boot node, %d\n", ret);
 #ifdef CONFIG_SYS_LOAD_IMAGE_SEC_PARTITION
@@ -155,7 +163,8 @@ void spl_invoke_opensbi(struct spl_image_info *spl_image)
 
 #ifdef CONFIG_SYS_LOAD_IMAGE_SEC_PARTITION
 	/*if load other image, uboot_entry maybe not true, set to TEXT_BASE directory*/
-	uboot_entry = CONFIG_SYS_TEXT_BASE;
+	if (!os_boot)
+		uboot_entry = CONFIG_SYS_TEXT_BASE;
 #endif
 	/* Prepare opensbi_info object */
 	opensbi_info.magic = FW_DYNAMIC_INFO_MAGIC_VALUE;
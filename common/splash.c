@@ -119,6 +119,7 @@ void splash_get_pos(int *x, int *y)
 #include <bmp_logo.h>
 #endif
 #include <dm.h>
+#include <video.h>
 #include <video_console.h>
 #include <video_font.h>
 
@@ -144,6 +145,7 @@ void splash_display_banner(void)
 	vidconsole_position_cursor(dev, col, 1);
 	vidconsole_put_string(dev, buf);
 	vidconsole_position_cursor(dev, 0, row);
+	video_sync(dev_get_parent(dev), false);
 }
 #endif /* CONFIG_DM_VIDEO && !CONFIG_HIDE_LOGO_VERSION */
 
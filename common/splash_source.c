@@ -20,6 +20,8 @@
 #include <spi_flash.h>
 #include <splash.h>
 #include <usb.h>
+#include <video.h>
+#include <video_img.h>
 #include <virtio.h>
 #include <asm/global_data.h>
 #include <stdint.h>
@@ -102,6 +104,12 @@ static int splash_load_raw(struct splash_location *location, u32 bmp_load_addr)
 
 	bmp_hdr = (struct bmp_header *)(uintptr_t)bmp_load_addr;
 	bmp_size = le32_to_cpu(bmp_hdr->file_size);
+	if (IS_ENABLED(CONFIG_VIDEO_IMG) && video_img_valid(bmp_load_addr)) {
+		struct video_img_header *img_hdr = (void *)bmp_hdr;
+
+		bmp_size = le32_to_cpu(img_hdr->hdr_size) +
+			   le32_to_cpu(img_hdr->data_size);
+	}
 
 	if (bmp_load_addr + bmp_size >= gd->start_addr_sp)
 		goto splash_address_too_high;
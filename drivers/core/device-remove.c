@@ -199,6 +199,7 @@ static int flags_remove(uint flags, uint drv_flags)
 int device_remove(struct udevice *dev, uint flags)
 {
 	const struct driver *drv;
+	bool pending;
 	int ret;
 
 	if (!dev)
@@ -232,9 +233,18 @@ int device_remove(struct udevice *dev, uint flags)
 		return ret;
 	}
 
-	ret = uclass_pre_remove_device(dev);
-	if (ret)
-		return ret;
+	/*
+	 * Cancel a pending probe rather than waiting for it. The uclass never
+	 * saw the device, so skip its pre-remove step.
+	 */
+	pending = dev_get_flags(dev) & DM_FLAG_PROBE_PENDING;
+	if (pending) {
+		dev_bic_flags(dev, DM_FLAG_PROBE_PENDING);
+	} else {
+		ret = uclass_pre_remove_device(dev);
+		if (ret)
+			return ret;
+	}
 
 	if (drv->remove) {
 		ret = drv->remove(dev);
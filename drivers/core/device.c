@@ -29,6 +29,7 @@
 #include <dm/uclass.h>
 #include <dm/uclass-internal.h>
 #include <dm/util.h>
+#include <watchdog.h>
 #include <iommu.h>
 #include <linux/err.h>
 #include <linux/list.h>
@@ -477,7 +478,66 @@ static int device_get_dma_constraints(struct udevice *dev)
 	return 0;
 }
 
-int device_probe(struct udevice *dev)
+/* Poll the driver of a device until it reports that the device is ready */
+static int device_wait_ready(struct udevice *dev)
+{
+	int ret;
+
+	while (1) {
+		ret = dev->driver->probe_ready(dev);
+		if (ret != -EAGAIN)
+			return ret;
+		WATCHDOG_RESET();
+	}
+}
+
+/*
+ * Complete the probe of a device once the driver's probe() method has run:
+ * wait until it is ready, if needed, then run the uclass post-probe step
+ */
+static int device_probe_post(struct udevice *dev)
+{
+	int ret;
+
+	if (dev->driver->probe_ready) {
+		ret = device_wait_ready(dev);
+		if (ret)
+			goto fail_ready;
+	}
+
+	ret = uclass_post_probe_device(dev);
+	if (ret)
+		goto fail_uclass;
+
+	if (dev->parent && device_get_uclass_id(dev) == UCLASS_PINCTRL) {
+		ret = pinctrl_select_state(dev, "default");
+		if (ret && ret != -ENOSYS)
+			log_debug("Device '%s' failed to configure default pinctrl: %d (%s)\n",
+				  dev->name, ret, errno_str(ret));
+	}
+
+	return device_notify(dev, EVT_DM_POST_PROBE);
+fail_ready:
+	/* the uclass has not seen the device yet, so only undo probe() */
+	if (dev->driver->remove && dev->driver->remove(dev)) {
+		dm_warn("%s: Device '%s' failed to remove on error path\n",
+			__func__, dev->name);
+	}
+	goto fail;
+fail_uclass:
+	if (device_remove(dev, DM_REMOVE_NORMAL)) {
+		dm_warn("%s: Device '%s' failed to remove on error path\n",
+			__func__, dev->name);
+	}
+fail:
+	dev_bic_flags(dev, DM_FLAG_ACTIVATED);
+
+	device_free(dev);
+
+	return ret;
+}
+
+static int device_probe_(struct udevice *dev, bool async)
 {
 	const struct driver *drv;
 	int ret;
@@ -485,8 +545,14 @@ int device_probe(struct udevice *dev)
 	if (!dev)
 		return -EINVAL;
 
-	if (dev_get_flags(dev) & DM_FLAG_ACTIVATED)
+	if (dev_get_flags(dev) & DM_FLAG_ACTIVATED) {
+		/* someone wants to use it, so wait for a pending probe */
+		if (!async && (dev_get_flags(dev) & DM_FLAG_PROBE_PENDING)) {
+			dev_bic_flags(dev, DM_FLAG_PROBE_PENDING);
+			return device_probe_post(dev);
+		}
 		return 0;
+	}
 
 	ret = device_notify(dev, EVT_DM_PRE_PROBE);
 	if (ret)
@@ -585,27 +651,13 @@ int device_probe(struct udevice *dev)
 			goto fail;
 	}
 
-	ret = uclass_post_probe_device(dev);
-	if (ret)
-		goto fail_uclass;
-
-	if (dev->parent && device_get_uclass_id(dev) == UCLASS_PINCTRL) {
-		ret = pinctrl_select_state(dev, "default");
-		if (ret && ret != -ENOSYS)
-			log_debug("Device '%s' failed to configure default pinctrl: %d (%s)\n",
-				  dev->name, ret, errno_str(ret));
+	/* leave the device to get ready while we do something else */
+	if (async && drv->probe_ready) {
+		dev_or_flags(dev, DM_FLAG_PROBE_PENDING);
+		return 0;
 	}
 
-	ret = device_notify(dev, EVT_DM_POST_PROBE);
-	if (ret)
-		return ret;
-
-	return 0;
-fail_uclass:
-	if (device_remove(dev, DM_REMOVE_NORMAL)) {
-		dm_warn("%s: Device '%s' failed to remove on error path\n",
-			__func__, dev->name);
-	}
+	return device_probe_post(dev);
 fail:
 	dev_bic_flags(dev, DM_FLAG_ACTIVATED);
 
@@ -614,6 +666,16 @@ fail:
 	return ret;
 }
 
+int device_probe(struct udevice *dev)
+{
+	return device_probe_(dev, false);
+}
+
+int device_probe_async(struct udevice *dev)
+{
+	return device_probe_(dev, CONFIG_IS_ENABLED(DM_ASYNC_PROBE));
+}
+
 void *dev_get_plat(const struct udevice *dev)
 {
 	if (!dev) {
@@ -22,6 +22,7 @@
 #include <common.h>
 #include <log.h>
 #include <malloc.h>
+#include <sort.h>
 #include <asm/global_data.h>
 #include <linux/bug.h>
 #include <linux/libfdt.h>
@@ -47,6 +48,29 @@ static struct device_node *of_stdout;
 /* pointer to options given after the alias (separated by :) or NULL if none */
 static const char *of_stdout_options;
 
+/* Do not index phandles larger than this, to bound the table size */
+#define OF_PHANDLE_INDEX_MAX	0x10000
+
+/**
+ * struct of_compat_entry - Entry in the compatible-string index
+ *
+ * @compat:	One of the strings in the node's compatible property
+ * @np:		Node with that compatible string
+ * @order:	Position of the node in a walk of the whole tree
+ */
+struct of_compat_entry {
+	const char *compat;
+	struct device_node *np;
+	int order;
+};
+
+/* Indexes for the tree at of_index_root, set up by of_index_scan() */
+static struct device_node *of_index_root;
+static struct device_node **of_phandle_index;
+static phandle of_phandle_index_max;
+static struct of_compat_entry *of_compat_index;
+static int of_compat_index_count;
+
 /**
  * struct alias_prop - Alias property in 'aliases' node
  *
@@ -404,11 +428,80 @@ struct device_node *of_find_node_opts_by_path(struct device_node *root,
 	return np;
 }
 
+/* Find the first entry for @compat in the compatible-string index */
+static int of_compat_index_find(const char *compat)
+{
+	int lo = 0, hi = of_compat_index_count;
+
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+
+		if (of_compat_cmp(of_compat_index[mid].compat, compat, 0) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == of_compat_index_count ||
+	    of_compat_cmp(of_compat_index[lo].compat, compat, 0))
+		return -ENOENT;
+
+	return lo;
+}
+
+/*
+ * Look up the next node after @from with a compatible string, using the
+ * index. Returns -EAGAIN if @from is not in the index, in which case the
+ * caller must walk the tree.
+ */
+static int of_find_compatible_indexed(struct device_node *from,
+				      const char *compatible,
+				      struct device_node **npp)
+{
+	struct of_compat_entry *entry, *end;
+	int i;
+
+	*npp = NULL;
+	i = of_compat_index_find(compatible);
+	if (i < 0)
+		return 0;
+
+	entry = &of_compat_index[i];
+	end = &of_compat_index[of_compat_index_count];
+	if (from) {
+		int order = -1;
+
+		/* usually @from is the previous match for the same string */
+		for (; entry < end; entry++) {
+			if (of_compat_cmp(entry->compat, compatible, 0))
+				return -EAGAIN;
+			if (entry->np == from) {
+				order = entry->order;
+				break;
+			}
+		}
+		if (order < 0)
+			return -EAGAIN;
+		while (entry < end && entry->order == order)
+			entry++;
+	}
+	if (entry < end && !of_compat_cmp(entry->compat, compatible, 0))
+		*npp = entry->np;
+
+	return 0;
+}
+
 struct device_node *of_find_compatible_node(struct device_node *from,
 		const char *type, const char *compatible)
 {
 	struct device_node *np;
 
+	if (of_compat_index && of_index_root == gd->of_root &&
+	    (!type || !*type) && compatible && *compatible &&
+	    !of_find_compatible_indexed(from, compatible, &np)) {
+		of_node_put(from);
+		return of_node_get(np);
+	}
+
 	for_each_of_allnodes_from(from, np)
 		if (of_device_is_compatible(np, compatible, type, NULL) &&
 		    of_node_get(np))
@@ -452,6 +545,10 @@ struct device_node *of_find_node_by_phandle(phandle handle)
 	if (!handle)
 		return NULL;
 
+	if (of_phandle_index && of_index_root == gd->of_root &&
+	    handle <= of_phandle_index_max)
+		return of_node_get(of_phandle_index[handle]);
+
 	for_each_of_allnodes(np)
 		if (np->phandle == handle)
 			break;
@@ -845,6 +942,93 @@ int of_alias_scan(void)
 	return 0;
 }
 
+static int of_compat_entry_cmp(const void *a, const void *b)
+{
+	const struct of_compat_entry *ea = a, *eb = b;
+	int ret;
+
+	ret = of_compat_cmp(ea->compat, eb->compat, 0);
+	if (ret)
+		return ret;
+
+	return ea->order - eb->order;
+}
+
+static void of_index_free(void)
+{
+	free(of_phandle_index);
+	of_phandle_index = NULL;
+	of_phandle_index_max = 0;
+	free(of_compat_index);
+	of_compat_index = NULL;
+	of_compat_index_count = 0;
+	of_index_root = NULL;
+}
+
+int of_index_scan(void)
+{
+	struct device_node *np;
+	struct property *prop;
+	const char *cp;
+	phandle max = 0;
+	int count = 0;
+	int order = 0;
+
+	of_index_free();
+	if (!CONFIG_IS_ENABLED(OF_LIVE_INDEX))
+		return 0;
+
+	for_each_of_allnodes(np) {
+		if (np->phandle > max && np->phandle <= OF_PHANDLE_INDEX_MAX)
+			max = np->phandle;
+		prop = of_find_property(np, "compatible", NULL);
+		for (cp = of_prop_next_string(prop, NULL); cp;
+		     cp = of_prop_next_string(prop, cp))
+			count++;
+	}
+
+	if (max) {
+		of_phandle_index = calloc(max + 1, sizeof(*of_phandle_index));
+		if (!of_phandle_index)
+			return -ENOMEM;
+		of_phandle_index_max = max;
+	}
+	if (count) {
+		of_compat_index = malloc(count * sizeof(*of_compat_index));
+		if (!of_compat_index) {
+			of_index_free();
+			return -ENOMEM;
+		}
+	}
+
+	for_each_of_allnodes(np) {
+		/* the first node wins, as with a walk of the tree */
+		if (np->phandle && np->phandle <= max &&
+		    !of_phandle_index[np->phandle])
+			of_phandle_index[np->phandle] = np;
+
+		prop = of_find_property(np, "compatible", NULL);
+		for (cp = of_prop_next_string(prop, NULL); cp;
+		     cp = of_prop_next_string(prop, cp)) {
+			struct of_compat_entry *entry;
+
+			entry = &of_compat_index[of_compat_index_count++];
+			entry->compat = cp;
+			entry->np = np;
+			entry->order = order;
+		}
+		order++;
+	}
+	if (of_compat_index)
+		qsort(of_compat_index, of_compat_index_count,
+		      sizeof(*of_compat_index), of_compat_entry_cmp);
+	of_index_root = gd->of_root;
+	debug("%s: %u phandles, %d compatible strings\n", __func__,
+	      of_phandle_index_max, of_compat_index_count);
+
+	return 0;
+}
+
 int of_alias_get_id(const struct device_node *np, const char *stem)
 {
 	struct alias_prop *app;
@@ -898,6 +1082,23 @@ int of_write_prop(struct device_node *np, const char *propname, int len,
 	if (!np)
 		return -EINVAL;
 
+	/* the index holds pointers into the old compatible strings */
+	if (of_compat_index && !strcmp(propname, "compatible")) {
+		free(of_compat_index);
+		of_compat_index = NULL;
+		of_compat_index_count = 0;
+	}
+
+	/* keep the node's phandle in step, as of_live_build() sets it */
+	if (!strcmp(propname, "phandle") ||
+	    !strcmp(propname, "linux,phandle")) {
+		if (len == sizeof(phandle))
+			np->phandle = be32_to_cpup(value);
+		free(of_phandle_index);
+		of_phandle_index = NULL;
+		of_phandle_index_max = 0;
+	}
+
 	for (pp = np->properties; pp; pp = pp->next) {
 		if (strcmp(pp->name, propname) == 0) {
 			/* Property exists -> change value */
@@ -815,6 +815,22 @@ int uclass_probe_all(enum uclass_id id)
 	return 0;
 }
 
+int uclass_probe_all_async(enum uclass_id id)
+{
+	struct udevice *dev;
+	int ret;
+
+	ret = uclass_find_first_device(id, &dev);
+	while (!ret && dev) {
+		ret = device_probe_async(dev);
+		if (ret)
+			log_debug("Cannot probe '%s' (err=%d)\n", dev->name, ret);
+		ret = uclass_find_next_device(&dev);
+	}
+
+	return ret;
+}
+
 int uclass_id_count(enum uclass_id id)
 {
 	struct udevice *dev;
@@ -96,6 +96,17 @@ static lbaint_t fb_blk_sparse_write(struct sparse_storage *info,
 	return fb_blk_write(dev_desc, blk, blkcnt, buffer);
 }
 
+static lbaint_t fb_blk_sparse_erase(struct sparse_storage *info,
+		lbaint_t blk, lbaint_t blkcnt, const void *buffer)
+{
+	struct fb_blk_sparse *sparse = info->priv;
+	struct blk_desc *dev_desc = sparse->dev_desc;
+
+	if (fastboot_progress_callback)
+		fastboot_progress_callback("erasing");
+	return blk_derase(dev_desc, blk, blkcnt);
+}
+
 static lbaint_t fb_blk_sparse_reserve(struct sparse_storage *info,
 		lbaint_t blk, lbaint_t blkcnt)
 {
@@ -204,6 +215,15 @@ void fastboot_blk_flash_write(const char *cmd, void *download_buffer,
 		printf("init fdev success\n");
 	}
 
+#if CONFIG_IS_ENABLED(SPACEMIT_FLASH_BLOCKHASH)
+	if (!strncmp(cmd, FB_BLOCKHASH_PREFIX, strlen(FB_BLOCKHASH_PREFIX))) {
+		fastboot_flash_blockhash(cmd + strlen(FB_BLOCKHASH_PREFIX),
+					 download_buffer, download_bytes,
+					 response);
+		return;
+	}
+
+#endif
 	/*blk device would not flash bootinfo except emmc*/
 	if (strcmp(cmd, "bootinfo") == 0) {
 		fastboot_okay(NULL, response);
@@ -299,6 +319,9 @@ void fastboot_blk_flash_write(const char *cmd, void *download_buffer,
 		sparse.start = info.start;
 		sparse.size = info.size;
 		sparse.write = fb_blk_sparse_write;
+		/* NVMe erases with Write Zeroes, other devices may not zero */
+		if (dev_desc->if_type == IF_TYPE_NVME)
+			sparse.erase = fb_blk_sparse_erase;
 		sparse.reserve = fb_blk_sparse_reserve;
 		sparse.mssg = fastboot_fail;
 
@@ -310,6 +333,11 @@ void fastboot_blk_flash_write(const char *cmd, void *download_buffer,
 					 response);
 		if (!err)
 			fastboot_okay(NULL, response);
+	} else if (fastboot_blockhash_write(dev_desc, info.start, cmd,
+					    part_offset_t, download_buffer,
+					    download_bytes, response)) {
+		/* each chunk written was checked already */
+		part_offset_t += download_bytes;
 	} else {
 		write_raw_image(dev_desc, &info, cmd, download_buffer,
 				download_bytes, response);
@@ -0,0 +1,232 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Copyright (c) 2023 Spacemit, Inc
+ *
+ * Delta flashing driven by a block-hash manifest: the manifest lists the
+ * SHA256 of each fixed-size chunk of an image, and only the chunks whose
+ * hash differs from what the device already holds are written.
+ *
+ * The manifest is a text file:
+ *
+ *	blockhash sha256 <chunk size> <image size>
+ *	<sha256 of chunk 0, in hex>
+ *	<sha256 of chunk 1, in hex>
+ *	...
+ *
+ * The last chunk only covers the end of the image.
+ */
+
+#include <common.h>
+#include <blk.h>
+#include <errno.h>
+#include <fastboot.h>
+#include <fb_spacemit.h>
+#include <hexdump.h>
+#include <log.h>
+#include <malloc.h>
+#include <memalign.h>
+#include <linux/ctype.h>
+#include <linux/kernel.h>
+#include <linux/sizes.h>
+#include <u-boot/sha256.h>
+
+#define FB_BLOCKHASH_MAGIC	"blockhash sha256 "
+
+/* manifest sent with 'fastboot flash blockhash:<part>' */
+static struct fb_blockhash fastboot_bh;
+
+static const char *next_line(const char *p, const char *end)
+{
+	while (p < end && *p != '\n')
+		p++;
+
+	return p < end ? p + 1 : end;
+}
+
+int fb_blockhash_load(struct fb_blockhash *bh, const char *part_name,
+		      const char *buf, size_t len)
+{
+	const char *end = buf + len;
+	const char *p;
+	char line[80];
+	char *q;
+	u64 chunk_size;
+	u32 i;
+
+	fb_blockhash_free(bh);
+
+	/* the header line, NUL terminated for the number parsing */
+	p = next_line(buf, end);
+	if (p - buf >= sizeof(line))
+		return -EINVAL;
+	memcpy(line, buf, p - buf);
+	line[p - buf] = '\0';
+	if (strncmp(line, FB_BLOCKHASH_MAGIC, strlen(FB_BLOCKHASH_MAGIC)))
+		return -EINVAL;
+
+	chunk_size = simple_strtoull(line + strlen(FB_BLOCKHASH_MAGIC),
+				     &q, 0);
+	bh->image_size = simple_strtoull(q, NULL, 0);
+	if (!chunk_size || chunk_size > SZ_4M || chunk_size % SZ_512 ||
+	    !bh->image_size) {
+		pr_err("bad block-hash chunk size %llx or image size %llx\n",
+		       chunk_size, bh->image_size);
+		return -EINVAL;
+	}
+	bh->chunk_size = chunk_size;
+	bh->count = DIV_ROUND_UP(bh->image_size, bh->chunk_size);
+
+	bh->hash = malloc(bh->count * SHA256_SUM_LEN);
+	bh->buf = memalign(ARCH_DMA_MINALIGN, bh->chunk_size);
+	if (!bh->hash || !bh->buf) {
+		fb_blockhash_free(bh);
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < bh->count; i++) {
+		if (end - p < SHA256_SUM_LEN * 2 ||
+		    hex2bin(bh->hash[i], p, SHA256_SUM_LEN) ||
+		    (end - p > SHA256_SUM_LEN * 2 &&
+		     !isspace(p[SHA256_SUM_LEN * 2]))) {
+			pr_err("bad block-hash entry %u\n", i);
+			fb_blockhash_free(bh);
+			return -EINVAL;
+		}
+		p = next_line(p, end);
+	}
+
+	strlcpy(bh->part_name, part_name, sizeof(bh->part_name));
+	bh->skipped = 0;
+	bh->written = 0;
+
+	return 0;
+}
+
+void fb_blockhash_free(struct fb_blockhash *bh)
+{
+	free(bh->hash);
+	free(bh->buf);
+	memset(bh, 0, sizeof(*bh));
+}
+
+bool fb_blockhash_covers(const struct fb_blockhash *bh, u64 offset, u64 len,
+			 ulong blksz)
+{
+	if (!bh->hash || bh->chunk_size % blksz)
+		return false;
+
+	/* whole chunks only, but for the one at the end of the image */
+	if (offset % bh->chunk_size || offset + len > bh->image_size)
+		return false;
+
+	return !(len % bh->chunk_size) || offset + len == bh->image_size;
+}
+
+static bool chunk_matches(const struct fb_blockhash *bh, u32 index,
+			  const void *data, u32 len)
+{
+	u8 sum[SHA256_SUM_LEN];
+
+	sha256_csum_wd(data, len, sum, CHUNKSZ_SHA256);
+
+	return !memcmp(sum, bh->hash[index], SHA256_SUM_LEN);
+}
+
+int fb_blockhash_write_blk(struct fb_blockhash *bh, struct blk_desc *dev_desc,
+			   lbaint_t start, u64 offset, const void *buf, u64 len)
+{
+	u64 pos;
+	u32 index, n;
+	lbaint_t blks;
+
+	for (pos = 0; pos < len; pos += n, start += blks) {
+		index = (offset + pos) / bh->chunk_size;
+		n = min_t(u64, bh->chunk_size, len - pos);
+		blks = DIV_ROUND_UP(n, dev_desc->blksz);
+
+		if (blk_dread(dev_desc, start, blks, bh->buf) != blks)
+			return -EIO;
+		if (chunk_matches(bh, index, bh->buf, n)) {
+			bh->skipped += n;
+			continue;
+		}
+
+		/* a stale manifest must not pass off old data as flashed */
+		if (!chunk_matches(bh, index, buf + pos, n)) {
+			pr_err("chunk %u does not match its block hash\n",
+			       index);
+			return -EBADMSG;
+		}
+
+		if (blk_dwrite(dev_desc, start, blks, buf + pos) != blks)
+			return -EIO;
+
+		/* read the chunk back, in place of checking the whole image */
+		if (blk_dread(dev_desc, start, blks, bh->buf) != blks ||
+		    !chunk_matches(bh, index, bh->buf, n)) {
+			pr_err("chunk %u did not read back correctly\n", index);
+			return -EIO;
+		}
+		bh->written += n;
+	}
+
+	return 0;
+}
+
+void fb_blockhash_report(const struct fb_blockhash *bh)
+{
+	printf("........ %s: %llu bytes unchanged, %llu bytes written\n",
+	       bh->part_name, bh->skipped, bh->written);
+}
+
+void fastboot_flash_blockhash(const char *part_name, void *download_buffer,
+			      u32 download_bytes, char *response)
+{
+	int ret;
+
+	ret = fb_blockhash_load(&fastboot_bh, part_name, download_buffer,
+				download_bytes);
+	if (ret) {
+		fastboot_fail("invalid block-hash manifest", response);
+		return;
+	}
+
+	printf("block-hash manifest for '%s': %u chunks of %u bytes\n",
+	       part_name, fastboot_bh.count, fastboot_bh.chunk_size);
+	fastboot_okay(NULL, response);
+}
+
+static struct fb_blockhash *fastboot_blockhash_get(const char *part_name)
+{
+	if (!fastboot_bh.hash || strcmp(fastboot_bh.part_name, part_name))
+		return NULL;
+
+	return &fastboot_bh;
+}
+
+bool fastboot_blockhash_write(struct blk_desc *dev_desc, lbaint_t start,
+			      const char *part_name, u64 offset,
+			      void *download_buffer, u32 download_bytes,
+			      char *response)
+{
+	struct fb_blockhash *bh = fastboot_blockhash_get(part_name);
+
+	if (!bh || !fb_blockhash_covers(bh, offset, download_bytes,
+					dev_desc->blksz))
+		return false;
+
+	printf("Flashing Raw Image by block hash\n");
+	if (fb_blockhash_write_blk(bh, dev_desc, start, offset,
+				   download_buffer, download_bytes)) {
+		fb_blockhash_free(bh);
+		fastboot_fail("failed writing by block hash", response);
+		return true;
+	}
+
+	fb_blockhash_report(bh);
+	if (offset + download_bytes == bh->image_size)
+		fb_blockhash_free(bh);
+	fastboot_okay(NULL, response);
+
+	return true;
+}
@@ -19,6 +19,7 @@
 #include <fb_mtd.h>
 #include <fb_blk.h>
 #include <dm.h>
+#include <trace.h>
 
 /**
  * image_size - final fastboot image size
@@ -771,6 +772,25 @@ static void oem_read(char *cmd_parameter, char *response)
 		return;
 	}
 
+	if (CONFIG_IS_ENABLED(TRACE) && !strcmp(part, "trace")) {
+		size_t funcs, calls;
+
+		/* Stop tracing so the data is consistent; for tools/proftool */
+		trace_set_enabled(0);
+		if (trace_list_functions(fastboot_buf_addr, fastboot_buf_size,
+					 &funcs) ||
+		    trace_list_calls(fastboot_buf_addr + funcs,
+				     fastboot_buf_size - funcs, &calls)) {
+			fastboot_fail("trace data too large for buffer",
+				      response);
+			return;
+		}
+		fastboot_bytes_expected = funcs + calls;
+		fastboot_response("OKAY", response, "%08x",
+				  fastboot_bytes_expected);
+		return;
+	}
+
 	offset_str = strsep(&cmd_str, " ");
 	if (!offset_str){
 		pr_info("miss offset, would set offset to 0\n");
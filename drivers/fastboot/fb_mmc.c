@@ -168,7 +168,28 @@ static lbaint_t fb_mmc_sparse_erase(struct sparse_storage *info,
 {
 	struct fb_mmc_sparse *sparse = info->priv;
 	struct blk_desc *dev_desc = sparse->dev_desc;
-	return fb_mmc_blk_write(dev_desc, blk, blkcnt, NULL);
+
+	/* the whole run at once, mmc_berase() splits it by erase group */
+	if (fastboot_progress_callback)
+		fastboot_progress_callback("erasing");
+	return blk_derase(dev_desc, blk, blkcnt);
+}
+
+/*
+ * Erase group size to discard sparse zero fills with, or 0 if the card does
+ * not read erased blocks back as zero.
+ */
+static lbaint_t fb_mmc_sparse_erase_size(struct blk_desc *dev_desc)
+{
+	struct mmc *mmc = find_mmc_device(dev_desc->devnum);
+
+	if (!mmc)
+		return 0;
+	if (IS_SD(mmc) ? mmc->scr[0] & SD_SCR_DATA_STAT_AFTER_ERASE :
+	    !mmc->ext_csd || mmc->ext_csd[EXT_CSD_ERASED_MEM_CONT])
+		return 0;
+
+	return mmc->erase_grp_size;
 }
 
 static lbaint_t fb_mmc_sparse_reserve(struct sparse_storage *info,
@@ -505,16 +526,8 @@ static struct blk_desc *fastboot_mmc_get_dev(char *response)
 }
 
 
-/**
- * fastboot_mmc_flash_write() - Write image to eMMC for fastboot
- *
- * @cmd: Named partition to write image to
- * @download_buffer: Pointer to image data
- * @download_bytes: Size of image data
- * @response: Pointer to fastboot response buffer
- */
-void fastboot_mmc_flash_write(const char *cmd, void *download_buffer,
-			      u32 download_bytes, char *response)
+static void fb_mmc_flash_write(const char *cmd, void *download_buffer,
+			       u32 download_bytes, char *response)
 {
 	struct blk_desc *dev_desc;
 	struct disk_partition info = {0};
@@ -546,6 +559,15 @@ void fastboot_mmc_flash_write(const char *cmd, void *download_buffer,
 		printf("init fdev success\n");
 	}
 
+#if CONFIG_IS_ENABLED(SPACEMIT_FLASH_BLOCKHASH)
+	if (!strncmp(cmd, FB_BLOCKHASH_PREFIX, strlen(FB_BLOCKHASH_PREFIX))) {
+		fastboot_flash_blockhash(cmd + strlen(FB_BLOCKHASH_PREFIX),
+					 download_buffer, download_bytes,
+					 response);
+		return;
+	}
+
+#endif
 	if (strcmp(cmd, "bootinfo") == 0) {
 		printf("flash bootinfo\n");
 		fastboot_oem_flash_bootinfo(cmd, fastboot_buf_addr, download_bytes,
@@ -735,7 +757,9 @@ void fastboot_mmc_flash_write(const char *cmd, void *download_buffer,
 		sparse.start = info.start;
 		sparse.size = info.size;
 		sparse.write = fb_mmc_sparse_write;
-		sparse.erase = fb_mmc_sparse_erase;
+		sparse.erase_size = fb_mmc_sparse_erase_size(dev_desc);
+		if (sparse.erase_size)
+			sparse.erase = fb_mmc_sparse_erase;
 		sparse.reserve = fb_mmc_sparse_reserve;
 		sparse.mssg = fastboot_fail;
 
@@ -747,6 +771,11 @@ void fastboot_mmc_flash_write(const char *cmd, void *download_buffer,
 					 response);
 		if (!err)
 			fastboot_okay(NULL, response);
+	} else if (fastboot_blockhash_write(dev_desc, info.start, cmd,
+					    part_offset_t, download_buffer,
+					    download_bytes, response)) {
+		/* each chunk written was checked already */
+		part_offset_t += download_bytes;
 	} else {
 		write_raw_image(dev_desc, &info, cmd, download_buffer,
 				download_bytes, response);
@@ -762,6 +791,34 @@ void fastboot_mmc_flash_write(const char *cmd, void *download_buffer,
 	}
 }
 
+/**
+ * fastboot_mmc_flash_write() - Write image to eMMC for fastboot
+ *
+ * The eMMC write cache, if enabled, is on while the image is written, and
+ * flushed before the host is answered.
+ *
+ * @cmd: Named partition to write image to
+ * @download_buffer: Pointer to image data
+ * @download_bytes: Size of image data
+ * @response: Pointer to fastboot response buffer
+ */
+void fastboot_mmc_flash_write(const char *cmd, void *download_buffer,
+			      u32 download_bytes, char *response)
+{
+	struct mmc *mmc = NULL;
+
+	if (IS_ENABLED(CONFIG_MMC_WRITE_CACHE)) {
+		mmc = find_mmc_device(CONFIG_FASTBOOT_FLASH_MMC_DEV);
+		if (mmc && (mmc_init(mmc) || mmc_set_cache(mmc, true)))
+			mmc = NULL;
+	}
+
+	fb_mmc_flash_write(cmd, download_buffer, download_bytes, response);
+
+	if (mmc && mmc_set_cache(mmc, false) && !strncmp(response, "OKAY", 4))
+		fastboot_fail("failed to flush eMMC write cache", response);
+}
+
 /**
  * fastboot_mmc_flash_erase() - Erase eMMC for fastboot
  *
@@ -6,6 +6,7 @@
 #include <config.h>
 #include <common.h>
 #include <blk.h>
+#include <dm.h>
 #include <fb_mtd.h>
 #include <fastboot.h>
 #include <image-sparse.h>
@@ -16,7 +17,9 @@
 #include <fb_spacemit.h>
 #include <fastboot-internal.h>
 #include <u-boot/crc.h>
+#include <malloc.h>
 #include <mapmem.h>
+#include <memalign.h>
 #include <mtd.h>
 #include <linux/mtd/spi-nor.h>
 #include <linux/delay.h>
@@ -246,6 +249,178 @@ int _fb_mtd_read(struct mtd_info *mtd, void *buffer, u32 offset,
 		return 0;
 }
 
+#if CONFIG_IS_ENABLED(FASTBOOT_MTD_NOR_UPDATE)
+/* what a NOR sector needs to hold the new image */
+enum fb_nor_sector {
+	FB_NOR_SAME,	/* already holds it */
+	FB_NOR_BLANK,	/* is erased, only needs programming */
+	FB_NOR_ERASE,	/* needs erasing and programming */
+	FB_NOR_ERASED,	/* was erased, which is all it needed */
+};
+
+/*
+ * The block sizes the flash under @mtd erases, smallest first: SPI NOR
+ * flashes may have erase commands for blocks smaller and larger than
+ * mtd->erasesize, which spi_nor_erase() picks from.
+ */
+static int fb_mtd_erase_sizes(struct mtd_info *mtd, u32 *sizes)
+{
+	struct mtd_info *master = mtd->parent ? mtd->parent : mtd;
+	struct spi_nor *nor;
+	int i, j, n = 0;
+	u32 size;
+
+	if (!master->dev ||
+	    device_get_uclass_id(master->dev) != UCLASS_SPI_FLASH) {
+		sizes[0] = mtd->erasesize;
+		return 1;
+	}
+
+	nor = dev_get_uclass_priv(master->dev);
+	for (i = 0; i < SNOR_ERASE_TYPE_MAX; i++) {
+		size = nor->erase_types[i].size;
+		if (!size)
+			continue;
+		for (j = n; j > 0 && sizes[j - 1] > size; j--)
+			sizes[j] = sizes[j - 1];
+		sizes[j] = size;
+		n++;
+	}
+
+	if (!n) {
+		sizes[0] = mtd->erasesize;
+		n = 1;
+	}
+
+	return n;
+}
+
+static enum fb_nor_sector fb_mtd_nor_sector(const u8 *flash, const u8 *image,
+					    u32 len)
+{
+	if (!memcmp(flash, image, len))
+		return FB_NOR_SAME;
+	if (!memchr_inv(flash, 0xff, len))
+		return FB_NOR_BLANK;
+
+	return FB_NOR_ERASE;
+}
+
+int _fb_mtd_update(struct mtd_info *mtd, void *buffer, u32 length)
+{
+	u32 sizes[SNOR_ERASE_TYPE_MAX];
+	struct erase_info erase_op = {};
+	u64 unchanged = 0, erased = 0, programmed = 0;
+	u32 granule, window, count, per, dirty, off, n, i, j, k;
+	u8 *state = NULL, *buf = NULL;
+	int nsizes, ret = -1;
+
+	if (mtd->type != MTD_NORFLASH) {
+		if (_fb_mtd_erase(mtd, length))
+			return -1;
+		return _fb_mtd_write(mtd, buffer, 0, length, NULL);
+	}
+
+	nsizes = fb_mtd_erase_sizes(mtd, sizes);
+	granule = sizes[0];
+	window = max(sizes[nsizes - 1], mtd->erasesize);
+	count = DIV_ROUND_UP(length, granule);
+	if ((u64)count * granule > mtd->size || mtd->offset % granule) {
+		printf("cannot update %x bytes of mtd part %s\n", length,
+		       mtd->name);
+		return -1;
+	}
+
+	state = malloc(count);
+	buf = memalign(ARCH_DMA_MINALIGN, window);
+	if (!state || !buf)
+		goto out;
+
+	/* read ahead a window at a time and sort out what each sector needs */
+	for (off = 0; off < length; off += window) {
+		n = min(window, count * granule - off);
+		if (_fb_mtd_read(mtd, buf, off, n, NULL))
+			goto out;
+
+		for (i = 0; i < n; i += granule)
+			state[(off + i) / granule] =
+				fb_mtd_nor_sector(buf + i, buffer + off + i,
+						  min(granule, length - off - i));
+	}
+
+	/*
+	 * A larger block is quicker to erase with one command than most of
+	 * its sectors one by one, even if the rest are then programmed again.
+	 */
+	for (k = 1; k < nsizes; k++) {
+		per = sizes[k] / granule;
+		i = (sizes[k] - mtd->offset % sizes[k]) % sizes[k] / granule;
+		for (; i + per <= count; i += per) {
+			for (dirty = 0, j = i; j < i + per; j++)
+				dirty += state[j] == FB_NOR_ERASE;
+			if (dirty * 2 > per)
+				memset(state + i, FB_NOR_ERASE, per);
+		}
+	}
+
+	/* erase each run of sectors, the driver picks the erase commands */
+	erase_op.mtd = mtd;
+	for (i = 0; i < count; i = j) {
+		for (j = i; j < count && state[j] == FB_NOR_ERASE; j++)
+			;
+		if (j == i) {
+			j++;
+			continue;
+		}
+
+		erase_op.addr = (u64)i * granule;
+		erase_op.len = (u64)(j - i) * granule;
+		if (mtd_erase(mtd, &erase_op)) {
+			printf("Failed erasing at offset 0x%llx\n",
+			       erase_op.addr);
+			goto out;
+		}
+		erased += erase_op.len;
+	}
+
+	/* erased is what an image's padding wants, no need to program it */
+	for (i = 0; i < count; i++) {
+		off = i * granule;
+		if (state[i] == FB_NOR_ERASE &&
+		    !memchr_inv(buffer + off, 0xff, min(granule, length - off)))
+			state[i] = FB_NOR_ERASED;
+	}
+
+	/* program each run of erased sectors */
+	for (i = 0; i < count; i = j) {
+		for (j = i; j < count && (state[j] == FB_NOR_BLANK ||
+					  state[j] == FB_NOR_ERASE); j++)
+			;
+		if (j == i) {
+			if (state[i] == FB_NOR_SAME)
+				unchanged += min(granule, length - i * granule);
+			j++;
+			continue;
+		}
+
+		off = i * granule;
+		n = min(j * granule, length) - off;
+		if (_fb_mtd_write(mtd, buffer + off, off, n, NULL))
+			goto out;
+		programmed += n;
+	}
+
+	printf("........ %s: %llu bytes unchanged, %llu bytes erased, %llu bytes programmed\n",
+	       mtd->name, unchanged, erased, programmed);
+	ret = 0;
+out:
+	free(buf);
+	free(state);
+
+	return ret;
+}
+#endif
+
 static lbaint_t fb_mtd_sparse_write(struct sparse_storage *info,
 		lbaint_t blk, lbaint_t blkcnt, const void *buffer)
 {
@@ -422,6 +597,9 @@ void fastboot_mtd_flash_write(const char *cmd, void *download_buffer,
 				fastboot_fail("failed erasing partition", response);
 				return;
 			}
+		} else if (CONFIG_IS_ENABLED(FASTBOOT_MTD_NOR_UPDATE) &&
+			   !is_sparse_image(download_buffer)) {
+			/* the raw image write erases the sectors it changes */
 		} else {
 			/* For non-UBI partitions, use internal erase function */
 			printf("Erasing MTD partition %s\n", part->name);
@@ -567,8 +745,12 @@ void fastboot_mtd_flash_write(const char *cmd, void *download_buffer,
 			return;
 		}
 
+#if CONFIG_IS_ENABLED(FASTBOOT_MTD_NOR_UPDATE)
+		ret = _fb_mtd_update(mtd, download_buffer, download_bytes);
+#else
 		ret = _fb_mtd_write(mtd, download_buffer, 0,
 				     download_bytes, NULL);
+#endif
 
 		if (ret < 0) {
 			printf("Failed to write mtd part:%s\n", cmd);
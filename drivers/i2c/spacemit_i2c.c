@@ -627,7 +627,7 @@ static int spacemit_i2c_probe(struct udevice *bus)
                 return ret;
         }
 #endif
-	priv->base = (void *)devfdt_get_addr_ptr(bus);
+	priv->base = dev_read_addr_ptr(bus);
 	ret = dev_read_u32(bus, "clock-frequency", &priv->clk_rate);
         if (ret) {
                 pr_info("Default to 100kHz\n");
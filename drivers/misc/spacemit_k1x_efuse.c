@@ -6,16 +6,21 @@
  *
  */
 
-#include <asm/io.h>
+#include <common.h>
+#include <bloblist.h>
+#include <clk.h>
 #include <command.h>
 #include <display_options.h>
 #include <dm.h>
-#include <clk.h>
+#include <misc.h>
 #include <reset-uclass.h>
+#include <asm/global_data.h>
+#include <asm/io.h>
 #include <linux/delay.h>
-#include <misc.h>
 #include <power/regulator.h>
 
+DECLARE_GLOBAL_DATA_PTR;
+
 // #define EFUSE_DEBUG
 
 #define EFUSE_UUID_OFFSET	(0x104)  /* bank 0,chip UUID */
@@ -102,6 +107,8 @@ struct spacemit_efuse_plat {
 	struct efuse_data efuse;
 	int efuse_need_reload;
 	int efuse_power_flag;
+	bool shadow_saved;	/* efuse data has been written to the bloblist */
+	bool shadow_stale;	/* the bloblist copy is out of date */
 	struct udevice *regulator;
 };
 
@@ -219,6 +226,53 @@ int efuse_reload(struct udevice *dev)
 	return 0;
 }
 
+/*
+ * Reading the fuses needs a GEU update, which takes over 200ms. SPL reads them
+ * once and keeps a shadow copy in the bloblist; later phases use that instead.
+ */
+#if CONFIG_IS_ENABLED(BLOBLIST)
+static int efuse_shadow_restore(struct udevice *dev)
+{
+	struct spacemit_efuse_plat *plat = dev_get_plat(dev);
+	void *shadow;
+
+	if (!gd->bloblist || plat->shadow_stale)
+		return -ENOENT;
+	shadow = bloblist_find(BLOBLISTT_SPACEMIT_EFUSE, sizeof(plat->efuse));
+	if (!shadow)
+		return -ENOENT;
+	memcpy(&plat->efuse, shadow, sizeof(plat->efuse));
+	plat->shadow_saved = true;
+
+	return 0;
+}
+
+static void efuse_shadow_save(struct udevice *dev)
+{
+	struct spacemit_efuse_plat *plat = dev_get_plat(dev);
+	void *shadow;
+
+	/* the bloblist may not be set up yet, so try again on the next read */
+	if (!gd->bloblist)
+		return;
+	shadow = bloblist_ensure(BLOBLISTT_SPACEMIT_EFUSE, sizeof(plat->efuse));
+	if (!shadow)
+		return;
+	memcpy(shadow, &plat->efuse, sizeof(plat->efuse));
+	plat->shadow_saved = true;
+	plat->shadow_stale = false;
+}
+#else
+static int efuse_shadow_restore(struct udevice *dev)
+{
+	return -ENOENT;
+}
+
+static void efuse_shadow_save(struct udevice *dev)
+{
+}
+#endif
+
 int efuse_read_bank(struct udevice *dev, int offset, void *buf, int size)
 {
 	uint8_t *ptr;
@@ -233,10 +287,15 @@ int efuse_read_bank(struct udevice *dev, int offset, void *buf, int size)
 	}
 
 	if (plat->efuse_need_reload) {
-		efuse_reload(dev);
-		efuse_load_all(dev);
+		if (efuse_shadow_restore(dev)) {
+			efuse_reload(dev);
+			efuse_load_all(dev);
+			plat->shadow_saved = false;
+		}
 		plat->efuse_need_reload = 0;
 	}
+	if (!plat->shadow_saved)
+		efuse_shadow_save(dev);
 
 	ptr = (uint8_t *)&(plat->efuse);
 	memcpy(buf, ptr + offset, size);
@@ -305,6 +364,7 @@ int efuse_write_bank_core(struct udevice *dev, uint32_t bank_index, uint32_t *bu
 
 	se_clock_off(dev);
 	plat->efuse_need_reload = 1;
+	plat->shadow_stale = true;
 
 	return 0;
 }
@@ -431,7 +491,7 @@ static int spacemit_efuse_of_to_plat(struct udevice *dev)
 	int ret;
 	struct spacemit_efuse_plat *plat = dev_get_plat(dev);
 
-	plat->reg_base = dev_read_addr_ptr(dev);
+	plat->reg_base = dev_remap_addr(dev);
 	plat->efuse_need_reload = 1;
 
 	ret = clk_get_bulk(dev, &plat->clks);
@@ -965,7 +965,7 @@ static int spacemit_sdhci_of_to_plat(struct udevice *dev)
 	int ret = 0;
 
 	host->name = dev->name;
-	host->ioaddr = (void *)devfdt_get_addr(dev);
+	host->ioaddr = (void *)dev_read_addr(dev);
 	priv->phy_module = dev_read_u32_default(dev, "sdh-phy-module", 0);
 	priv->clk_src_freq = dev_read_u32_default(dev, "clk-src-freq", SDHC_DEFAULT_MAX_CLOCK);
 
@@ -24,6 +24,7 @@
 #include <memalign.h>
 #include <linux/list.h>
 #include <div64.h>
+#include <asm/unaligned.h>
 #include "mmc_private.h"
 
 #define DEFAULT_CMD6_TIMEOUT_MS  500
@@ -801,21 +802,27 @@ int mmc_send_ext_csd(struct mmc *mmc, u8 *ext_csd)
 	return err;
 }
 
+/*
+ * timeout_ms is how long the switch may keep the card busy, 0 for the
+ * generic CMD6 time.
+ */
 static int __mmc_switch(struct mmc *mmc, u8 set, u8 index, u8 value,
-			bool send_status)
+			bool send_status, int timeout_ms)
 {
 	unsigned int status, start;
 	struct mmc_cmd cmd;
-	int timeout_ms = DEFAULT_CMD6_TIMEOUT_MS;
 	bool is_part_switch = (set == EXT_CSD_CMD_SET_NORMAL) &&
 			      (index == EXT_CSD_PART_CONF);
 	int ret;
 
-	if (mmc->gen_cmd6_time)
-		timeout_ms = mmc->gen_cmd6_time * 10;
+	if (!timeout_ms) {
+		timeout_ms = DEFAULT_CMD6_TIMEOUT_MS;
+		if (mmc->gen_cmd6_time)
+			timeout_ms = mmc->gen_cmd6_time * 10;
 
-	if (is_part_switch  && mmc->part_switch_time)
-		timeout_ms = mmc->part_switch_time * 10;
+		if (is_part_switch  && mmc->part_switch_time)
+			timeout_ms = mmc->part_switch_time * 10;
+	}
 
 	cmd.cmdidx = MMC_CMD_SWITCH;
 	cmd.resp_type = MMC_RSP_R1b;
@@ -871,9 +878,56 @@ static int __mmc_switch(struct mmc *mmc, u8 set, u8 index, u8 value,
 
 int mmc_switch(struct mmc *mmc, u8 set, u8 index, u8 value)
 {
-	return __mmc_switch(mmc, set, index, value, true);
+	return __mmc_switch(mmc, set, index, value, true, 0);
+}
+
+#if IS_ENABLED(CONFIG_MMC_WRITE_CACHE)
+/* how long writing the whole cache back may take, as Linux allows */
+#define MMC_CACHE_FLUSH_TIMEOUT_MS	30000
+
+static bool mmc_has_cache(struct mmc *mmc)
+{
+	return IS_MMC(mmc) && mmc->version >= MMC_VERSION_4_5 &&
+	       mmc->ext_csd &&
+	       get_unaligned_le32(&mmc->ext_csd[EXT_CSD_CACHE_SIZE]);
 }
 
+int mmc_flush_cache(struct mmc *mmc)
+{
+	if (!mmc_has_cache(mmc) || !(mmc->ext_csd[EXT_CSD_CACHE_CTRL] & 1))
+		return 0;
+
+	return __mmc_switch(mmc, EXT_CSD_CMD_SET_NORMAL, EXT_CSD_FLUSH_CACHE,
+			    1, true, MMC_CACHE_FLUSH_TIMEOUT_MS);
+}
+
+int mmc_set_cache(struct mmc *mmc, bool enable)
+{
+	int err;
+
+	if (!mmc_has_cache(mmc))
+		return enable ? -EOPNOTSUPP : 0;
+	if ((mmc->ext_csd[EXT_CSD_CACHE_CTRL] & 1) == enable)
+		return 0;
+
+	if (!enable) {
+		err = mmc_flush_cache(mmc);
+		if (err)
+			return err;
+	}
+
+	err = __mmc_switch(mmc, EXT_CSD_CMD_SET_NORMAL, EXT_CSD_CACHE_CTRL,
+			   enable, true, MMC_CACHE_FLUSH_TIMEOUT_MS);
+	if (err)
+		return err;
+
+	/* the saved EXT_CSD tells whether the cache is on */
+	mmc->ext_csd[EXT_CSD_CACHE_CTRL] = enable;
+
+	return 0;
+}
+#endif
+
 int mmc_boot_wp(struct mmc *mmc)
 {
 	return mmc_switch(mmc, EXT_CSD_CMD_SET_NORMAL, EXT_CSD_BOOT_WP, 1);
@@ -944,7 +998,7 @@ static int mmc_set_card_speed(struct mmc *mmc, enum bus_mode mode,
 	}
 
 	err = __mmc_switch(mmc, EXT_CSD_CMD_SET_NORMAL, EXT_CSD_HS_TIMING,
-			   speed_bits, !hsdowngrade);
+			   speed_bits, !hsdowngrade, 0);
 	if (err)
 		return err;
 
@@ -9,7 +9,6 @@
 #include <malloc.h>
 #include <sdhci.h>
 #include <reset-uclass.h>
-#include <asm/global_data.h>
 
 #define SPACEMIT_SDHC_MIN_FREQ    (400000)
 #define SDHCI_CTRL_ADMA2_LEN_MODE BIT(10)
@@ -20,8 +19,6 @@
 
 #define SDHCI_CLOCK_PLL_EN BIT(3)
 
-DECLARE_GLOBAL_DATA_PTR;
-
 struct spacemit_sdhci_plat {
 	struct mmc_config cfg;
 	struct mmc mmc;
@@ -77,15 +74,13 @@ static int spacemit_sdhci_probe(struct udevice *dev)
 		return ret;
 	}
 
-	max_clk = fdtdec_get_int(gd->fdt_blob, dev_of_offset(dev),
-					"max-frequency", 50000000);
+	max_clk = dev_read_u32_default(dev, "max-frequency", 50000000);
 
 	host->name = dev->name;
 	host->ioaddr = dev_read_addr_ptr(dev);
 	host->ops = &spacemit_ops;
 	host->quirks = SDHCI_QUIRK_WAIT_SEND_CMD;
-	host->bus_width	= fdtdec_get_int(gd->fdt_blob, dev_of_offset(dev),
-					 "bus-width", 4);
+	host->bus_width	= dev_read_u32_default(dev, "bus-width", 4);
 
 	ret = mmc_of_parse(dev, &plat->cfg);
 	if (ret)
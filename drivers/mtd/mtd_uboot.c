@@ -137,7 +137,7 @@ static const char *get_mtdparts(void)
 	static char tmp_parts[MTDPARTS_MAXLEN];
 	const char *mtdparts = NULL;
 
-	if (gd->flags & GD_FLG_ENV_READY)
+	if ((gd->flags & GD_FLG_ENV_READY) || CONFIG_IS_ENABLED(ENV_VIEW))
 		mtdparts = env_get("mtdparts");
 	else if (env_get_f("mtdparts", tmp_parts, sizeof(tmp_parts)) != -1)
 		mtdparts = tmp_parts;
@@ -614,12 +614,15 @@ static u8 spi_nor_convert_3to4_erase(u8 opcode)
 static void spi_nor_set_4byte_opcodes(struct spi_nor *nor,
 				      const struct flash_info *info)
 {
+	int i;
+
 	/* Do some manufacturer fixups first */
 	switch (JEDEC_MFR(info)) {
 	case SNOR_MFR_SPANSION:
 		/* No small sector erase for 4-byte command set */
 		nor->erase_opcode = SPINOR_OP_SE;
 		nor->mtd.erasesize = info->sector_size;
+		memset(nor->erase_types, 0, sizeof(nor->erase_types));
 		break;
 
 	default:
@@ -629,6 +632,9 @@ static void spi_nor_set_4byte_opcodes(struct spi_nor *nor,
 	nor->read_opcode = spi_nor_convert_3to4_read(nor->read_opcode);
 	nor->program_opcode = spi_nor_convert_3to4_program(nor->program_opcode);
 	nor->erase_opcode = spi_nor_convert_3to4_erase(nor->erase_opcode);
+	for (i = 0; i < SNOR_ERASE_TYPE_MAX; i++)
+		nor->erase_types[i].opcode =
+			spi_nor_convert_3to4_erase(nor->erase_types[i].opcode);
 }
 #endif /* !CONFIG_SPI_FLASH_BAR */
 
@@ -880,11 +886,53 @@ static int read_bar(struct spi_nor *nor, const struct flash_info *info)
 #endif
 
 /*
- * Initiate the erasure of a single sector. Returns the number of bytes erased
- * on success, a negative error code on error.
+ * The largest erase command that starts at @addr and does not erase past
+ * @len bytes from there, NULL if there is none: flashes with a single erase
+ * command only know the sector erase.
+ */
+static const struct spi_nor_erase_type *
+spi_nor_find_erase_type(struct spi_nor *nor, u32 addr, u32 len)
+{
+	const struct spi_nor_erase_type *best = NULL;
+	const struct spi_nor_erase_type *type;
+	int i;
+
+	for (i = 0; i < SNOR_ERASE_TYPE_MAX; i++) {
+		type = &nor->erase_types[i];
+		if (!type->size || addr % type->size || len < type->size)
+			continue;
+		if (!best || type->size > best->size)
+			best = type;
+	}
+
+	return best;
+}
+
+/*
+ * The smallest length spi_nor_erase() can erase: the sector, or the smallest
+ * erase command of a flash that has several.
  */
-static int spi_nor_erase_sector(struct spi_nor *nor, u32 addr)
+static u32 spi_nor_erase_granule(struct spi_nor *nor)
 {
+	u32 granule = nor->mtd.erasesize;
+	int i;
+
+	for (i = 0; i < SNOR_ERASE_TYPE_MAX; i++)
+		if (nor->erase_types[i].size &&
+		    nor->erase_types[i].size < granule)
+			granule = nor->erase_types[i].size;
+
+	return granule;
+}
+
+/*
+ * Initiate the erasure of a single sector, or of the largest block up to @len
+ * bytes the flash can erase with one command. Returns the number of bytes
+ * erased on success, a negative error code on error.
+ */
+static int spi_nor_erase_sector(struct spi_nor *nor, u32 addr, u32 len)
+{
+	const struct spi_nor_erase_type *type;
 	struct spi_mem_op op =
 		SPI_MEM_OP(SPI_MEM_OP_CMD(nor->erase_opcode, 0),
 			   SPI_MEM_OP_ADDR(nor->addr_width, addr, 0),
@@ -892,6 +940,10 @@ static int spi_nor_erase_sector(struct spi_nor *nor, u32 addr)
 			   SPI_MEM_OP_NO_DATA);
 	int ret;
 
+	type = spi_nor_find_erase_type(nor, addr, len);
+	if (type)
+		op.cmd.opcode = type->opcode;
+
 	spi_nor_setup_op(nor, &op, nor->write_proto);
 
 	if (nor->erase)
@@ -905,7 +957,7 @@ static int spi_nor_erase_sector(struct spi_nor *nor, u32 addr)
 	if (ret)
 		return ret;
 
-	return nor->mtd.erasesize;
+	return type ? type->size : nor->mtd.erasesize;
 }
 
 /*
@@ -922,7 +974,7 @@ static int spi_nor_erase(struct mtd_info *mtd, struct erase_info *instr)
 	dev_dbg(nor->dev, "at 0x%llx, len %lld\n", (long long)instr->addr,
 		(long long)instr->len);
 
-	div_u64_rem(instr->len, mtd->erasesize, &rem);
+	div_u64_rem(instr->len, spi_nor_erase_granule(nor), &rem);
 	if (rem) {
 		ret = -EINVAL;
 		goto err;
@@ -950,7 +1002,7 @@ static int spi_nor_erase(struct mtd_info *mtd, struct erase_info *instr)
 		if (ret < 0)
 			goto erase_err;
 
-		ret = spi_nor_erase_sector(nor, addr);
+		ret = spi_nor_erase_sector(nor, addr, len);
 		if (ret < 0)
 			goto erase_err;
 
@@ -2260,6 +2312,18 @@ static int spi_nor_parse_bfpt(struct spi_nor *nor,
 		spi_nor_set_read_settings_from_bfpt(read, half, rd->proto);
 	}
 
+	/* Every Erase Type, for spi_nor_erase() to choose from. */
+	for (i = 0; i < ARRAY_SIZE(sfdp_bfpt_erases); i++) {
+		const struct sfdp_bfpt_erase *er = &sfdp_bfpt_erases[i];
+
+		half = bfpt.dwords[er->dword] >> er->shift;
+		if (!(half & 0xff))
+			continue;
+
+		nor->erase_types[i].size = 1U << (half & 0xff);
+		nor->erase_types[i].opcode = (half >> 8) & 0xff;
+	}
+
 	/* Sector Erase settings. */
 	for (i = 0; i < ARRAY_SIZE(sfdp_bfpt_erases); i++) {
 		const struct sfdp_bfpt_erase *er = &sfdp_bfpt_erases[i];
@@ -2772,6 +2836,7 @@ static int spi_nor_init_params(struct spi_nor *nor,
 	/* Override the parameters with data read from SFDP tables. */
 	nor->addr_width = 0;
 	nor->mtd.erasesize = 0;
+	memset(nor->erase_types, 0, sizeof(nor->erase_types));
 	if ((info->flags & (SPI_NOR_DUAL_READ | SPI_NOR_QUAD_READ |
 	     SPI_NOR_OCTAL_DTR_READ)) &&
 	    !(info->flags & SPI_NOR_SKIP_SFDP)) {
@@ -2781,6 +2846,7 @@ static int spi_nor_init_params(struct spi_nor *nor,
 		if (spi_nor_parse_sfdp(nor, &sfdp_params)) {
 			nor->addr_width = 0;
 			nor->mtd.erasesize = 0;
+			memset(nor->erase_types, 0, sizeof(nor->erase_types));
 		} else {
 			memcpy(params, &sfdp_params, sizeof(*params));
 		}
@@ -3096,6 +3162,16 @@ static int spi_nor_select_erase(struct spi_nor *nor,
 	if (mtd->erasesize)
 		return 0;
 
+	if (info->flags & SECT_4K) {
+		nor->erase_types[0].size = SZ_4K;
+		nor->erase_types[0].opcode = SPINOR_OP_BE_4K;
+	} else if (info->flags & SECT_4K_PMC) {
+		nor->erase_types[0].size = SZ_4K;
+		nor->erase_types[0].opcode = SPINOR_OP_BE_4K_PMC;
+	}
+	nor->erase_types[1].size = info->sector_size;
+	nor->erase_types[1].opcode = SPINOR_OP_SE;
+
 #ifdef CONFIG_SPI_FLASH_USE_4K_SECTORS
 	/* prefer "small sector" erase if possible */
 	if (info->flags & SECT_4K) {
@@ -3113,6 +3189,23 @@ static int spi_nor_select_erase(struct spi_nor *nor,
 	return 0;
 }
 
+/*
+ * The erase commands only stand in for the sector erase if they include it,
+ * fixups may have chosen another one, and if the driver does not erase in
+ * its own way.
+ */
+static void spi_nor_check_erase_types(struct spi_nor *nor)
+{
+	int i;
+
+	for (i = 0; i < SNOR_ERASE_TYPE_MAX && !nor->erase; i++)
+		if (nor->erase_types[i].size == nor->mtd.erasesize &&
+		    nor->erase_types[i].opcode == nor->erase_opcode)
+			return;
+
+	memset(nor->erase_types, 0, sizeof(nor->erase_types));
+}
+
 static int spi_nor_default_setup(struct spi_nor *nor,
 				 const struct flash_info *info,
 				 const struct spi_nor_flash_parameter *params)
@@ -4136,6 +4229,8 @@ int spi_nor_scan(struct spi_nor *nor)
 	if (ret)
 		return ret;
 
+	spi_nor_check_erase_types(nor);
+
 	nor->rdsr_dummy = params.rdsr_dummy;
 	nor->rdsr_addr_nbytes = params.rdsr_addr_nbytes;
 	nor->name = info->name;
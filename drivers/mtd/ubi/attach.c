@@ -1387,6 +1387,27 @@ out:
 	return err;
 }
 
+
+/**
+ * drop_fastmap - forget the fastmap an attach failed with.
+ * @ubi: UBI device description object
+ *
+ * Frees what ubi_scan_fastmap() allocated, for attaching by a full scan
+ * to start afresh.
+ */
+static void drop_fastmap(struct ubi_device *ubi)
+{
+	int i;
+
+	if (!ubi->fm)
+		return;
+
+	for (i = 0; i < ubi->fm->used_blocks; i++)
+		kfree(ubi->fm->e[i]);
+	kfree(ubi->fm);
+	ubi->fm = NULL;
+}
+
 #endif
 
 /**
@@ -1399,7 +1420,8 @@ out:
  */
 int ubi_attach(struct ubi_device *ubi, int force_scan)
 {
-	int err;
+	int err, i;
+	bool fastmap = false;
 	struct ubi_attach_info *ai;
 
 	ai = alloc_ai();
@@ -1417,6 +1439,12 @@ int ubi_attach(struct ubi_device *ubi, int force_scan)
 		err = scan_all(ubi, ai, 0);
 	else {
 		err = scan_fast(ubi, &ai);
+		if (err < 0 && err != -ENOMEM && !mtd_is_eccerr(err)) {
+			ubi_warn(ubi, "cannot read fastmap (%d), doing a full scan",
+				 err);
+			drop_fastmap(ubi);
+			err = UBI_BAD_FASTMAP;
+		}
 		if (err > 0 || mtd_is_eccerr(err)) {
 			if (err != UBI_NO_FASTMAP) {
 				destroy_ai(ai);
@@ -1430,6 +1458,7 @@ int ubi_attach(struct ubi_device *ubi, int force_scan)
 			}
 		}
 	}
+	fastmap = !!ubi->fm;
 #else
 	err = scan_all(ubi, ai, 0);
 #endif
@@ -1484,11 +1513,34 @@ int ubi_attach(struct ubi_device *ubi, int force_scan)
 
 out_wl:
 	ubi_wl_close(ubi);
+#ifdef CONFIG_MTD_UBI_FASTMAP
+	/* ubi_wl_close() freed it */
+	ubi->fm = NULL;
+#endif
 out_vtbl:
+	for (i = 0; i < ubi->vtbl_slots; i++) {
+		if (!ubi->volumes[i])
+			continue;
+		kfree(ubi->volumes[i]->eba_tbl);
+		kfree(ubi->volumes[i]);
+		ubi->volumes[i] = NULL;
+	}
 	ubi_free_internal_volumes(ubi);
 	vfree(ubi->vtbl);
 out_ai:
 	destroy_ai(ai);
+#ifdef CONFIG_MTD_UBI_FASTMAP
+	/*
+	 * A fastmap which reads back fine may still disagree with the volume
+	 * table or the EBA; the flash itself is the authority then.
+	 */
+	if (fastmap && err != -ENOMEM) {
+		ubi_warn(ubi, "attach by fastmap failed (%d), doing a full scan",
+			 err);
+		drop_fastmap(ubi);
+		return ubi_attach(ubi, 1);
+	}
+#endif
 	return err;
 }
 
@@ -965,7 +965,7 @@ static int emac_eth_ofdata_to_platdata(struct udevice *dev)
     struct emac_priv *priv = dev_get_priv(dev);
     u32 ctrl_reg;
 
-    pdata->iobase = devfdt_get_addr(dev);
+    pdata->iobase = dev_read_addr(dev);
     /* Interface mode is required */
     pdata->phy_interface = dev_read_phy_mode(dev);
     priv->phy_interface = pdata->phy_interface;
@@ -636,6 +636,7 @@ static int nvme_get_info_from_identify(struct nvme_dev *dev)
 
 	dev->nn = le32_to_cpu(ctrl->nn);
 	dev->vwc = ctrl->vwc;
+	dev->oncs = le16_to_cpu(ctrl->oncs);
 	memcpy(dev->serial, ctrl->sn, sizeof(ctrl->sn));
 	memcpy(dev->model, ctrl->mn, sizeof(ctrl->mn));
 	memcpy(dev->firmware_rev, ctrl->fr, sizeof(ctrl->fr));
@@ -814,9 +815,45 @@ static ulong nvme_blk_write(struct udevice *udev, lbaint_t blknr,
 	return nvme_blk_rw(udev, blknr, blkcnt, (void *)buffer, false);
 }
 
+/* Erase with Write Zeroes, so the blocks read back as zero */
+static ulong nvme_blk_erase(struct udevice *udev, lbaint_t blknr,
+			    lbaint_t blkcnt)
+{
+	struct nvme_ns *ns = dev_get_priv(udev);
+	struct nvme_dev *dev = ns->dev;
+	struct nvme_command c;
+	lbaint_t done = 0;
+	u32 lbas;
+	int status;
+
+	if (!(dev->oncs & NVME_CTRL_ONCS_WRITE_ZEROES))
+		return -ENOSYS;
+
+	memset(&c, 0, sizeof(c));
+	c.rw.opcode = nvme_cmd_write_zeroes;
+	c.rw.nsid = cpu_to_le32(ns->ns_id);
+	/* let the controller deallocate the blocks, they still read zero */
+	c.rw.control = cpu_to_le16(NVME_WZ_DEAC);
+
+	while (done < blkcnt) {
+		/* the number of blocks is a 0's based 16 bit field */
+		lbas = min_t(lbaint_t, blkcnt - done, 0x10000);
+		c.rw.slba = cpu_to_le64(blknr + done);
+		c.rw.length = cpu_to_le16(lbas - 1);
+		status = nvme_submit_sync_cmd(dev->queues[NVME_IO_Q],
+					      &c, NULL, IO_TIMEOUT);
+		if (status)
+			break;
+		done += lbas;
+	}
+
+	return done;
+}
+
 static const struct blk_ops nvme_blk_ops = {
 	.read	= nvme_blk_read,
 	.write	= nvme_blk_write,
+	.erase	= nvme_blk_erase,
 };
 
 U_BOOT_DRIVER(nvme_blk) = {
@@ -94,6 +94,8 @@ struct pcie_dw_k1x {
 	struct reset_ctl reset;
 	struct gpio_desc pwr_on_gpio;
 	int power_on_status;
+
+	ulong link_timeout;	/* get_timer() value to give up on the link */
 };
 
 enum dw_pcie_device_mode {
@@ -202,32 +204,21 @@ static int is_link_up(struct pcie_dw_k1x *pci)
 }
 
 /**
- * wait_link_up() - Wait for the link to come up
+ * pcie_dw_k1x_start_link() - Start link training
  *
- * @regs_base: A pointer to the PCIe controller registers
+ * @pci: Controller to use
+ * @cap_speed: Highest link speed to train for
  *
- * Return: 1 (true) for active line and 0 (false) for no link (timeout)
+ * The link comes up in the background; pcie_dw_k1x_probe_ready() waits for it.
  */
-static int wait_link_up(struct pcie_dw_k1x *pci)
-{
-	unsigned long timeout;
-
-	timeout = get_timer(0) + PCIE_LINK_UP_TIMEOUT_MS;
-	while (!is_link_up(pci)) {
-		if (get_timer(0) > timeout)
-			return 0;
-	};
-
-	return 1;
-}
-
-static int pcie_dw_k1x_pcie_link_up(struct pcie_dw_k1x *pci, u32 cap_speed)
+static void pcie_dw_k1x_start_link(struct pcie_dw_k1x *pci, u32 cap_speed)
 {
 	u32 reg;
 
+	pci->link_timeout = get_timer(0) + PCIE_LINK_UP_TIMEOUT_MS;
 	if (is_link_up(pci)) {
 		printf("PCI Link already up before configuration!\n");
-		return 1;
+		return;
 	}
 
 	/* DW pre link configurations */
@@ -238,18 +229,6 @@ static int pcie_dw_k1x_pcie_link_up(struct pcie_dw_k1x *pci, u32 cap_speed)
 	reg |= LTSSM_EN;
 	reg &= ~APP_HOLD_PHY_RST;
 	k1x_pcie_writel(pci, PCIECTRL_K1X_CONF_DEVICE_CMD, reg);
-
-	/* Check that link was established */
-	if (!wait_link_up(pci))
-		return 0;
-
-	/*
-	 * Link can be established in Gen 1. still need to wait
-	 * till MAC nagaotiation is completed
-	 */
-	udelay(100);
-
-	return 1;
 }
 
 static int pcie_set_mode(struct pcie_dw_k1x *pci,
@@ -672,20 +651,18 @@ static int k1x_power_on(struct pcie_dw_k1x *pci, int on)
 }
 
 /**
- * pcie_dw_k1x_probe() - Probe the PCIe bus for active link
+ * pcie_dw_k1x_probe() - Start the PCIe link
  *
  * @dev: A pointer to the device being operated on
  *
- * Probe for an active link on the PCIe bus and configure the controller
- * to enable this port.
+ * Configure the controller to enable this port and start link training.
+ * pcie_dw_k1x_probe_ready() then waits for the link to come up.
  *
- * Return: 0 on success, else -ENODEV
+ * Return: 0 on success
  */
 static int pcie_dw_k1x_probe(struct udevice *dev)
 {
 	struct pcie_dw_k1x *pci = dev_get_priv(dev);
-	struct udevice *ctlr = pci_get_controller(dev);
-	struct pci_controller *hose = dev_get_uclass_priv(ctlr);
 	struct phy phy0, phy1;
 	int ret;
 	u32 reg;
@@ -735,21 +712,50 @@ static int pcie_dw_k1x_probe(struct udevice *dev)
 	pcie_dw_setup_host(&pci->dw);
 	pcie_dw_init_id(pci);
 
-	if (!pcie_dw_k1x_pcie_link_up(pci, LINK_SPEED_GEN_2)) {
+	pcie_dw_k1x_start_link(pci, LINK_SPEED_GEN_2);
+
+	return 0;
+}
+
+/**
+ * pcie_dw_k1x_probe_ready() - Check whether the link is up
+ *
+ * @dev: A pointer to the device being operated on
+ *
+ * Once the link trained by pcie_dw_k1x_probe() is up, set up the outbound
+ * window so the bus can be scanned.
+ *
+ * Return: 0 if the link is up, -EAGAIN if still training, -ENODEV on timeout
+ */
+static int pcie_dw_k1x_probe_ready(struct udevice *dev)
+{
+	struct pcie_dw_k1x *pci = dev_get_priv(dev);
+	struct udevice *ctlr = pci_get_controller(dev);
+	struct pci_controller *hose = dev_get_uclass_priv(ctlr);
+
+	if (!is_link_up(pci)) {
+		if (get_timer(0) <= pci->link_timeout)
+			return -EAGAIN;
 		printf("PCIE-%d: Link down\n", dev_seq(dev));
 		return -ENODEV;
 	}
 
+	/*
+	 * Link can be established in Gen 1. still need to wait
+	 * till MAC nagaotiation is completed
+	 */
+	udelay(100);
+
 	printf("PCIE-%d: Link up (Gen%d-x%d, Bus%d)\n", dev_seq(dev),
 	       pcie_dw_get_link_speed(&pci->dw),
 	       pcie_dw_get_link_width(&pci->dw),
 	       hose->first_busno);
 
-	ret = pcie_dw_prog_outbound_atu_unroll(&pci->dw, PCIE_ATU_REGION_INDEX0,
-					 PCIE_ATU_TYPE_MEM,
-					 pci->dw.mem.phys_start,
-					 pci->dw.mem.bus_start, pci->dw.mem.size);
-	return 0;
+	return pcie_dw_prog_outbound_atu_unroll(&pci->dw, PCIE_ATU_REGION_INDEX0,
+						PCIE_ATU_TYPE_MEM,
+						pci->dw.mem.phys_start,
+						pci->dw.mem.bus_start,
+						pci->dw.mem.size);
 }
 
 /**
@@ -857,5 +863,6 @@ U_BOOT_DRIVER(pcie_dw_k1x) = {
 	.ops			= &pcie_dw_k1x_ops,
 	.of_to_plat	= pcie_dw_k1x_of_to_plat,
 	.probe			= pcie_dw_k1x_probe,
+	.probe_ready		= pcie_dw_k1x_probe_ready,
 	.priv_auto	= sizeof(struct pcie_dw_k1x),
 };
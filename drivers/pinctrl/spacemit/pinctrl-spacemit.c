@@ -6,7 +6,6 @@
 #include <malloc.h>
 #include <mapmem.h>
 #include <reset.h>
-#include <asm/global_data.h>
 #include <dm/device_compat.h>
 #include <dm/devres.h>
 #include <linux/bitops.h>
@@ -17,16 +16,13 @@
 
 #include "pinctrl-spacemit.h"
 
-DECLARE_GLOBAL_DATA_PTR;
-
 static int spacemit_pinctrl_set_state(struct udevice *dev, struct udevice *config)
 {
 	struct spacemit_pinctrl_priv *priv = dev_get_priv(dev);
 	struct spacemit_pinctrl_soc_info *info = priv->info;
 	const struct spacemit_regs *regs = info->regs;
 	const struct spacemit_pin_conf *pin_conf = info->pinconf;
-	int node = dev_of_offset(config);
-	const struct fdt_property *prop;
+	const void *prop;
 	u32 *pin_data;
 	int npins, size, pin_size;
 	u32 pin_id, mux_sel, pull_val, drv_strength;
@@ -39,7 +35,7 @@ static int spacemit_pinctrl_set_state(struct udevice *dev, struct udevice *confi
 	dev_dbg(dev, "%s: %s\n", __func__, config->name);
 	pin_size = SPACEMIT_PIN_SIZE;
 
-	prop = fdt_getprop(gd->fdt_blob, node, "spacemit,pins", &size);
+	prop = dev_read_prop(config, "spacemit,pins", &size);
 	if (!prop) {
 		dev_err(dev, "No spacemit,pins property in node %s\n", config->name);
 		return -EINVAL;
@@ -55,8 +51,8 @@ static int spacemit_pinctrl_set_state(struct udevice *dev, struct udevice *confi
 	if (!pin_data)
 		return -ENOMEM;
 
-	if (fdtdec_get_int_array(gd->fdt_blob, node, "spacemit,pins",
-				 pin_data, size >> 2)) {
+	if (dev_read_u32_array(config, "spacemit,pins", pin_data,
+			       size >> 2)) {
 		dev_err(dev, "Error reading pin data.\n");
 		devm_kfree(dev, pin_data);
 		return -EINVAL;
@@ -122,7 +118,7 @@ int spacemit_pinctrl_probe(struct udevice *dev,
 	priv->dev = dev;
 	priv->info = info;
 
-	addr = devfdt_get_addr_size_index(dev, 0, &size);
+	addr = dev_read_addr_size_index(dev, 0, &size);
 	if (addr == FDT_ADDR_T_NONE)
 		return -EINVAL;
 
@@ -315,6 +315,16 @@ void serial_puts(const char *str)
 		_serial_puts(gd->cur_serial_dev, str);
 }
 
+int serial_try_putc(const char ch)
+{
+	struct udevice *dev = gd->cur_serial_dev;
+
+	if (!dev)
+		return -ENODEV;
+
+	return serial_get_ops(dev)->putc(dev, ch);
+}
+
 int serial_getc(void)
 {
 	if (!gd->cur_serial_dev)
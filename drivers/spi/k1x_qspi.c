@@ -939,8 +939,6 @@ static int k1x_qspi_ofdata_to_platdata(struct udevice *bus)
 	fdt_addr_t iobase_size;
 	fdt_addr_t ahb_addr;
 	fdt_addr_t ahb_size;
-	const void *blob = gd->fdt_blob;
-	int node = dev_of_offset(bus);
 
 	qspi->dev = bus;
 
@@ -983,19 +981,19 @@ static int k1x_qspi_ofdata_to_platdata(struct udevice *bus)
 		return ret;
 	}
 
-	qspi->qspi_id = fdtdec_get_int(blob, node, "qspi-id", 0);
-	qspi->sfa1ad = fdtdec_get_int(blob, node, "qspi-sfa1ad", (QSPI_FLASH_A1_TOP - QSPI_AMBA_BASE));
-	qspi->sfa2ad = fdtdec_get_int(blob, node, "qspi-sfa2ad", (QSPI_FLASH_A2_TOP - QSPI_AMBA_BASE));
-	qspi->sfb1ad = fdtdec_get_int(blob, node, "qspi-sfb1ad", (QSPI_FLASH_B1_TOP - QSPI_AMBA_BASE));
-	qspi->sfb2ad = fdtdec_get_int(blob, node, "qspi-sfb2ad", (QSPI_FLASH_B2_TOP - QSPI_AMBA_BASE));
-
-	qspi->pmuap_reg = fdtdec_get_int(blob, node, "qspi-pmuap-reg", PMUA_QSPI_CLK_RES_CTRL);
-	qspi->max_hz = fdtdec_get_int(blob, node, "spi-max-frequency", k1x_QSPI_DEFAULT_CLK_FREQ);
-	qspi->rxfifo = fdtdec_get_int(blob, node, "qspi-rxbuf", QSPI_RX_BUFF_MAX);
-	qspi->txfifo = fdtdec_get_int(blob, node, "qspi-txfifo", QSPI_TX_BUFF_MAX);
-	qspi->ahb_buf_size = fdtdec_get_int(blob, node, "qspi-ahbbuf", QSPI_AHB_BUFF_MAX_SIZE);
-	qspi->ahb_read_enable = fdtdec_get_int(blob, node, "qspi-ahbread", 1);
-	qspi->endian_xchg = fdtdec_get_int(blob, node, "qspi-little", 0);
+	qspi->qspi_id = dev_read_u32_default(bus, "qspi-id", 0);
+	qspi->sfa1ad = dev_read_u32_default(bus, "qspi-sfa1ad", (QSPI_FLASH_A1_TOP - QSPI_AMBA_BASE));
+	qspi->sfa2ad = dev_read_u32_default(bus, "qspi-sfa2ad", (QSPI_FLASH_A2_TOP - QSPI_AMBA_BASE));
+	qspi->sfb1ad = dev_read_u32_default(bus, "qspi-sfb1ad", (QSPI_FLASH_B1_TOP - QSPI_AMBA_BASE));
+	qspi->sfb2ad = dev_read_u32_default(bus, "qspi-sfb2ad", (QSPI_FLASH_B2_TOP - QSPI_AMBA_BASE));
+
+	qspi->pmuap_reg = dev_read_u32_default(bus, "qspi-pmuap-reg", PMUA_QSPI_CLK_RES_CTRL);
+	qspi->max_hz = dev_read_u32_default(bus, "spi-max-frequency", k1x_QSPI_DEFAULT_CLK_FREQ);
+	qspi->rxfifo = dev_read_u32_default(bus, "qspi-rxbuf", QSPI_RX_BUFF_MAX);
+	qspi->txfifo = dev_read_u32_default(bus, "qspi-txfifo", QSPI_TX_BUFF_MAX);
+	qspi->ahb_buf_size = dev_read_u32_default(bus, "qspi-ahbbuf", QSPI_AHB_BUFF_MAX_SIZE);
+	qspi->ahb_read_enable = dev_read_u32_default(bus, "qspi-ahbread", 1);
+	qspi->endian_xchg = dev_read_u32_default(bus, "qspi-little", 0);
 
 	qspi->cs_selected = QSPI_CS_A1;
 
@@ -8,6 +8,7 @@
 
 #include <common.h>
 #include <command.h>
+#include <console.h>
 #include <cpu_func.h>
 #include <dm.h>
 #include <errno.h>
@@ -58,6 +59,8 @@ int sysreset_walk(enum sysreset_t type)
 	struct udevice *dev;
 	int ret = -ENOSYS;
 
+	/* pending output would be lost in the reset */
+	console_defer_flush();
 	while (ret != -EINPROGRESS && type < SYSRESET_COUNT) {
 		for (uclass_first_device(UCLASS_SYSRESET, &dev);
 		     dev;
@@ -93,6 +93,49 @@ struct pos_info {
  */
 #define POS_HISTORY_SIZE	(CONFIG_SYS_CBSIZE * 11 / 10)
 
+/* Characters which are cached: printable ASCII */
+#define TT_GLYPH_FIRST		' '
+#define TT_GLYPH_COUNT		('~' - TT_GLYPH_FIRST + 1)
+
+/* Number of sub-pixel X positions at which each glyph is cached */
+#define TT_SUBPIXELS		4
+
+/* Sandbox always has the cache code, so that tests can turn it on */
+#define TT_GLYPH_CACHE		(IS_ENABLED(CONFIG_SANDBOX) || \
+				 IS_ENABLED(CONFIG_CONSOLE_TRUETYPE_GLYPH_CACHE))
+
+/**
+ * struct tt_span - Records the part of a glyph row which has any coverage
+ *
+ * @start:	First column with non-zero coverage
+ * @end:	Column after the last one with non-zero coverage, or 0 if the
+ *		row is empty
+ */
+struct tt_span {
+	u16 start;
+	u16 end;
+};
+
+/**
+ * struct tt_glyph - A glyph rendered at a particular sub-pixel position
+ *
+ * @width:	Width of the bitmap in pixels
+ * @height:	Height of the bitmap in pixels
+ * @xoff:	X offset of the bitmap from the cursor position
+ * @yoff:	Y offset of the bitmap from the baseline
+ * @data:	Coverage of each pixel (0-255), @width * @height bytes, or NULL
+ *		if the glyph is empty, e.g. a space
+ * @spans:	Covered part of each row, @height entries
+ */
+struct tt_glyph {
+	int width;
+	int height;
+	int xoff;
+	int yoff;
+	u8 *data;
+	struct tt_span spans[];
+};
+
 /**
  * struct console_tt_priv - Private data for this driver
  *
@@ -112,6 +155,11 @@ struct pos_info {
  * @scale:	Scale of the font. This is calculated from the pixel height
  *		of the font. It is used by the STB library to generate images
  *		of the correct size.
+ * @glyphs:	Cache of rendered glyphs, for each printable ASCII character
+ *		and sub-pixel position. Entries are NULL until first used.
+ * @text_width:	Cache of the bitmap width of each printable ASCII character,
+ *		used to measure strings. -1 if not yet known.
+ * @use_glyphs:	true to draw characters from @glyphs
  */
 struct console_tt_priv {
 	int font_size;
@@ -121,6 +169,9 @@ struct console_tt_priv {
 	int pos_ptr;
 	int baseline;
 	double scale;
+	struct tt_glyph *glyphs[TT_GLYPH_COUNT][TT_SUBPIXELS];
+	s16 text_width[TT_GLYPH_COUNT];
+	bool use_glyphs;
 };
 
 static int console_truetype_set_row(struct udevice *dev, uint row, int clr)
@@ -216,13 +267,40 @@ int console_truetype_fill_rect(struct udevice *dev, int xstart, int ystart, int
 		}
 	}
 
-	int ret = vidconsole_sync_copy(dev, vid_priv->fb + ystart * vid_priv->line_length, vid_priv->fb + (ystart + height) * vid_priv->line_length);
-	if (ret)
-		return ret;
+	video_damage(dev->parent, VID_TO_PIXEL(xstart), ystart, width, height);
 
 	return 0;
 }
 
+/**
+ * console_truetype_text_width() - Get the width of a character's bitmap
+ *
+ * This only works out the bounding box, without rendering the character, and
+ * remembers the result for printable ASCII characters.
+ *
+ * @priv:	Private data
+ * @ch:		Character to measure
+ * Return: width in pixels, or 0 if the character has no bitmap
+ */
+static int console_truetype_text_width(struct console_tt_priv *priv, int ch)
+{
+	int idx = ch - TT_GLYPH_FIRST;
+	int x0, y0, x1, y1;
+	int width;
+
+	if (idx >= 0 && idx < TT_GLYPH_COUNT && priv->text_width[idx] >= 0)
+		return priv->text_width[idx];
+
+	stbtt_GetCodepointBitmapBoxSubpixel(&priv->font, ch, priv->scale,
+					    priv->scale, 0, 0, &x0, &y0, &x1,
+					    &y1);
+	width = x1 > x0 && y1 > y0 ? x1 - x0 : 0;
+	if (idx >= 0 && idx < TT_GLYPH_COUNT)
+		priv->text_width[idx] = width;
+
+	return width;
+}
+
 void calculate_text_dimensions(struct udevice *dev, const char *str, int *text_width, int *text_height) {
 	/* First, check if str is empty */
 	if (!str || *str == '\0') {
@@ -232,8 +310,6 @@ void calculate_text_dimensions(struct udevice *dev, const char *str, int *text_w
 	}
 
 	struct console_tt_priv *priv = dev_get_priv(dev);
-	stbtt_fontinfo *font = &priv->font;
-	double scale = priv->scale;
 	int line_height = priv->font_size;
 
 	*text_width = 0;
@@ -255,13 +331,10 @@ void calculate_text_dimensions(struct udevice *dev, const char *str, int *text_w
 			continue;
 		}
 
-		int width, height, xoff, yoff;
-		/* Get the bitmap for the character to calculate width and height */
-		unsigned char *bitmap = stbtt_GetCodepointBitmapSubpixel(font, scale, scale, 0, 0, *str, &width, &height, &xoff, &yoff);
-		if (bitmap) {
+		int width = console_truetype_text_width(priv, *str);
+		if (width) {
 			/* Add character spacing to the character width */
 			current_line_width += width + char_spacing;
-			stbtt_FreeBitmap(bitmap, NULL);
 		}
 	}
 
@@ -283,18 +356,25 @@ int get_string_dimensions(struct udevice *dev, const char *str, int *width, int
 static int console_truetype_move_rows(struct udevice *dev, uint rowdst,
 				     uint rowsrc, uint count)
 {
+	struct vidconsole_priv *vc_priv = dev_get_uclass_priv(dev);
 	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
 	struct console_tt_priv *priv = dev_get_priv(dev);
 	void *dst;
 	void *src;
 	int i, diff, ret;
 
-	dst = vid_priv->fb + rowdst * priv->font_size * vid_priv->line_length;
-	src = vid_priv->fb + rowsrc * priv->font_size * vid_priv->line_length;
-	ret = vidconsole_memmove(dev, dst, src, priv->font_size *
-				 vid_priv->line_length * count);
-	if (ret)
-		return ret;
+	/* Scrolling the whole console up can be done by the hardware */
+	if (rowdst || rowsrc + count != vc_priv->rows ||
+	    video_scroll(dev->parent, rowsrc * priv->font_size)) {
+		dst = vid_priv->fb +
+			rowdst * priv->font_size * vid_priv->line_length;
+		src = vid_priv->fb +
+			rowsrc * priv->font_size * vid_priv->line_length;
+		ret = vidconsole_memmove(dev, dst, src, priv->font_size *
+					 vid_priv->line_length * count);
+		if (ret)
+			return ret;
+	}
 
 	/* Scroll up our position history */
 	diff = (rowsrc - rowdst) * priv->font_size;
@@ -304,6 +384,212 @@ static int console_truetype_move_rows(struct udevice *dev, uint rowdst,
 	return 0;
 }
 
+/**
+ * console_truetype_get_glyph() - Get a rendered glyph from the cache
+ *
+ * The glyph is rendered and added to the cache if it is not already there.
+ *
+ * @priv:	Private data
+ * @ch:		Character to get
+ * @x_shift:	Sub-pixel X position (0 <= x_shift < 1), which is rounded down
+ *		to the nearest cached position
+ * Return: glyph, or NULL if the character is not cached or there is no
+ *	memory, in which case it must be rendered directly
+ */
+static struct tt_glyph *console_truetype_get_glyph(struct console_tt_priv *priv,
+						   int ch, double x_shift)
+{
+	int idx = ch - TT_GLYPH_FIRST;
+	int sub = min((int)(x_shift * TT_SUBPIXELS), TT_SUBPIXELS - 1);
+	int width, height, xoff, yoff;
+	struct tt_glyph *glyph;
+	int row, col;
+	u8 *data;
+
+	if (idx < 0 || idx >= TT_GLYPH_COUNT)
+		return NULL;
+	glyph = priv->glyphs[idx][sub];
+	if (glyph)
+		return glyph;
+
+	data = stbtt_GetCodepointBitmapSubpixel(&priv->font, priv->scale,
+						priv->scale,
+						(double)sub / TT_SUBPIXELS, 0,
+						ch, &width, &height, &xoff,
+						&yoff);
+	if (!data)
+		width = height = 0;
+	glyph = malloc(sizeof(*glyph) + height * sizeof(struct tt_span));
+	if (!glyph) {
+		free(data);
+		return NULL;
+	}
+	glyph->width = width;
+	glyph->height = height;
+	glyph->xoff = xoff;
+	glyph->yoff = yoff;
+	glyph->data = data;
+
+	/* Record the covered part of each row so that we can skip the rest */
+	for (row = 0; row < height; row++) {
+		struct tt_span *span = &glyph->spans[row];
+		u8 *bits = data + row * width;
+
+		for (col = 0; col < width && !bits[col]; col++)
+			;
+		span->start = col;
+		for (col = width; col > span->start && !bits[col - 1]; col--)
+			;
+		span->end = col;
+	}
+	priv->glyphs[idx][sub] = glyph;
+
+	return glyph;
+}
+
+/* Blend @fg into @dst, where both are xRGB8888 (or xBGR8888) pixels */
+static u32 tt_blend32(u32 dst, u32 fg, uint alpha)
+{
+	u32 rb, ag;
+
+	/* Scale 0-255 to 0-256 so that full coverage gives exactly @fg */
+	alpha += alpha >> 7;
+	rb = ((fg & 0xff00ff) * alpha +
+	      (dst & 0xff00ff) * (256 - alpha)) >> 8;
+	ag = ((fg >> 8 & 0xff00ff) * alpha +
+	      (dst >> 8 & 0xff00ff) * (256 - alpha)) >> 8;
+
+	return (rb & 0xff00ff) | (ag & 0xff00ff) << 8;
+}
+
+/* Blend @fg into @dst, where both are xRGB2101010 pixels */
+static u32 tt_blend30(u32 dst, u32 fg, uint alpha)
+{
+	u32 out = 0;
+	int shift;
+
+	alpha += alpha >> 7;
+	for (shift = 0; shift < 30; shift += 10) {
+		u32 f = fg >> shift & 0x3ff, d = dst >> shift & 0x3ff;
+
+		out |= ((f * alpha + d * (256 - alpha)) >> 8) << shift;
+	}
+
+	return out;
+}
+
+/* Blend @fg into @dst, where both are RGB565 pixels */
+static u16 tt_blend16(u16 dst, u16 fg, uint alpha)
+{
+	uint r, g, b;
+
+	alpha += alpha >> 7;
+	r = ((fg >> 11) * alpha + (dst >> 11) * (256 - alpha)) >> 8;
+	g = ((fg >> 5 & 0x3f) * alpha + (dst >> 5 & 0x3f) * (256 - alpha)) >> 8;
+	b = ((fg & 0x1f) * alpha + (dst & 0x1f) * (256 - alpha)) >> 8;
+
+	return r << 11 | g << 5 | b;
+}
+
+/**
+ * console_truetype_draw_glyph() - Draw a cached glyph into the frame buffer
+ *
+ * Only the covered part of each row is written. Pixels with full coverage are
+ * set to the foreground colour and partly covered pixels are blended with
+ * what is already there, so the glyph is anti-aliased against any
+ * background.
+ *
+ * @dev:	Device to update
+ * @x:		X position in pixels from the left
+ * @y:		Y position of the top of the character cell
+ * @glyph:	Glyph to draw
+ * Return: 0 if OK, -ENOSYS if the display depth is not supported
+ */
+static int console_truetype_draw_glyph(struct udevice *dev, uint x, uint y,
+				       struct tt_glyph *glyph)
+{
+	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
+	struct console_tt_priv *priv = dev_get_priv(dev);
+	bool x2r10 = vid_priv->format == VIDEO_X2R10G10B10;
+	u32 fg = vid_priv->colour_fg;
+	int linenum, row, i;
+	void *line;
+
+	line = vid_priv->fb + y * vid_priv->line_length +
+		x * VNBYTES(vid_priv->bpix);
+	linenum = priv->baseline + glyph->yoff;
+	if (linenum > 0)
+		line += linenum * vid_priv->line_length;
+
+	for (row = 0; row < glyph->height; row++) {
+		const struct tt_span *span = &glyph->spans[row];
+		const u8 *bits = glyph->data + row * glyph->width + span->start;
+		int col = glyph->xoff + span->start;
+		int count = span->end - span->start;
+
+		switch (vid_priv->bpix) {
+#ifdef CONFIG_VIDEO_BPP8
+		case VIDEO_BPP8: {
+			/* A palette index cannot be blended, so just OR/AND */
+			u8 *dst = (u8 *)line + col;
+
+			for (i = 0; i < count; i++, dst++) {
+				int val = *bits++;
+
+				if (vid_priv->colour_bg)
+					val = 255 - val;
+				if (vid_priv->colour_fg)
+					*dst |= val;
+				else
+					*dst &= val;
+			}
+			break;
+		}
+#endif
+#ifdef CONFIG_VIDEO_BPP16
+		case VIDEO_BPP16: {
+			u16 *dst = (u16 *)line + col;
+
+			for (i = 0; i < count; i++, dst++) {
+				uint alpha = *bits++;
+
+				if (alpha == 0xff)
+					*dst = fg;
+				else if (alpha)
+					*dst = tt_blend16(*dst, fg, alpha);
+			}
+			break;
+		}
+#endif
+#ifdef CONFIG_VIDEO_BPP32
+		case VIDEO_BPP32: {
+			u32 *dst = (u32 *)line + col;
+
+			for (i = 0; i < count; i++, dst++) {
+				uint alpha = *bits++;
+
+				if (alpha == 0xff)
+					*dst = fg;
+				else if (alpha && x2r10)
+					*dst = tt_blend30(*dst, fg, alpha);
+				else if (alpha)
+					*dst = tt_blend32(*dst, fg, alpha);
+			}
+			break;
+		}
+#endif
+		default:
+			return -ENOSYS;
+		}
+
+		line += vid_priv->line_length;
+	}
+	video_damage(dev->parent, x + glyph->xoff, y + max(linenum, 0),
+		     glyph->width, glyph->height);
+
+	return 0;
+}
+
 static int console_truetype_putc_xy(struct udevice *dev, uint x, uint y,
 				    char ch)
 {
@@ -320,7 +606,7 @@ static int console_truetype_putc_xy(struct udevice *dev, uint x, uint y,
 	u8 *bits, *data;
 	int advance;
 	void *start, *end, *line;
-	int row, ret;
+	int row;
 
 	/* First get some basic metrics about this character */
 	stbtt_GetCodepointHMetrics(font, ch, &advance, &lsb);
@@ -355,6 +641,23 @@ static int console_truetype_putc_xy(struct udevice *dev, uint x, uint y,
 		priv->pos_ptr++;
 	}
 
+	if (TT_GLYPH_CACHE && priv->use_glyphs) {
+		struct tt_glyph *glyph;
+		int ret;
+
+		glyph = console_truetype_get_glyph(priv, ch, x_shift);
+		if (glyph) {
+			if (!glyph->data)
+				return width_frac;
+			ret = console_truetype_draw_glyph(dev, VID_TO_PIXEL(x),
+							  y, glyph);
+			if (ret)
+				return ret;
+
+			return width_frac;
+		}
+	}
+
 	/*
 	 * Figure out how much past the start of a pixel we are, and pass this
 	 * information into the render, which will return a 8-bit-per-pixel
@@ -457,9 +760,8 @@ static int console_truetype_putc_xy(struct udevice *dev, uint x, uint y,
 
 		line += vid_priv->line_length;
 	}
-	ret = vidconsole_sync_copy(dev, start, line);
-	if (ret)
-		return ret;
+	video_damage(vid, VID_TO_PIXEL(x) + xoff, y + max(linenum, 0), width,
+		     height);
 	free(data);
 
 	return width_frac;
@@ -485,7 +787,7 @@ static int console_truetype_erase(struct udevice *dev, int xstart, int ystart,
 	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
 	void *start, *line;
 	int pixels = xend - xstart;
-	int row, i, ret;
+	int row, i;
 
 	start = vid_priv->fb + ystart * vid_priv->line_length;
 	start += xstart * VNBYTES(vid_priv->bpix);
@@ -524,9 +826,7 @@ static int console_truetype_erase(struct udevice *dev, int xstart, int ystart,
 		}
 		line += vid_priv->line_length;
 	}
-	ret = vidconsole_sync_copy(dev, start, line);
-	if (ret)
-		return ret;
+	video_damage(dev->parent, xstart, ystart, pixels, yend - ystart);
 
 	return 0;
 }
@@ -698,11 +998,39 @@ static int console_truetype_probe(struct udevice *dev)
 	priv->scale = stbtt_ScaleForPixelHeight(font, priv->font_size);
 	stbtt_GetFontVMetrics(font, &ascent, 0, 0);
 	priv->baseline = (int)(ascent * priv->scale);
+	memset(priv->text_width, 0xff, sizeof(priv->text_width));
+	priv->use_glyphs = IS_ENABLED(CONFIG_CONSOLE_TRUETYPE_GLYPH_CACHE);
 	debug("%s: ready\n", __func__);
 
 	return 0;
 }
 
+void console_truetype_set_glyph_cache(struct udevice *dev, bool enable)
+{
+	struct console_tt_priv *priv = dev_get_priv(dev);
+
+	priv->use_glyphs = TT_GLYPH_CACHE && enable;
+}
+
+static int console_truetype_remove(struct udevice *dev)
+{
+	struct console_tt_priv *priv = dev_get_priv(dev);
+	int i, j;
+
+	for (i = 0; i < TT_GLYPH_COUNT; i++) {
+		for (j = 0; j < TT_SUBPIXELS; j++) {
+			struct tt_glyph *glyph = priv->glyphs[i][j];
+
+			if (glyph) {
+				free(glyph->data);
+				free(glyph);
+			}
+		}
+	}
+
+	return 0;
+}
+
 struct vidconsole_ops console_truetype_ops = {
 	.putc_xy	= console_truetype_putc_xy,
 	.move_rows	= console_truetype_move_rows,
@@ -716,5 +1044,6 @@ U_BOOT_DRIVER(vidconsole_truetype) = {
 	.id	= UCLASS_VIDEO_CONSOLE,
 	.ops	= &console_truetype_ops,
 	.probe	= console_truetype_probe,
+	.remove	= console_truetype_remove,
 	.priv_auto	= sizeof(struct console_tt_priv),
 };
@@ -223,7 +223,7 @@ static int spacemit_display_init(struct udevice *dev, ulong fbbase, ofnode ep_no
 {
 	// struct video_uc_plat *uc_plat = dev_get_uclass_plat(dev);
 	struct video_priv *uc_priv = dev_get_uclass_priv(dev);
-	// struct spacemit_dpu_priv *priv = dev_get_priv(dev);
+	struct spacemit_dpu_priv *priv = dev_get_priv(dev);
 	struct display_timing timing;
 	int dpu_id, remote_dpu_id;
 	struct udevice *disp;
@@ -315,6 +315,7 @@ static int spacemit_display_init(struct udevice *dev, ulong fbbase, ofnode ep_no
 		flush_cache(fbbase, uc_priv->xsize * uc_priv->ysize * VNBYTES(uc_priv->bpix));
 
 		hdmi_dpu_init(&hdmi_1080p_modeinfo, fbbase);
+		priv->mode = DPU_MODE_HDMI;
 
 		return 0;
 	} else if (dpu_id == DPU_MODE_MIPI) {
@@ -423,7 +424,9 @@ static int spacemit_display_init(struct udevice *dev, ulong fbbase, ofnode ep_no
 
 		} else {
 			pr_info("%s: Failed to find panel\n", __func__);
+			return 0;
 		}
+		priv->mode = DPU_MODE_MIPI;
 
 		return 0;
 	}
@@ -447,6 +450,8 @@ static int spacemit_dpu_probe(struct udevice *dev)
 	if (!priv->regs_hdmi)
 		return -EINVAL;
 
+	priv->mode = -1;
+
 	port = dev_read_subnode(dev, "port");
 	if (!ofnode_valid(port)) {
 		pr_info("%s(%s): 'port' subnode not found\n",
@@ -514,7 +519,41 @@ static const struct udevice_id spacemit_dc_ids[] = {
 	{ }
 };
 
+/*
+ * Point the layer at a new frame-buffer address. This is used by the video
+ * uclass to scroll the console without copying the frame buffer. As in the
+ * init sequence, the new address only takes effect once it is committed
+ * through 0x56c/0x58c.
+ */
+static int __maybe_unused spacemit_dpu_set_base(struct udevice *dev, void *fb)
+{
+	struct spacemit_dpu_priv *priv = dev_get_priv(dev);
+	ulong fbbase = (ulong)fb;
+
+	switch (priv->mode) {
+	case DPU_MODE_HDMI:
+		hdmi_dpu_write((void __iomem *)0xda0, (unsigned int)(fbbase & 0xffffffff));
+		hdmi_dpu_write((void __iomem *)0xda4, (unsigned int)(fbbase >> 32));
+		hdmi_dpu_write((void __iomem *)0x56c, 0x1);
+		hdmi_dpu_write((void __iomem *)0x58c, 0x1);
+		break;
+	case DPU_MODE_MIPI:
+		dsi_dpu_write((void __iomem *)0xda0, (unsigned int)(fbbase & 0xffffffff));
+		dsi_dpu_write((void __iomem *)0xda4, (unsigned int)(fbbase >> 32));
+		dsi_dpu_write((void __iomem *)0x56c, 0x1);
+		dsi_dpu_write((void __iomem *)0x58c, 0x1);
+		break;
+	default:
+		return -ENODEV;
+	}
+
+	return 0;
+}
+
 static const struct video_ops spacemit_dpu_ops = {
+#if IS_ENABLED(CONFIG_VIDEO_SPACEMIT_HW_SCROLL)
+	.set_base = spacemit_dpu_set_base,
+#endif
 };
 
 int spacemit_dpu_bind(struct udevice *dev)
@@ -525,6 +564,9 @@ int spacemit_dpu_bind(struct udevice *dev)
 
 	plat->size = 4 * (CONFIG_VIDEO_SPACEMIT_MAX_XRES *
 			  CONFIG_VIDEO_SPACEMIT_MAX_YRES);
+	/* Leave a second screen of memory for the display to scroll into */
+	if (IS_ENABLED(CONFIG_VIDEO_SPACEMIT_HW_SCROLL))
+		plat->size *= 2;
 
 	return 0;
 }
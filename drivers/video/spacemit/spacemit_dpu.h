@@ -46,6 +46,7 @@ struct fb_info {
 struct spacemit_dpu_priv {
 	void __iomem *regs_dsi;
 	void __iomem *regs_hdmi;
+	int mode;	/* enum dpu_modes of the active output, -1 if none */
 	struct udevice *conn_dev;
 	struct display_timing timing;
 };
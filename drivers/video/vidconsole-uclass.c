@@ -571,10 +571,15 @@ int vidconsole_put_char(struct udevice *dev, char ch)
 		if (ret < 0)
 			return ret;
 
-		void *start = vid_priv->fb + priv->ycur * vid_priv->line_length;
-		void *end = start + vid_priv->line_length;
-
-		flush_dcache_range((unsigned long)start, (unsigned long)end);
+		/* With damage tracking, video_sync() flushes the glyph */
+		if (!IS_ENABLED(CONFIG_VIDEO_DAMAGE)) {
+			void *start = vid_priv->fb +
+				      priv->ycur * vid_priv->line_length;
+			void *end = start + vid_priv->line_length;
+
+			flush_dcache_range((unsigned long)start,
+					   (unsigned long)end);
+		}
 		break;
 	}
 
@@ -607,10 +612,12 @@ int vidconsole_put_string(struct udevice *dev, const char *str)
 		if (ret)
 			return ret;
 	}
-	void *start = vid_priv->fb;
-	void *end = start + vid_priv->fb_size;
+	if (!IS_ENABLED(CONFIG_VIDEO_DAMAGE)) {
+		void *start = vid_priv->fb;
+		void *end = start + vid_priv->fb_size;
 
-	flush_dcache_range((unsigned long)start, (unsigned long)end);
+		flush_dcache_range((unsigned long)start, (unsigned long)end);
+	}
 	return 0;
 }
 
@@ -675,6 +682,7 @@ void clear_screen_colour_bg(struct udevice *dev) {
 				break;
 		}
 	}
+	video_damage(dev->parent, xstart, ystart, width, height);
 
 	/* Ensure the changes are written to the frame buffer */
 	video_sync(dev->parent, false);
@@ -782,7 +790,7 @@ UCLASS_DRIVER(vidconsole) = {
 	.per_device_auto	= sizeof(struct vidconsole_priv),
 };
 
-#ifdef CONFIG_VIDEO_COPY
+#if defined(CONFIG_VIDEO_COPY) || defined(CONFIG_VIDEO_DAMAGE)
 int vidconsole_sync_copy(struct udevice *dev, void *from, void *to)
 {
 	struct udevice *vid = dev_get_parent(dev);
@@ -120,16 +120,14 @@ int video_reserve(ulong *addrp)
 	return 0;
 }
 
-int video_clear(struct udevice *dev)
+/* Fill @size bytes of the frame buffer at @line with the background colour */
+static void video_fill_bg(struct video_priv *priv, void *line, int size)
 {
-	struct video_priv *priv = dev_get_uclass_priv(dev);
-	int ret;
-
 	switch (priv->bpix) {
 	case VIDEO_BPP16:
 		if (IS_ENABLED(CONFIG_VIDEO_BPP16)) {
-			u16 *ppix = priv->fb;
-			u16 *end = priv->fb + priv->fb_size;
+			u16 *ppix = line;
+			u16 *end = line + size;
 
 			while (ppix < end)
 				*ppix++ = priv->colour_bg;
@@ -137,22 +135,77 @@ int video_clear(struct udevice *dev)
 		}
 	case VIDEO_BPP32:
 		if (IS_ENABLED(CONFIG_VIDEO_BPP32)) {
-			u32 *ppix = priv->fb;
-			u32 *end = priv->fb + priv->fb_size;
+			u32 *ppix = line;
+			u32 *end = line + size;
 
 			while (ppix < end)
 				*ppix++ = priv->colour_bg;
 			break;
 		}
 	default:
-		memset(priv->fb, priv->colour_bg, priv->fb_size);
+		memset(line, priv->colour_bg, size);
 		break;
 	}
-	ret = video_sync_copy(dev, priv->fb, priv->fb + priv->fb_size);
+}
+
+int video_clear(struct udevice *dev)
+{
+	struct video_priv *priv = dev_get_uclass_priv(dev);
+	bool rewind = priv->scroll_base && priv->fb != priv->scroll_base;
+	int ret;
+
+	/* A cleared display can scan out from the start of the memory again */
+	if (rewind)
+		priv->fb = priv->scroll_base;
+	video_fill_bg(priv, priv->fb, priv->fb_size);
+	video_damage(dev, 0, 0, priv->xsize, priv->ysize);
+
+	ret = video_sync(dev, false);
+	if (ret)
+		return ret;
+	if (rewind)
+		return video_get_ops(dev)->set_base(dev, priv->fb);
+
+	return 0;
+}
+
+int video_scroll(struct udevice *vid, int lines)
+{
+	struct video_priv *priv = dev_get_uclass_priv(vid);
+	int size = lines * priv->line_length;
+	bool wrap;
+	void *fb;
+	int ret;
+
+	if (!priv->scroll_base)
+		return -ENOSYS;
+	if (lines <= 0 || lines >= priv->ysize)
+		return -EINVAL;
+
+	/* Pending damage is relative to the old position, so sync it first */
+	ret = video_sync(vid, false);
+	if (ret)
+		return ret;
+
+	fb = priv->fb + size;
+	wrap = fb + priv->fb_size > priv->scroll_base + priv->scroll_size;
+	if (wrap) {
+		/* Out of room, so move what stays visible back to the start */
+		fb = priv->scroll_base;
+		memmove(fb, priv->fb + size, priv->fb_size - size);
+	}
+	priv->fb = fb;
+	video_fill_bg(priv, fb + priv->fb_size - size, size);
+
+	if (wrap)
+		video_damage(vid, 0, 0, priv->xsize, priv->ysize);
+	else
+		video_damage(vid, 0, priv->ysize - lines, priv->xsize, lines);
+	ret = video_sync(vid, true);
 	if (ret)
 		return ret;
 
-	return video_sync(dev, false);
+	return video_get_ops(vid)->set_base(vid, fb);
 }
 
 void video_set_default_colors(struct udevice *dev, bool invert)
@@ -181,10 +234,105 @@ void video_set_default_colors(struct udevice *dev, bool invert)
 	priv->colour_bg = vid_console_color(priv, back);
 }
 
+/* Flush a range of the frame buffer out of the data cache */
+static void video_flush_range(ulong start, ulong end)
+{
+	/*
+	 * flush_dcache_range() is declared in common.h but it seems that some
+	 * architectures do not actually implement it. Is there a way to find
+	 * out whether it exists? For now, ARM and RISC-V are safe.
+	 */
+#if defined(CONFIG_ARM) && !CONFIG_IS_ENABLED(SYS_DCACHE_OFF)
+	flush_dcache_range(round_down(start, CONFIG_SYS_CACHELINE_SIZE),
+			   ALIGN(end, CONFIG_SYS_CACHELINE_SIZE));
+#elif defined(CONFIG_RISCV) && !CONFIG_IS_ENABLED(SYS_DCACHE_OFF)
+	flush_dcache_range(round_down(start, CONFIG_RISCV_CBOM_BLOCK_SIZE),
+			   round_up(end, CONFIG_RISCV_CBOM_BLOCK_SIZE));
+#endif
+}
+
+static void video_reset_damage(struct video_priv *priv)
+{
+	priv->damage.xstart = priv->xsize;
+	priv->damage.ystart = priv->ysize;
+	priv->damage.xend = 0;
+	priv->damage.yend = 0;
+}
+
+void video_damage(struct udevice *vid, int x, int y, int width, int height)
+{
+	struct video_priv *priv = dev_get_uclass_priv(vid);
+	int xend = x + width;
+	int yend = y + height;
+
+	x = max(x, 0);
+	y = max(y, 0);
+	xend = min_t(int, xend, priv->xsize);
+	yend = min_t(int, yend, priv->ysize);
+	if (xend <= x || yend <= y)
+		return;
+
+	if (IS_ENABLED(CONFIG_VIDEO_DAMAGE)) {
+		struct video_damage *damage = &priv->damage;
+
+		damage->xstart = min(damage->xstart, x);
+		damage->ystart = min(damage->ystart, y);
+		damage->xend = max(damage->xend, xend);
+		damage->yend = max(damage->yend, yend);
+	} else {
+		void *start = priv->fb + y * priv->line_length +
+			      x * VNBYTES(priv->bpix);
+		void *end = priv->fb + (yend - 1) * priv->line_length +
+			    xend * VNBYTES(priv->bpix);
+
+		video_sync_copy(vid, start, end);
+	}
+}
+
+/*
+ * Copy the damaged region to the copy frame buffer and flush it from the
+ * cache, then start a new (empty) damage region for the next frame
+ */
+static void video_sync_damage(struct video_priv *priv)
+{
+	struct video_damage *damage = &priv->damage;
+	void *scanout = priv->copy_fb ? priv->copy_fb : priv->fb;
+	ulong offset, len;
+	int y;
+
+	if (damage->xend <= damage->xstart || damage->yend <= damage->ystart)
+		return;
+
+	offset = damage->ystart * priv->line_length +
+		 damage->xstart * VNBYTES(priv->bpix);
+	if (!damage->xstart && damage->xend == priv->xsize) {
+		/* Whole lines are damaged, so handle them as one range */
+		len = (damage->yend - damage->ystart) * priv->line_length;
+		if (priv->copy_fb)
+			memcpy(priv->copy_fb + offset, priv->fb + offset, len);
+		if (priv->flush_dcache)
+			video_flush_range((ulong)scanout + offset,
+					  (ulong)scanout + offset + len);
+	} else {
+		len = (damage->xend - damage->xstart) * VNBYTES(priv->bpix);
+		for (y = damage->ystart; y < damage->yend; y++) {
+			if (priv->copy_fb)
+				memcpy(priv->copy_fb + offset,
+				       priv->fb + offset, len);
+			if (priv->flush_dcache)
+				video_flush_range((ulong)scanout + offset,
+						  (ulong)scanout + offset + len);
+			offset += priv->line_length;
+		}
+	}
+	video_reset_damage(priv);
+}
+
 /* Flush video activity to the caches */
 int video_sync(struct udevice *vid, bool force)
 {
 	struct video_ops *ops = video_get_ops(vid);
+	struct video_priv *priv = dev_get_uclass_priv(vid);
 	int ret;
 
 	if (ops && ops->video_sync) {
@@ -193,35 +341,19 @@ int video_sync(struct udevice *vid, bool force)
 			return ret;
 	}
 
-	/*
-	 * flush_dcache_range() is declared in common.h but it seems that some
-	 * architectures do not actually implement it. Is there a way to find
-	 * out whether it exists? For now, ARM is safe.
-	 */
-#if defined(CONFIG_ARM) && !CONFIG_IS_ENABLED(SYS_DCACHE_OFF)
-	struct video_priv *priv = dev_get_uclass_priv(vid);
+	if (IS_ENABLED(CONFIG_VIDEO_DAMAGE))
+		video_sync_damage(priv);
+	else if (priv->flush_dcache)
+		video_flush_range((ulong)priv->fb,
+				  (ulong)priv->fb + priv->fb_size);
 
-	if (priv->flush_dcache) {
-		flush_dcache_range((ulong)priv->fb,
-				   ALIGN((ulong)priv->fb + priv->fb_size,
-					 CONFIG_SYS_CACHELINE_SIZE));
-	}
-#elif defined(CONFIG_VIDEO_SANDBOX_SDL)
-	struct video_priv *priv = dev_get_uclass_priv(vid);
+#if defined(CONFIG_VIDEO_SANDBOX_SDL)
 	static ulong last_sync;
 
 	if (force || get_timer(last_sync) > 100) {
 		sandbox_sdl_sync(priv->fb);
 		last_sync = get_timer(0);
 	}
-#elif defined(CONFIG_RISCV) && !CONFIG_IS_ENABLED(SYS_DCACHE_OFF)
-	struct video_priv *priv = dev_get_uclass_priv(vid);
-
-	if (priv->flush_dcache) {
-		ulong flush_dcache_addr = round_down((ulong)priv->fb, CONFIG_RISCV_CBOM_BLOCK_SIZE);
-		ulong flush_length = round_up((ulong)priv->fb + priv->fb_size - flush_dcache_addr, CONFIG_RISCV_CBOM_BLOCK_SIZE);
-		flush_dcache_range(flush_dcache_addr, flush_dcache_addr + flush_length);
-	}
 #endif
 	return 0;
 }
@@ -270,12 +402,12 @@ int video_get_ysize(struct udevice *dev)
 	return priv->ysize;
 }
 
-#ifdef CONFIG_VIDEO_COPY
+#if defined(CONFIG_VIDEO_COPY) || defined(CONFIG_VIDEO_DAMAGE)
 int video_sync_copy(struct udevice *dev, void *from, void *to)
 {
 	struct video_priv *priv = dev_get_uclass_priv(dev);
 
-	if (priv->copy_fb) {
+	if (priv->copy_fb || IS_ENABLED(CONFIG_VIDEO_DAMAGE)) {
 		long offset, size;
 
 		/* Find the offset of the first byte to copy */
@@ -316,6 +448,16 @@ int video_sync_copy(struct udevice *dev, void *from, void *to)
 			offset = 0;
 		}
 
+		if (IS_ENABLED(CONFIG_VIDEO_DAMAGE)) {
+			int ystart = offset / priv->line_length;
+			int yend = DIV_ROUND_UP(offset + size,
+						priv->line_length);
+
+			video_damage(dev, 0, ystart, priv->xsize,
+				     yend - ystart);
+			return 0;
+		}
+
 		memcpy(priv->copy_fb + offset, priv->fb + offset, size);
 	}
 
@@ -357,6 +499,7 @@ static int video_post_probe(struct udevice *dev)
 {
 	struct video_uc_plat *plat = dev_get_uclass_plat(dev);
 	struct video_priv *priv = dev_get_uclass_priv(dev);
+	struct video_ops *ops;
 	char name[30], drv[15], *str;
 	const char *drv_name = drv;
 	struct udevice *cons;
@@ -371,6 +514,19 @@ static int video_post_probe(struct udevice *dev)
 
 	if (IS_ENABLED(CONFIG_VIDEO_COPY) && plat->copy_base)
 		priv->copy_fb = map_sysmem(plat->copy_base, plat->size);
+	video_reset_damage(priv);
+
+	/*
+	 * Scroll in hardware if the driver can move the scan-out address and
+	 * has allocated room for it. This cannot work with a copy frame buffer
+	 * since the copy is what the hardware displays.
+	 */
+	ops = video_get_ops(dev);
+	if (ops && ops->set_base && !priv->copy_fb &&
+	    plat->size >= 2 * priv->fb_size) {
+		priv->scroll_base = priv->fb;
+		priv->scroll_size = plat->size;
+	}
 
 	/* Set up colors  */
 	video_set_default_colors(dev, false);
@@ -200,21 +200,8 @@ static void video_display_rle8_bitmap(struct udevice *dev,
 	}
 }
 
-/**
- * video_splash_align_axis() - Align a single coordinate
- *
- *- if a coordinate is 0x7fff then the image will be centred in
- *  that direction
- *- if a coordinate is -ve then it will be offset to the
- *  left/top of the centre by that many pixels
- *- if a coordinate is positive it will be used unchnaged.
- *
- * @axis:	Input and output coordinate
- * @panel_size:	Size of panel in pixels for that axis
- * @picture_size:	Size of bitmap in pixels for that axis
- */
-static void video_splash_align_axis(int *axis, unsigned long panel_size,
-				    unsigned long picture_size)
+void video_splash_align_axis(int *axis, unsigned long panel_size,
+			     unsigned long picture_size)
 {
 	long panel_picture_delta = panel_size - picture_size;
 	long axis_alignment;
@@ -244,7 +231,6 @@ int video_bmp_display(struct udevice *dev, ulong bmp_image, int x, int y,
 	enum video_format eformat;
 	struct bmp_color_table_entry *palette;
 	int hdr_size;
-	int ret;
 
 	if (!bmp || !(bmp->header.signature[0] == 'B' &&
 	    bmp->header.signature[1] == 'M')) {
@@ -416,11 +402,7 @@ int video_bmp_display(struct udevice *dev, ulong bmp_image, int x, int y,
 		break;
 	};
 
-	/* Find the position of the top left of the image in the framebuffer */
-	fb = (uchar *)(priv->fb + y * priv->line_length + x * bpix / 8);
-	ret = video_sync_copy(dev, start, fb);
-	if (ret)
-		return log_ret(ret);
+	video_damage(dev, x, y, width, height);
 
 	return video_sync(dev, false);
 }
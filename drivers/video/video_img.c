@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Display of pre-converted (and optionally LZ4-compressed) splash images
+ *
+ * See include/video_img.h for the layout and tools/mkvideoimg.py for how to
+ * create the images.
+ */
+
+#define LOG_CATEGORY UCLASS_VIDEO
+
+#include <common.h>
+#include <dm.h>
+#include <log.h>
+#include <malloc.h>
+#include <mapmem.h>
+#include <video.h>
+#include <video_img.h>
+#include <asm/unaligned.h>
+#include <u-boot/lz4.h>
+
+bool video_img_valid(ulong img_addr)
+{
+	struct video_img_header *hdr = map_sysmem(img_addr, 0);
+
+	return !memcmp(hdr->magic, VIDEO_IMG_MAGIC, VIDEO_IMG_MAGIC_LEN) &&
+		get_unaligned_le32(&hdr->hdr_size) >= sizeof(*hdr);
+}
+
+/* Check that the image can be copied to the display without conversion */
+static bool video_img_format_ok(struct video_priv *priv,
+				struct video_img_header *hdr)
+{
+	enum video_format fmt = priv->format;
+
+	if (hdr->bpix != priv->bpix)
+		return false;
+	if (priv->bpix != VIDEO_BPP32)
+		return true;
+
+	/* As with BMP files, 32bpp displays default to X8R8G8B8 */
+	if (fmt == VIDEO_UNKNOWN)
+		fmt = VIDEO_X8R8G8B8;
+
+	return hdr->format == fmt;
+}
+
+int video_img_display(struct udevice *dev, ulong img_addr, int x, int y,
+		      bool align)
+{
+	struct video_priv *priv = dev_get_uclass_priv(dev);
+	struct video_img_header *hdr = map_sysmem(img_addr, 0);
+	ulong width, height, row_size, size, data_size;
+	int bytes = VNBYTES(priv->bpix);
+	void *data, *buf = NULL;
+	const void *src;
+	int row, rows, copy;
+	size_t len;
+	int ret;
+
+	if (!video_img_valid(img_addr))
+		return log_msg_ret("hdr", -EINVAL);
+
+	width = get_unaligned_le16(&hdr->width);
+	height = get_unaligned_le16(&hdr->height);
+	data = (void *)hdr + get_unaligned_le32(&hdr->hdr_size);
+	data_size = get_unaligned_le32(&hdr->data_size);
+	if (!video_img_format_ok(priv, hdr)) {
+		printf("Error: image is %d bit/pixel, display is %d bit/pixel\n",
+		       1 << hdr->bpix, 1 << priv->bpix);
+		return -EPROTONOSUPPORT;
+	}
+
+	if (align) {
+		video_splash_align_axis(&x, priv->xsize, width);
+		video_splash_align_axis(&y, priv->ysize, height);
+	}
+	if (x < 0 || y < 0 || x >= priv->xsize || y >= priv->ysize)
+		return log_msg_ret("pos", -EINVAL);
+
+	row_size = width * bytes;
+	size = row_size * height;
+	copy = min_t(ulong, width, priv->xsize - x) * bytes;
+	rows = min_t(ulong, height, priv->ysize - y);
+
+	switch (hdr->comp) {
+	case VIDEO_IMG_COMP_NONE:
+		if (data_size < size)
+			return log_msg_ret("size", -EINVAL);
+		src = data;
+		break;
+	case VIDEO_IMG_COMP_LZ4:
+		len = size;
+
+		/*
+		 * A full-width image covers consecutive frame-buffer lines, so
+		 * decompress it there directly
+		 */
+		if (!x && row_size == priv->line_length && rows == height) {
+			ret = ulz4fn(data, data_size,
+				     priv->fb + y * priv->line_length, &len);
+			if (ret)
+				return log_msg_ret("lz4", ret);
+			if (len != size)
+				return log_msg_ret("len", -EINVAL);
+			goto done;
+		}
+
+		buf = malloc(size);
+		if (!buf)
+			return log_msg_ret("buf", -ENOMEM);
+		ret = ulz4fn(data, data_size, buf, &len);
+		if (!ret && len != size)
+			ret = -EINVAL;
+		if (ret) {
+			free(buf);
+			return log_msg_ret("lz4", ret);
+		}
+		src = buf;
+		break;
+	default:
+		return log_msg_ret("comp", -EPROTONOSUPPORT);
+	}
+
+	/* Write whole rows so that the frame buffer is filled sequentially */
+	for (row = 0; row < rows; row++) {
+		memcpy(priv->fb + (y + row) * priv->line_length + x * bytes,
+		       src + row * row_size, copy);
+	}
+	free(buf);
+done:
+	video_damage(dev, x, y, width, rows);
+
+	return video_sync(dev, false);
+}
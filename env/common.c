@@ -105,6 +105,39 @@ int eth_env_set_enetaddr(const char *name, const uint8_t *enetaddr)
 	return env_set(name, buf);
 }
 
+/* Find the value of a variable in a linear (var=value\0...\0\0) environment */
+static const char *env_find_in_linear(const char *env, const char *name)
+{
+	const char *p, *end;
+	size_t name_len;
+
+	if (name == NULL || *name == '\0')
+		return NULL;
+
+	name_len = strlen(name);
+
+	for (p = env; *p != '\0'; p = end + 1) {
+		for (end = p; *end != '\0'; ++end)
+			if (end - env >= CONFIG_ENV_SIZE)
+				return NULL;
+
+		if (strncmp(name, p, name_len) || p[name_len] != '=')
+			continue;
+
+		return &p[name_len + 1];
+	}
+
+	return NULL;
+}
+
+static const char *env_get_linear(void)
+{
+	if (gd->env_valid == ENV_INVALID)
+		return default_environment;
+
+	return (const char *)gd->env_addr;
+}
+
 /*
  * Look up variable from environment,
  * return address of storage for that variable,
@@ -124,6 +157,10 @@ char *env_get(const char *name)
 		return ep ? ep->data : NULL;
 	}
 
+	/* read-only view: point straight into the environment */
+	if (CONFIG_IS_ENABLED(ENV_VIEW))
+		return (char *)env_find_in_linear(env_get_linear(), name);
+
 	/* restricted capabilities before import */
 	if (env_get_f(name, (char *)(gd->env_buf), sizeof(gd->env_buf)) >= 0)
 		return (char *)(gd->env_buf);
@@ -152,39 +189,23 @@ char *from_env(const char *envvar)
 static int env_get_from_linear(const char *env, const char *name, char *buf,
 			       unsigned len)
 {
-	const char *p, *end;
-	size_t name_len;
+	const char *value;
+	unsigned res;
 
-	if (name == NULL || *name == '\0')
+	value = env_find_in_linear(env, name);
+	if (!value)
 		return -1;
 
-	name_len = strlen(name);
+	res = strlen(value);
+	memcpy(buf, value, min(len, res + 1));
 
-	for (p = env; *p != '\0'; p = end + 1) {
-		const char *value;
-		unsigned res;
-
-		for (end = p; *end != '\0'; ++end)
-			if (end - env >= CONFIG_ENV_SIZE)
-				return -1;
-
-		if (strncmp(name, p, name_len) || p[name_len] != '=')
-			continue;
-		value = &p[name_len + 1];
-
-		res = end - value;
-		memcpy(buf, value, min(len, res + 1));
-
-		if (len <= res) {
-			buf[len - 1] = '\0';
-			pr_err("env_buf [%u bytes] too small for value of \"%s\"\n",
-			       len, name);
-		}
-
-		return res;
+	if (len <= res) {
+		buf[len - 1] = '\0';
+		pr_err("env_buf [%u bytes] too small for value of \"%s\"\n",
+		       len, name);
 	}
 
-	return -1;
+	return res;
 }
 
 /*
@@ -192,14 +213,7 @@ static int env_get_from_linear(const char *env, const char *name, char *buf,
  */
 int env_get_f(const char *name, char *buf, unsigned len)
 {
-	const char *env;
-
-	if (gd->env_valid == ENV_INVALID)
-		env = default_environment;
-	else
-		env = (const char *)gd->env_addr;
-
-	return env_get_from_linear(env, name, buf, len);
+	return env_get_from_linear(env_get_linear(), name, buf, len);
 }
 
 /**
@@ -267,6 +281,12 @@ void env_set_default(const char *s, int flags)
 		debug("Using default environment\n");
 	}
 
+	if (CONFIG_IS_ENABLED(ENV_VIEW)) {
+		gd->env_valid = ENV_INVALID;
+		gd->flags |= GD_FLG_ENV_DEFAULT;
+		return;
+	}
+
 	flags |= H_DEFAULT;
 	if (himport_r(&env_htab, default_environment,
 			sizeof(default_environment), '\0', flags, 0,
@@ -294,6 +314,32 @@ int env_set_default_vars(int nvars, char * const vars[], int flags)
 				flags, 0, nvars, vars);
 }
 
+/*
+ * Keep a copy of the environment data for env_get() to look variables up in,
+ * instead of importing it into the hash table.
+ */
+static int env_import_view(const env_t *ep)
+{
+	static char *view;
+
+	if (!view) {
+		view = malloc(ENV_SIZE);
+		if (!view)
+			return -ENOMEM;
+	}
+	memcpy(view, ep->data, ENV_SIZE);
+	/* make sure that a lookup cannot run off the end */
+	view[ENV_SIZE - 2] = '\0';
+	view[ENV_SIZE - 1] = '\0';
+
+	gd->env_addr = (ulong)view;
+	if (gd->env_valid == ENV_INVALID)
+		gd->env_valid = ENV_VALID;
+	gd->flags &= ~GD_FLG_ENV_DEFAULT;
+
+	return 0;
+}
+
 /*
  * Check if CRC is valid and (if yes) import the environment.
  * Note that "buf" may or may not be aligned.
@@ -313,6 +359,9 @@ int env_import(const char *buf, int check, int flags)
 		}
 	}
 
+	if (CONFIG_IS_ENABLED(ENV_VIEW))
+		return env_import_view(ep);
+
 	if (himport_r(&env_htab, (char *)ep->data, ENV_SIZE, '\0', flags, 0,
 			0, NULL)) {
 		gd->flags |= GD_FLG_ENV_READY;
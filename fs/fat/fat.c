@@ -22,6 +22,7 @@
 #include <asm/cache.h>
 #include <linux/compiler.h>
 #include <linux/ctype.h>
+#include <linux/math64.h>
 
 /*
  * Convert a string to lowercase.  Converts at most 'len' characters,
@@ -58,10 +59,13 @@ static int disk_read(__u32 block, __u32 nr_blocks, void *buf)
 	return ret;
 }
 
+static void forget_extent_map(void);
+
 int fat_set_blk_dev(struct blk_desc *dev_desc, struct disk_partition *info)
 {
 	ALLOC_CACHE_ALIGN_BUFFER(unsigned char, buffer, dev_desc->blksz);
 
+	forget_extent_map();
 	cur_dev = dev_desc;
 	cur_part_info = *info;
 
@@ -147,6 +151,7 @@ static void get_name(dir_entry *dirent, char *s_name)
 }
 
 static int flush_dirty_fat_buffer(fsdata *mydata);
+static int flush_fat_window(fsdata *mydata, int slot);
 
 #if !CONFIG_IS_ENABLED(FAT_WRITE)
 /* Stub for read only operation */
@@ -155,8 +160,81 @@ int flush_dirty_fat_buffer(fsdata *mydata)
 	(void)(mydata);
 	return 0;
 }
+
+/* Stub for read only operation */
+static int flush_fat_window(fsdata *mydata, int slot)
+{
+	(void)(mydata);
+	(void)(slot);
+	return 0;
+}
 #endif
 
+/*
+ * Allocate the FAT cache of 'mydata', with no FAT window loaded.
+ * Return 0 on success, -1 otherwise.
+ */
+static int alloc_fat_cache(fsdata *mydata)
+{
+	int i;
+
+	mydata->fatbuf = malloc_cache_aligned(FATBUFSIZE * FATBUFWINDOWS);
+	if (!mydata->fatbuf)
+		return -1;
+
+	for (i = 0; i < FATBUFWINDOWS; i++) {
+		mydata->fatbufnum[i] = -1;
+		mydata->fatbufused[i] = 0;
+	}
+	mydata->fatbuftick = 0;
+	mydata->fat_dirty = 0;
+
+	return 0;
+}
+
+/*
+ * Return the cache slot holding FAT window 'bufnum', reading the window in
+ * place of the least recently used one if needed. Return -1 on failure.
+ */
+static int get_fat_window(fsdata *mydata, __u32 bufnum)
+{
+	__u32 getsize = FATBUFBLOCKS;
+	__u32 fatlength = mydata->fatlength;
+	__u32 startblock = bufnum * FATBUFBLOCKS;
+	int i, slot = 0;
+
+	for (i = 0; i < FATBUFWINDOWS; i++) {
+		if (mydata->fatbufnum[i] == bufnum) {
+			slot = i;
+			goto found;
+		}
+		if (mydata->fatbufused[i] < mydata->fatbufused[slot])
+			slot = i;
+	}
+
+	/* Cap length if fatlength is not a multiple of FATBUFBLOCKS */
+	if (startblock + getsize > fatlength)
+		getsize = fatlength - startblock;
+
+	startblock += mydata->fat_sect;	/* Offset from start of disk */
+
+	/* Write back the window being replaced to the disk */
+	if (flush_fat_window(mydata, slot) < 0)
+		return -1;
+
+	mydata->fatbufnum[slot] = -1;
+	if (disk_read(startblock, getsize,
+		      mydata->fatbuf + slot * FATBUFSIZE) < 0) {
+		debug("Error reading FAT blocks\n");
+		return -1;
+	}
+	mydata->fatbufnum[slot] = bufnum;
+found:
+	mydata->fatbufused[slot] = ++mydata->fatbuftick;
+
+	return slot;
+}
+
 /*
  * Get the entry at index 'entry' in a FAT (12/16/32) table.
  * On failure 0x00 is returned.
@@ -166,6 +244,8 @@ static __u32 get_fatent(fsdata *mydata, __u32 entry)
 	__u32 bufnum;
 	__u32 offset, off8;
 	__u32 ret = 0x00;
+	__u8 *fatbuf;
+	int slot;
 
 	if (CHECK_CLUST(entry, mydata->fatsize)) {
 		printf("Error: Invalid FAT entry: 0x%08x\n", entry);
@@ -194,42 +274,24 @@ static __u32 get_fatent(fsdata *mydata, __u32 entry)
 	debug("FAT%d: entry: 0x%08x = %d, offset: 0x%04x = %d\n",
 	       mydata->fatsize, entry, entry, offset, offset);
 
-	/* Read a new block of FAT entries into the cache. */
-	if (bufnum != mydata->fatbufnum) {
-		__u32 getsize = FATBUFBLOCKS;
-		__u8 *bufptr = mydata->fatbuf;
-		__u32 fatlength = mydata->fatlength;
-		__u32 startblock = bufnum * FATBUFBLOCKS;
-
-		/* Cap length if fatlength is not a multiple of FATBUFBLOCKS */
-		if (startblock + getsize > fatlength)
-			getsize = fatlength - startblock;
-
-		startblock += mydata->fat_sect;	/* Offset from start of disk */
-
-		/* Write back the fatbuf to the disk */
-		if (flush_dirty_fat_buffer(mydata) < 0)
-			return -1;
-
-		if (disk_read(startblock, getsize, bufptr) < 0) {
-			debug("Error reading FAT blocks\n");
-			return ret;
-		}
-		mydata->fatbufnum = bufnum;
-	}
+	/* Read the block of FAT entries into the cache if needed. */
+	slot = get_fat_window(mydata, bufnum);
+	if (slot < 0)
+		return ret;
+	fatbuf = mydata->fatbuf + slot * FATBUFSIZE;
 
 	/* Get the actual entry from the table */
 	switch (mydata->fatsize) {
 	case 32:
-		ret = FAT2CPU32(((__u32 *) mydata->fatbuf)[offset]);
+		ret = FAT2CPU32(((__u32 *)fatbuf)[offset]);
 		break;
 	case 16:
-		ret = FAT2CPU16(((__u16 *) mydata->fatbuf)[offset]);
+		ret = FAT2CPU16(((__u16 *)fatbuf)[offset]);
 		break;
 	case 12:
 		off8 = (offset * 3) / 2;
 		/* fatbut + off8 may be unaligned, read in byte granularity */
-		ret = mydata->fatbuf[off8] + (mydata->fatbuf[off8 + 1] << 8);
+		ret = fatbuf[off8] + (fatbuf[off8 + 1] << 8);
 
 		if (offset & 0x1)
 			ret >>= 4;
@@ -305,22 +367,134 @@ get_cluster(fsdata *mydata, __u32 clustnum, __u8 *buffer, unsigned long size)
 }
 
 /**
- * get_contents() - read from file
+ * struct fat_extent - run of consecutive clusters of a file
  *
- * Read at most 'maxsize' bytes from 'pos' in the file associated with 'dentptr'
- * into 'buffer'. Update the number of bytes read in *gotsize or return -1 on
- * fatal errors.
- *
- * @mydata:	file system description
- * @dentprt:	directory entry pointer
- * @pos:	position from where to read
- * @buffer:	buffer into which to read
- * @maxsize:	maximum number of bytes to read
- * @gotsize:	number of bytes actually read
- * Return:	-1 on error, otherwise 0
+ * @start:	first cluster of the run
+ * @count:	number of clusters in the run
  */
-static int get_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos,
-			__u8 *buffer, loff_t maxsize, loff_t *gotsize)
+struct fat_extent {
+	__u32 start;
+	__u32 count;
+};
+
+/*
+ * Cluster runs of the file read last, so that its cluster chain is walked
+ * once per read. Only the clusters needed so far are mapped. The map is
+ * dropped on every mount and close, and whenever the FAT is written.
+ */
+static struct {
+	__u32 start;		/* first cluster of the file */
+	__u32 clusters;		/* number of clusters mapped */
+	__u32 count;		/* number of extents */
+	__u32 alloc;		/* number of extents allocated */
+	struct fat_extent *extents;
+} extent_map;
+
+static void forget_extent_map(void)
+{
+	free(extent_map.extents);
+	extent_map.extents = NULL;
+	extent_map.clusters = 0;
+	extent_map.count = 0;
+	extent_map.alloc = 0;
+}
+
+/* Tell if extent_map maps a file starting at cluster 'start' */
+static bool extent_map_holds(__u32 start)
+{
+	return extent_map.extents && extent_map.start == start;
+}
+
+/*
+ * Map the first 'nclust' clusters of the file starting at cluster 'start'
+ * into extent_map, carrying on from those already mapped.
+ * Return 0 on success, -ENOMEM if the map cannot be allocated, -EINVAL on
+ * an invalid FAT entry.
+ */
+static int get_extent_map(fsdata *mydata, __u32 start, __u32 nclust)
+{
+	struct fat_extent *ext, *tmp;
+	__u32 clust, i;
+
+	if (extent_map_holds(start)) {
+		if (extent_map.clusters >= nclust)
+			return 0;
+		ext = &extent_map.extents[extent_map.count - 1];
+		clust = get_fatent(mydata, ext->start + ext->count - 1);
+	} else {
+		forget_extent_map();
+		extent_map.start = start;
+		clust = start;
+	}
+
+	for (i = extent_map.clusters; i < nclust; i++) {
+		if (CHECK_CLUST(clust, mydata->fatsize)) {
+			debug("curclust: 0x%x\n", clust);
+			printf("Invalid FAT entry\n");
+			forget_extent_map();
+			return -EINVAL;
+		}
+
+		ext = extent_map.count ?
+			&extent_map.extents[extent_map.count - 1] : NULL;
+		if (ext && ext->start + ext->count == clust) {
+			ext->count++;
+		} else {
+			if (extent_map.count == extent_map.alloc) {
+				__u32 alloc = extent_map.alloc ?
+					      extent_map.alloc * 2 : 16;
+
+				tmp = realloc(extent_map.extents,
+					      alloc * sizeof(*tmp));
+				if (!tmp) {
+					debug("Error: allocating memory\n");
+					forget_extent_map();
+					return -ENOMEM;
+				}
+				extent_map.extents = tmp;
+				extent_map.alloc = alloc;
+			}
+			ext = &extent_map.extents[extent_map.count++];
+			ext->start = clust;
+			ext->count = 1;
+		}
+		extent_map.clusters = i + 1;
+
+		if (i + 1 < nclust)
+			clust = get_fatent(mydata, clust);
+	}
+	debug("%u clusters in %u extents\n", extent_map.clusters,
+	      extent_map.count);
+
+	return 0;
+}
+
+/*
+ * Return the extent of extent_map holding cluster number 'index' of the
+ * file, and in *first the number of the first cluster of that extent.
+ * Return NULL if the file has no such cluster.
+ */
+static struct fat_extent *find_extent(__u32 index, __u32 *first)
+{
+	__u32 i, n = 0;
+
+	for (i = 0; i < extent_map.count; i++) {
+		if (index < n + extent_map.extents[i].count) {
+			*first = n;
+			return &extent_map.extents[i];
+		}
+		n += extent_map.extents[i].count;
+	}
+
+	return NULL;
+}
+
+/*
+ * Read as get_contents() does, walking the cluster chain as it goes. This is
+ * used when there is no memory to map the clusters.
+ */
+static int get_contents_chain(fsdata *mydata, dir_entry *dentptr, loff_t pos,
+			      __u8 *buffer, loff_t maxsize, loff_t *gotsize)
 {
 	loff_t filesize = FAT2CPU32(dentptr->size);
 	unsigned int bytesperclust = mydata->clust_size * mydata->sect_size;
@@ -438,6 +612,111 @@ getit:
 	} while (1);
 }
 
+/**
+ * get_contents() - read from file
+ *
+ * Read at most 'maxsize' bytes from 'pos' in the file associated with 'dentptr'
+ * into 'buffer'. Update the number of bytes read in *gotsize or return -1 on
+ * fatal errors.
+ *
+ * The clusters of the file up to the end of the read are mapped first and
+ * each run of consecutive clusters is then read at once.
+ *
+ * @mydata:	file system description
+ * @dentprt:	directory entry pointer
+ * @pos:	position from where to read
+ * @buffer:	buffer into which to read
+ * @maxsize:	maximum number of bytes to read
+ * @gotsize:	number of bytes actually read
+ * Return:	-1 on error, otherwise 0
+ */
+static int get_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos,
+			__u8 *buffer, loff_t maxsize, loff_t *gotsize)
+{
+	loff_t filesize = FAT2CPU32(dentptr->size);
+	unsigned int bytesperclust = mydata->clust_size * mydata->sect_size;
+	struct fat_extent *ext;
+	__u32 index, first;
+	loff_t actsize, extend, offset;
+	int ret;
+
+	*gotsize = 0;
+	debug("Filesize: %llu bytes\n", filesize);
+
+	if (pos >= filesize) {
+		debug("Read position past EOF: %llu\n", pos);
+		return 0;
+	}
+
+	if (maxsize > 0 && filesize > pos + maxsize)
+		filesize = pos + maxsize;
+
+	debug("%llu bytes\n", filesize);
+
+	/* map only the clusters up to the end of the read */
+	ret = get_extent_map(mydata, START(dentptr),
+			     DIV_ROUND_UP_ULL(filesize, bytesperclust));
+	if (ret == -ENOMEM)
+		return get_contents_chain(mydata, dentptr, pos, buffer,
+					  maxsize, gotsize);
+	if (ret)
+		return -1;
+
+	/* go to cluster at pos */
+	index = div_u64(pos, bytesperclust);
+	ext = find_extent(index, &first);
+	if (!ext)
+		return -1;
+
+	while (pos < filesize) {
+		index = div_u64(pos, bytesperclust);
+		offset = pos - (loff_t)index * bytesperclust;
+
+		if (offset) {
+			/* align to beginning of next cluster */
+			__u8 *tmp_buffer;
+
+			actsize = min(filesize - pos + offset,
+				      (loff_t)bytesperclust);
+			tmp_buffer = malloc_cache_aligned(actsize);
+			if (!tmp_buffer) {
+				debug("Error: allocating buffer\n");
+				return -1;
+			}
+
+			if (get_cluster(mydata, ext->start + index - first,
+					tmp_buffer, actsize) != 0) {
+				printf("Error reading cluster\n");
+				free(tmp_buffer);
+				return -1;
+			}
+			actsize -= offset;
+			memcpy(buffer, tmp_buffer + offset, actsize);
+			free(tmp_buffer);
+		} else {
+			/* rest of the run of consecutive clusters */
+			extend = (loff_t)(first + ext->count) * bytesperclust;
+			actsize = min(filesize, extend) - pos;
+			if (get_cluster(mydata, ext->start + index - first,
+					buffer, actsize) != 0) {
+				printf("Error reading cluster\n");
+				return -1;
+			}
+		}
+
+		*gotsize += actsize;
+		buffer += actsize;
+		pos += actsize;
+
+		if (pos == (loff_t)(first + ext->count) * bytesperclust) {
+			first += ext->count;
+			ext++;
+		}
+	}
+
+	return 0;
+}
+
 /*
  * Extract the file name information from 'slotptr' into 'l_name',
  * starting at l_name[*idx].
@@ -623,10 +902,10 @@ static int get_fs_info(fsdata *mydata)
 		mydata->root_cluster = 0;
 	}
 
-	mydata->fatbufnum = -1;
-	mydata->fat_dirty = 0;
-	mydata->fatbuf = malloc_cache_aligned(FATBUFSIZE);
-	if (mydata->fatbuf == NULL) {
+	memcpy(&mydata->volume_id, volinfo.volume_id,
+	       sizeof(mydata->volume_id));
+
+	if (alloc_fat_cache(mydata)) {
 		debug("Error: allocating memory\n");
 		return -1;
 	}
@@ -1374,6 +1653,7 @@ void fat_closedir(struct fs_dir_stream *dirs)
 
 void fat_close(void)
 {
+	forget_extent_map();
 }
 
 int fat_uuid(char *uuid_str)
@@ -208,19 +208,19 @@ static int disk_write(__u32 block, __u32 nr_blocks, void *buf)
 }
 
 /*
- * Write fat buffer into block device
+ * Write the FAT window in cache slot 'slot' into block device, if modified
  */
-static int flush_dirty_fat_buffer(fsdata *mydata)
+static int flush_fat_window(fsdata *mydata, int slot)
 {
 	int getsize = FATBUFBLOCKS;
 	__u32 fatlength = mydata->fatlength;
-	__u8 *bufptr = mydata->fatbuf;
-	__u32 startblock = mydata->fatbufnum * FATBUFBLOCKS;
+	__u8 *bufptr = mydata->fatbuf + slot * FATBUFSIZE;
+	__u32 startblock = mydata->fatbufnum[slot] * FATBUFBLOCKS;
 
-	debug("debug: evicting %d, dirty: %d\n", mydata->fatbufnum,
-	      (int)mydata->fat_dirty);
+	debug("debug: evicting %d, dirty: %d\n", mydata->fatbufnum[slot],
+	      !!(mydata->fat_dirty & BIT(slot)));
 
-	if ((!mydata->fat_dirty) || (mydata->fatbufnum == -1))
+	if (!(mydata->fat_dirty & BIT(slot)) || mydata->fatbufnum[slot] == -1)
 		return 0;
 
 	/* Cap length if fatlength is not a multiple of FATBUFBLOCKS */
@@ -243,7 +243,22 @@ static int flush_dirty_fat_buffer(fsdata *mydata)
 			return -1;
 		}
 	}
-	mydata->fat_dirty = 0;
+	mydata->fat_dirty &= ~BIT(slot);
+
+	return 0;
+}
+
+/*
+ * Write all modified fat buffers into block device
+ */
+static int flush_dirty_fat_buffer(fsdata *mydata)
+{
+	int slot;
+
+	for (slot = 0; slot < FATBUFWINDOWS && mydata->fat_dirty; slot++) {
+		if (flush_fat_window(mydata, slot) < 0)
+			return -1;
+	}
 
 	return 0;
 }
@@ -437,6 +452,8 @@ static int set_fatent_value(fsdata *mydata, __u32 entry, __u32 entry_value)
 {
 	__u32 bufnum, offset, off16;
 	__u16 val1, val2;
+	__u8 *fatbuf;
+	int slot;
 
 	switch (mydata->fatsize) {
 	case 32:
@@ -456,39 +473,25 @@ static int set_fatent_value(fsdata *mydata, __u32 entry, __u32 entry_value)
 		return -1;
 	}
 
-	/* Read a new block of FAT entries into the cache. */
-	if (bufnum != mydata->fatbufnum) {
-		int getsize = FATBUFBLOCKS;
-		__u8 *bufptr = mydata->fatbuf;
-		__u32 fatlength = mydata->fatlength;
-		__u32 startblock = bufnum * FATBUFBLOCKS;
-
-		/* Cap length if fatlength is not a multiple of FATBUFBLOCKS */
-		if (startblock + getsize > fatlength)
-			getsize = fatlength - startblock;
-
-		if (flush_dirty_fat_buffer(mydata) < 0)
-			return -1;
-
-		startblock += mydata->fat_sect;
-
-		if (disk_read(startblock, getsize, bufptr) < 0) {
-			debug("Error reading FAT blocks\n");
-			return -1;
-		}
-		mydata->fatbufnum = bufnum;
-	}
+	/* Read the block of FAT entries into the cache if needed. */
+	slot = get_fat_window(mydata, bufnum);
+	if (slot < 0)
+		return -1;
+	fatbuf = mydata->fatbuf + slot * FATBUFSIZE;
 
 	/* Mark as dirty */
-	mydata->fat_dirty = 1;
+	mydata->fat_dirty |= BIT(slot);
+
+	/* Cluster chains change, forget those mapped for reading */
+	forget_extent_map();
 
 	/* Set the actual entry */
 	switch (mydata->fatsize) {
 	case 32:
-		((__u32 *) mydata->fatbuf)[offset] = cpu_to_le32(entry_value);
+		((__u32 *)fatbuf)[offset] = cpu_to_le32(entry_value);
 		break;
 	case 16:
-		((__u16 *) mydata->fatbuf)[offset] = cpu_to_le16(entry_value);
+		((__u16 *)fatbuf)[offset] = cpu_to_le16(entry_value);
 		break;
 	case 12:
 		off16 = (offset * 3) / 4;
@@ -496,33 +499,33 @@ static int set_fatent_value(fsdata *mydata, __u32 entry, __u32 entry_value)
 		switch (offset & 0x3) {
 		case 0:
 			val1 = cpu_to_le16(entry_value) & 0xfff;
-			((__u16 *)mydata->fatbuf)[off16] &= ~0xfff;
-			((__u16 *)mydata->fatbuf)[off16] |= val1;
+			((__u16 *)fatbuf)[off16] &= ~0xfff;
+			((__u16 *)fatbuf)[off16] |= val1;
 			break;
 		case 1:
 			val1 = cpu_to_le16(entry_value) & 0xf;
 			val2 = (cpu_to_le16(entry_value) >> 4) & 0xff;
 
-			((__u16 *)mydata->fatbuf)[off16] &= ~0xf000;
-			((__u16 *)mydata->fatbuf)[off16] |= (val1 << 12);
+			((__u16 *)fatbuf)[off16] &= ~0xf000;
+			((__u16 *)fatbuf)[off16] |= (val1 << 12);
 
-			((__u16 *)mydata->fatbuf)[off16 + 1] &= ~0xff;
-			((__u16 *)mydata->fatbuf)[off16 + 1] |= val2;
+			((__u16 *)fatbuf)[off16 + 1] &= ~0xff;
+			((__u16 *)fatbuf)[off16 + 1] |= val2;
 			break;
 		case 2:
 			val1 = cpu_to_le16(entry_value) & 0xff;
 			val2 = (cpu_to_le16(entry_value) >> 8) & 0xf;
 
-			((__u16 *)mydata->fatbuf)[off16] &= ~0xff00;
-			((__u16 *)mydata->fatbuf)[off16] |= (val1 << 8);
+			((__u16 *)fatbuf)[off16] &= ~0xff00;
+			((__u16 *)fatbuf)[off16] |= (val1 << 8);
 
-			((__u16 *)mydata->fatbuf)[off16 + 1] &= ~0xf;
-			((__u16 *)mydata->fatbuf)[off16 + 1] |= val2;
+			((__u16 *)fatbuf)[off16 + 1] &= ~0xf;
+			((__u16 *)fatbuf)[off16 + 1] |= val2;
 			break;
 		case 3:
 			val1 = cpu_to_le16(entry_value) & 0xfff;
-			((__u16 *)mydata->fatbuf)[off16] &= ~0xfff0;
-			((__u16 *)mydata->fatbuf)[off16] |= (val1 << 4);
+			((__u16 *)fatbuf)[off16] &= ~0xfff0;
+			((__u16 *)fatbuf)[off16] |= (val1 << 4);
 			break;
 		default:
 			break;
@@ -927,6 +930,8 @@ set_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos, __u8 *buffer,
 	unsigned int bytesperclust = mydata->clust_size * mydata->sect_size;
 	__u32 curclust = START(dentptr);
 	__u32 endclust = 0, newclust = 0;
+	struct fat_extent *ext;
+	__u32 index, first;
 	u64 cur_pos, filesize;
 	loff_t offset, actsize, wsize;
 
@@ -956,6 +961,14 @@ set_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos, __u8 *buffer,
 
 	/* go to cluster at pos */
 	cur_pos = bytesperclust;
+	if (pos > cur_pos && extent_map_holds(curclust)) {
+		/* skip to the last mapped cluster before pos */
+		index = min_t(u64, div_u64(pos - 1, bytesperclust),
+			      extent_map.clusters - 1);
+		ext = find_extent(index, &first);
+		curclust = ext->start + index - first;
+		cur_pos = (u64)(index + 1) * bytesperclust;
+	}
 	while (1) {
 		if (pos <= cur_pos)
 			break;
@@ -1369,6 +1382,12 @@ int file_fat_write_at(const char *filename, loff_t pos, void *buffer,
 			goto exit;
 		}
 
+		/* Map the clusters already there, to go to pos faster */
+		if (pos)
+			get_extent_map(mydata, START(retdent),
+				       DIV_ROUND_UP_ULL(pos, mydata->clust_size *
+							mydata->sect_size));
+
 		/* Update file size in a directory entry */
 		retdent->size = cpu_to_le32(pos + size);
 	} else {
@@ -1440,8 +1459,7 @@ int file_fat_write(const char *filename, void *buffer, loff_t offset,
 static int fat_dir_entries(fat_itr *itr)
 {
 	fat_itr *dirs;
-	fsdata fsdata = { .fatbuf = NULL, }, *mydata = &fsdata;
-						/* for FATBUFSIZE */
+	fsdata fsdata = { .fatbuf = NULL, };
 	int count;
 
 	dirs = malloc_cache_aligned(sizeof(fat_itr));
@@ -1456,13 +1474,11 @@ static int fat_dir_entries(fat_itr *itr)
 	fsdata = *dirs->fsdata;
 
 	/* allocate local fat buffer */
-	fsdata.fatbuf = malloc_cache_aligned(FATBUFSIZE);
-	if (!fsdata.fatbuf) {
+	if (alloc_fat_cache(&fsdata)) {
 		debug("Error: allocating memory\n");
 		count = -ENOMEM;
 		goto exit;
 	}
-	fsdata.fatbufnum = -1;
 	dirs->fsdata = &fsdata;
 
 	for (count = 0; fat_itr_next(dirs); count++)
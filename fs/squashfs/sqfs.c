@@ -14,6 +14,7 @@
 #include <linux/types.h>
 #include <asm/byteorder.h>
 #include <linux/compat.h>
+#include <linux/sizes.h>
 #include <memalign.h>
 #include <stdlib.h>
 #include <string.h>
@@ -24,6 +25,9 @@
 #include "sqfs_filesystem.h"
 #include "sqfs_utils.h"
 
+/* Largest run of data blocks read from the disk at once */
+#define SQFS_READ_BATCH_SIZE	SZ_1M
+
 static struct squashfs_ctxt ctxt;
 
 static int sqfs_disk_read(__u32 block, __u32 nr_blocks, void *buf)
@@ -94,27 +98,18 @@ static int sqfs_calc_n_blks(__le64 start, __le64 end, u64 *offset)
 }
 
 /*
- * Retrieves fragment block entry and returns true if the fragment block is
- * compressed
+ * Reads the fragment index table, which holds the position of each metadata
+ * block of fragment entries.
  */
-static int sqfs_frag_lookup(u32 inode_fragment_index,
-			    struct squashfs_fragment_block_entry *e)
+static int sqfs_read_frag_index(void)
 {
-	u64 start, n_blks, src_len, table_offset, start_block;
-	unsigned char *metadata_buffer, *metadata, *table;
-	struct squashfs_fragment_block_entry *entries;
 	struct squashfs_super_block *sblk = ctxt.sblk;
-	unsigned long dest_len;
-	int block, offset, ret;
-	u16 header;
-
-	metadata_buffer = NULL;
-	entries = NULL;
-	table = NULL;
-
-	if (inode_fragment_index >= get_unaligned_le32(&sblk->fragments))
-		return -EINVAL;
+	u64 start, n_blks, table_offset;
+	unsigned char *table;
+	int count;
 
+	count = DIV_ROUND_UP(get_unaligned_le32(&sblk->fragments),
+			     SQFS_MAX_ENTRIES);
 	start = get_unaligned_le64(&sblk->fragment_table_start) /
 		ctxt.cur_dev->blksz;
 	n_blks = sqfs_calc_n_blks(sblk->fragment_table_start,
@@ -123,36 +118,57 @@ static int sqfs_frag_lookup(u32 inode_fragment_index,
 
 	/* Allocate a proper sized buffer to store the fragment index table */
 	table = malloc_cache_aligned(n_blks * ctxt.cur_dev->blksz);
-	if (!table) {
-		ret = -ENOMEM;
-		goto out;
-	}
+	if (!table)
+		return -ENOMEM;
 
 	if (sqfs_disk_read(start, n_blks, table) < 0) {
-		ret = -EINVAL;
-		goto out;
+		free(table);
+		return -EINVAL;
 	}
 
-	block = SQFS_FRAGMENT_INDEX(inode_fragment_index);
-	offset = SQFS_FRAGMENT_INDEX_OFFSET(inode_fragment_index);
+	ctxt.frag_index = malloc(count * sizeof(u64));
+	ctxt.frag_entries = calloc(count, sizeof(*ctxt.frag_entries));
+	if (!ctxt.frag_index || !ctxt.frag_entries) {
+		free(ctxt.frag_index);
+		free(ctxt.frag_entries);
+		ctxt.frag_index = NULL;
+		ctxt.frag_entries = NULL;
+		free(table);
+		return -ENOMEM;
+	}
+	memcpy(ctxt.frag_index, table + table_offset, count * sizeof(u64));
+	ctxt.frag_metablks = count;
+	free(table);
+
+	return 0;
+}
+
+/* Reads and decompresses one metadata block of fragment entries */
+static int sqfs_read_frag_entries(int block)
+{
+	struct squashfs_fragment_block_entry *entries;
+	struct squashfs_super_block *sblk = ctxt.sblk;
+	u64 start, n_blks, src_len, table_offset, start_block;
+	unsigned char *metadata_buffer, *metadata;
+	unsigned long dest_len;
+	int ret = 0;
+	u16 header;
 
 	/*
 	 * Get the start offset of the metadata block that contains the right
 	 * fragment block entry
 	 */
-	start_block = get_unaligned_le64(table + table_offset + block *
-					 sizeof(u64));
+	start_block = get_unaligned_le64(&ctxt.frag_index[block]);
 
 	start = start_block / ctxt.cur_dev->blksz;
 	n_blks = sqfs_calc_n_blks(cpu_to_le64(start_block),
 				  sblk->fragment_table_start, &table_offset);
 
 	metadata_buffer = malloc_cache_aligned(n_blks * ctxt.cur_dev->blksz);
-	if (!metadata_buffer) {
-		ret = -ENOMEM;
-		goto out;
-	}
+	if (!metadata_buffer)
+		return -ENOMEM;
 
+	entries = NULL;
 	if (sqfs_disk_read(start, n_blks, metadata_buffer) < 0) {
 		ret = -EINVAL;
 		goto out;
@@ -162,7 +178,7 @@ static int sqfs_frag_lookup(u32 inode_fragment_index,
 	header = get_unaligned_le16(metadata_buffer + table_offset);
 	metadata = metadata_buffer + table_offset + SQFS_HEADER_SIZE;
 
-	if (!metadata || !header) {
+	if (!header) {
 		ret = -ENOMEM;
 		goto out;
 	}
@@ -186,17 +202,151 @@ static int sqfs_frag_lookup(u32 inode_fragment_index,
 		memcpy(entries, metadata, SQFS_METADATA_SIZE(header));
 	}
 
-	*e = entries[offset];
-	ret = SQFS_COMPRESSED_BLOCK(e->size);
+	ctxt.frag_entries[block] = entries;
+	entries = NULL;
 
 out:
 	free(entries);
 	free(metadata_buffer);
-	free(table);
 
 	return ret;
 }
 
+/*
+ * Retrieves fragment block entry and returns true if the fragment block is
+ * compressed. The tables read along the way are kept in the context.
+ */
+static int sqfs_frag_lookup(u32 inode_fragment_index,
+			    struct squashfs_fragment_block_entry *e)
+{
+	struct squashfs_super_block *sblk = ctxt.sblk;
+	int block, offset, ret;
+
+	if (inode_fragment_index >= get_unaligned_le32(&sblk->fragments))
+		return -EINVAL;
+
+	if (!ctxt.frag_index) {
+		ret = sqfs_read_frag_index();
+		if (ret)
+			return ret;
+	}
+
+	block = SQFS_FRAGMENT_INDEX(inode_fragment_index);
+	offset = SQFS_FRAGMENT_INDEX_OFFSET(inode_fragment_index);
+
+	if (!ctxt.frag_entries[block]) {
+		ret = sqfs_read_frag_entries(block);
+		if (ret)
+			return ret;
+	}
+
+	*e = ctxt.frag_entries[block][offset];
+
+	return SQFS_COMPRESSED_BLOCK(e->size);
+}
+
+/*
+ * Returns the decompressed fragment block described by @e. The block stays
+ * valid until the next call, or until the filesystem is closed.
+ */
+static int sqfs_get_frag_block(struct squashfs_fragment_block_entry *e,
+			       bool comp, unsigned char **blockp)
+{
+	u32 block_size = get_unaligned_le32(&ctxt.sblk->block_size);
+	struct squashfs_frag_cache *slot, *entry;
+	u64 start, n_blks, table_offset;
+	unsigned char *fragment;
+	unsigned long dest_len;
+	u32 src_len;
+	int i, ret;
+
+	slot = &ctxt.frags[0];
+	for (i = 0; i < SQFS_FRAG_CACHE_SIZE; i++) {
+		entry = &ctxt.frags[i];
+		if (entry->data && entry->start == e->start) {
+			entry->age = ++ctxt.frag_age;
+			*blockp = entry->data;
+			return 0;
+		}
+
+		/* Prefer an empty entry, else the least recently used one */
+		if (slot->data && (!entry->data || entry->age < slot->age))
+			slot = entry;
+	}
+
+	src_len = SQFS_BLOCK_SIZE(e->size);
+	if (!comp && src_len > block_size)
+		return -EINVAL;
+
+	start = lldiv(e->start, ctxt.cur_dev->blksz);
+	table_offset = e->start - (start * ctxt.cur_dev->blksz);
+	n_blks = DIV_ROUND_UP(src_len + table_offset, ctxt.cur_dev->blksz);
+
+	fragment = malloc_cache_aligned(n_blks * ctxt.cur_dev->blksz);
+	if (!fragment)
+		return -ENOMEM;
+
+	ret = sqfs_disk_read(start, n_blks, fragment);
+	if (ret < 0)
+		goto out;
+
+	if (!slot->data) {
+		slot->data = malloc(block_size);
+		if (!slot->data) {
+			ret = -ENOMEM;
+			goto out;
+		}
+	}
+	slot->start = ~0ULL;
+
+	if (comp) {
+		dest_len = block_size;
+		ret = sqfs_decompress(&ctxt, slot->data, &dest_len,
+				      fragment + table_offset, src_len);
+		if (ret)
+			goto out;
+	} else {
+		memcpy(slot->data, fragment + table_offset, src_len);
+	}
+
+	slot->start = e->start;
+	slot->age = ++ctxt.frag_age;
+	*blockp = slot->data;
+	ret = 0;
+
+out:
+	free(fragment);
+
+	return ret;
+}
+
+/* Frees the metadata and fragment blocks kept in the context */
+static void sqfs_cache_free(void)
+{
+	int i;
+
+	free(ctxt.inode_table);
+	free(ctxt.dir_table);
+	free(ctxt.dir_pos_list);
+	ctxt.inode_table = NULL;
+	ctxt.dir_table = NULL;
+	ctxt.dir_pos_list = NULL;
+	ctxt.dir_metablks = 0;
+
+	for (i = 0; i < ctxt.frag_metablks; i++)
+		free(ctxt.frag_entries[i]);
+	free(ctxt.frag_entries);
+	free(ctxt.frag_index);
+	ctxt.frag_entries = NULL;
+	ctxt.frag_index = NULL;
+	ctxt.frag_metablks = 0;
+
+	for (i = 0; i < SQFS_FRAG_CACHE_SIZE; i++) {
+		free(ctxt.frags[i].data);
+		ctxt.frags[i].data = NULL;
+	}
+}
+
 /*
  * The entry name is a flexible array member, and we don't know its size before
  * actually reading the entry. So we need a first copy to retrieve this size so
@@ -872,13 +1022,38 @@ out:
 	return metablks_count;
 }
 
+/*
+ * Decompresses the inode and directory tables, unless this was already done
+ * since the filesystem was probed.
+ */
+static int sqfs_load_tables(void)
+{
+	int ret;
+
+	if (ctxt.inode_table)
+		return 0;
+
+	ret = sqfs_read_inode_table(&ctxt.inode_table);
+	if (ret)
+		return -EINVAL;
+
+	ctxt.dir_metablks = sqfs_read_directory_table(&ctxt.dir_table,
+						      &ctxt.dir_pos_list);
+	if (ctxt.dir_metablks < 1) {
+		free(ctxt.inode_table);
+		ctxt.inode_table = NULL;
+		ctxt.dir_metablks = 0;
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
 int sqfs_opendir(const char *filename, struct fs_dir_stream **dirsp)
 {
-	unsigned char *inode_table = NULL, *dir_table = NULL;
-	int j, token_count = 0, ret = 0, metablks_count;
+	int j, token_count = 0, ret = 0;
 	struct squashfs_dir_stream *dirs;
 	char **token_list = NULL, *path = NULL;
-	u32 *pos_list = NULL;
 
 	dirs = calloc(1, sizeof(*dirs));
 	if (!dirs)
@@ -891,17 +1066,9 @@ int sqfs_opendir(const char *filename, struct fs_dir_stream **dirsp)
 	dirs->inode_table = NULL;
 	dirs->dir_table = NULL;
 
-	ret = sqfs_read_inode_table(&inode_table);
-	if (ret) {
-		ret = -EINVAL;
-		goto out;
-	}
-
-	metablks_count = sqfs_read_directory_table(&dir_table, &pos_list);
-	if (metablks_count < 1) {
-		ret = -EINVAL;
+	ret = sqfs_load_tables();
+	if (ret)
 		goto out;
-	}
 
 	/* Tokenize filename */
 	token_count = sqfs_count_tokens(filename);
@@ -930,10 +1097,10 @@ int sqfs_opendir(const char *filename, struct fs_dir_stream **dirsp)
 	 * ldir's (extended directory) size is greater than dir, so it works as
 	 * a general solution for the malloc size, since 'i' is a union.
 	 */
-	dirs->inode_table = inode_table;
-	dirs->dir_table = dir_table;
-	ret = sqfs_search_dir(dirs, token_list, token_count, pos_list,
-			      metablks_count);
+	dirs->inode_table = ctxt.inode_table;
+	dirs->dir_table = ctxt.dir_table;
+	ret = sqfs_search_dir(dirs, token_list, token_count, ctxt.dir_pos_list,
+			      ctxt.dir_metablks);
 	if (ret)
 		goto out;
 
@@ -957,10 +1124,9 @@ out:
 	for (j = 0; j < token_count; j++)
 		free(token_list[j]);
 	free(token_list);
-	free(pos_list);
 	free(path);
 	if (ret) {
-		free(inode_table);
+		free(dirs->dir_header);
 		free(dirs);
 	}
 
@@ -1103,6 +1269,16 @@ int sqfs_probe(struct blk_desc *fs_dev_desc, struct disk_partition *fs_partition
 
 	ctxt.sblk = sblk;
 
+	/* Metadata kept from an earlier access must belong to this image */
+	if (ctxt.cache_dev != fs_dev_desc ||
+	    ctxt.cache_start != fs_partition->start ||
+	    memcmp(&ctxt.cache_sblk, sblk, sizeof(*sblk))) {
+		sqfs_cache_free();
+		ctxt.cache_dev = fs_dev_desc;
+		ctxt.cache_start = fs_partition->start;
+		memcpy(&ctxt.cache_sblk, sblk, sizeof(*sblk));
+	}
+
 	ret = sqfs_decompressor_init(&ctxt);
 	if (ret) {
 		goto error;
@@ -1314,10 +1490,13 @@ static int sqfs_get_lregfile_info(struct squashfs_lreg_inode *lreg,
 int sqfs_read(const char *filename, void *buf, loff_t offset, loff_t len,
 	      loff_t *actread)
 {
-	char *dir = NULL, *fragment_block, *datablock = NULL;
-	char *fragment = NULL, *file = NULL, *resolved, *data;
+	char *dir = NULL, *datablock = NULL, *batch = NULL, *dest;
+	char *file = NULL, *resolved, *data;
 	u64 start, n_blks, table_size, data_offset, table_offset, sparse_size;
-	int ret, j, i_number, datablk_count = 0;
+	u64 batch_blks = 0;
+	int ret, i, j, k, i_number, datablk_count = 0;
+	unsigned char *fragment_block;
+	u32 block_size, size;
 	struct squashfs_super_block *sblk = ctxt.sblk;
 	struct squashfs_fragment_block_entry frag_entry;
 	struct squashfs_file_info finfo = {0};
@@ -1434,139 +1613,120 @@ int sqfs_read(const char *filename, void *buf, loff_t offset, loff_t len,
 		len = finfo.size;
 	}
 
+	block_size = get_unaligned_le32(&sblk->block_size);
 	if (datablk_count) {
 		data_offset = finfo.start;
-		datablock = malloc(get_unaligned_le32(&sblk->block_size));
+		datablock = malloc(block_size);
 		if (!datablock) {
 			ret = -ENOMEM;
 			goto out;
 		}
 	}
 
-	for (j = 0; j < datablk_count; j++) {
-		char *data_buffer;
+	for (j = 0; j < datablk_count && *actread < len; j = k) {
+		/* Don't load any data for sparse blocks */
+		if (!finfo.blk_sizes[j]) {
+			sparse_size = block_size;
+			if ((*actread + sparse_size) > len)
+				sparse_size = len - *actread;
+			memset(buf + *actread, 0, sparse_size);
+			*actread += sparse_size;
+			k = j + 1;
+			continue;
+		}
 
-		start = lldiv(data_offset, ctxt.cur_dev->blksz);
+		/*
+		 * Data blocks follow each other on the disk, so read as many
+		 * as fit in a batch at once and decompress them from there
+		 */
 		table_size = SQFS_BLOCK_SIZE(finfo.blk_sizes[j]);
+		for (k = j + 1; k < datablk_count && finfo.blk_sizes[k]; k++) {
+			size = SQFS_BLOCK_SIZE(finfo.blk_sizes[k]);
+			if (table_size + size > SQFS_READ_BATCH_SIZE)
+				break;
+			table_size += size;
+		}
+
+		start = lldiv(data_offset, ctxt.cur_dev->blksz);
 		table_offset = data_offset - (start * ctxt.cur_dev->blksz);
 		n_blks = DIV_ROUND_UP(table_size + table_offset,
 				      ctxt.cur_dev->blksz);
-
-		/* Don't load any data for sparse blocks */
-		if (finfo.blk_sizes[j] == 0) {
-			n_blks = 0;
-			table_offset = 0;
-			data_buffer = NULL;
-			data = NULL;
-		} else {
-			data_buffer = malloc_cache_aligned(n_blks * ctxt.cur_dev->blksz);
-
-			if (!data_buffer) {
+		if (n_blks > batch_blks) {
+			free(batch);
+			batch = malloc_cache_aligned(n_blks *
+						     ctxt.cur_dev->blksz);
+			if (!batch) {
 				ret = -ENOMEM;
 				goto out;
 			}
-
-			ret = sqfs_disk_read(start, n_blks, data_buffer);
-			if (ret < 0) {
-				/*
-				 * Possible causes: too many data blocks or too large
-				 * SquashFS block size. Tip: re-compile the SquashFS
-				 * image with mksquashfs's -b <block_size> option.
-				 */
-				printf("Error: too many data blocks to be read.\n");
-				goto out;
-			}
-
-			data = data_buffer + table_offset;
+			batch_blks = n_blks;
 		}
 
-		/* Load the data */
-		if (finfo.blk_sizes[j] == 0) {
-			/* This is a sparse block */
-			sparse_size = get_unaligned_le32(&sblk->block_size);
-			if ((*actread + sparse_size) > len)
-				sparse_size = len - *actread;
-			memset(buf + *actread, 0, sparse_size);
-			*actread += sparse_size;
-		} else if (SQFS_COMPRESSED_BLOCK(finfo.blk_sizes[j])) {
-			dest_len = get_unaligned_le32(&sblk->block_size);
-			ret = sqfs_decompress(&ctxt, datablock, &dest_len,
-					      data, table_size);
-			if (ret)
-				goto out;
-
-			if ((*actread + dest_len) > len)
-				dest_len = len - *actread;
-			memcpy(buf + *actread, datablock, dest_len);
-			*actread += dest_len;
-		} else {
-			if ((*actread + table_size) > len)
-				table_size = len - *actread;
-			memcpy(buf + *actread, data, table_size);
-			*actread += table_size;
+		ret = sqfs_disk_read(start, n_blks, batch);
+		if (ret < 0) {
+			/*
+			 * Possible causes: too many data blocks or too large
+			 * SquashFS block size. Tip: re-compile the SquashFS
+			 * image with mksquashfs's -b <block_size> option.
+			 */
+			printf("Error: too many data blocks to be read.\n");
+			goto out;
 		}
 
+		data = batch + table_offset;
 		data_offset += table_size;
-		free(data_buffer);
-		if (*actread >= len)
-			break;
+
+		for (i = j; i < k && *actread < len; i++) {
+			size = SQFS_BLOCK_SIZE(finfo.blk_sizes[i]);
+			if (SQFS_COMPRESSED_BLOCK(finfo.blk_sizes[i])) {
+				/*
+				 * Decompress straight to the destination,
+				 * unless the block goes past the end of it
+				 */
+				dest_len = block_size;
+				dest = buf + *actread;
+				if (*actread + block_size > len)
+					dest = datablock;
+				ret = sqfs_decompress(&ctxt, dest, &dest_len,
+						      data, size);
+				if (ret)
+					goto out;
+
+				if ((*actread + dest_len) > len)
+					dest_len = len - *actread;
+				if (dest == datablock)
+					memcpy(buf + *actread, datablock,
+					       dest_len);
+				*actread += dest_len;
+			} else {
+				dest_len = size;
+				if ((*actread + dest_len) > len)
+					dest_len = len - *actread;
+				memcpy(buf + *actread, data, dest_len);
+				*actread += dest_len;
+			}
+			data += size;
+		}
 	}
 
 	/*
-	 * There is no need to continue if the file is not fragmented.
+	 * There is no need to continue if the file is not fragmented, or the
+	 * requested length ends before the fragment.
 	 */
-	if (!finfo.frag) {
+	if (!finfo.frag || *actread >= len) {
 		ret = 0;
 		goto out;
 	}
 
-	start = lldiv(frag_entry.start, ctxt.cur_dev->blksz);
-	table_size = SQFS_BLOCK_SIZE(frag_entry.size);
-	table_offset = frag_entry.start - (start * ctxt.cur_dev->blksz);
-	n_blks = DIV_ROUND_UP(table_size + table_offset, ctxt.cur_dev->blksz);
-
-	fragment = malloc_cache_aligned(n_blks * ctxt.cur_dev->blksz);
-
-	if (!fragment) {
-		ret = -ENOMEM;
-		goto out;
-	}
-
-	ret = sqfs_disk_read(start, n_blks, fragment);
-	if (ret < 0)
+	ret = sqfs_get_frag_block(&frag_entry, finfo.comp, &fragment_block);
+	if (ret)
 		goto out;
 
-	/* File compressed and fragmented */
-	if (finfo.frag && finfo.comp) {
-		dest_len = get_unaligned_le32(&sblk->block_size);
-		fragment_block = malloc(dest_len);
-		if (!fragment_block) {
-			ret = -ENOMEM;
-			goto out;
-		}
-
-		ret = sqfs_decompress(&ctxt, fragment_block, &dest_len,
-				      (void *)fragment  + table_offset,
-				      frag_entry.size);
-		if (ret) {
-			free(fragment_block);
-			goto out;
-		}
-
-		memcpy(buf + *actread, &fragment_block[finfo.offset], finfo.size - *actread);
-		*actread = finfo.size;
-
-		free(fragment_block);
-
-	} else if (finfo.frag && !finfo.comp) {
-		fragment_block = (void *)fragment + table_offset;
-
-		memcpy(buf + *actread, &fragment_block[finfo.offset], finfo.size - *actread);
-		*actread = finfo.size;
-	}
+	memcpy(buf + *actread, &fragment_block[finfo.offset], len - *actread);
+	*actread = len;
 
 out:
-	free(fragment);
+	free(batch);
 	free(datablock);
 	free(file);
 	free(dir);
@@ -1705,6 +1865,10 @@ free_strings:
 
 void sqfs_close(void)
 {
+	if (!IS_ENABLED(CONFIG_SQUASHFS_CACHE)) {
+		sqfs_cache_free();
+		ctxt.cache_dev = NULL;
+	}
 	sqfs_decompressor_cleanup(&ctxt);
 	free(ctxt.sblk);
 	ctxt.sblk = NULL;
@@ -1719,8 +1883,7 @@ void sqfs_closedir(struct fs_dir_stream *dirs)
 		return;
 
 	sqfs_dirs = (struct squashfs_dir_stream *)dirs;
-	free(sqfs_dirs->inode_table);
-	free(sqfs_dirs->dir_table);
+	free(sqfs_dirs->entry);
 	free(sqfs_dirs->dir_header);
 	free(sqfs_dirs);
 }
@@ -73,6 +73,21 @@ struct squashfs_super_block {
 	__le64 export_table_start;
 };
 
+/* Number of decompressed fragment blocks kept in memory */
+#define SQFS_FRAG_CACHE_SIZE 4
+
+/*
+ * A decompressed fragment block. Several small files usually share one
+ * fragment block, so recently used ones are kept.
+ */
+struct squashfs_frag_cache {
+	/* Position of the fragment block on the disk, ~0 if not valid */
+	u64 start;
+	/* Last use, to find the least recently used entry */
+	u32 age;
+	unsigned char *data;
+};
+
 struct squashfs_ctxt {
 	struct disk_partition cur_part_info;
 	struct blk_desc *cur_dev;
@@ -80,6 +95,25 @@ struct squashfs_ctxt {
 #if IS_ENABLED(CONFIG_ZSTD)
 	void *zstd_workspace;
 #endif
+	/*
+	 * Decompressed metadata, read when first needed and kept until the
+	 * filesystem is closed (or, with CONFIG_SQUASHFS_CACHE, until a
+	 * different image is probed). 'cache_*' identify the image it
+	 * belongs to.
+	 */
+	struct squashfs_super_block cache_sblk;
+	struct blk_desc *cache_dev;
+	lbaint_t cache_start;
+	unsigned char *inode_table;
+	unsigned char *dir_table;
+	u32 *dir_pos_list;
+	int dir_metablks;
+	/* Fragment index table, and the fragment entry blocks read so far */
+	__le64 *frag_index;
+	struct squashfs_fragment_block_entry **frag_entries;
+	int frag_metablks;
+	struct squashfs_frag_cache frags[SQFS_FRAG_CACHE_SIZE];
+	u32 frag_age;
 };
 
 struct squashfs_directory_index {
@@ -274,7 +308,7 @@ struct squashfs_dir_stream {
 	struct squashfs_ldir_inode i_ldir;
 	/*
 	 * References to the tables' beginnings. They are assigned in
-	 * sqfs_opendir() and freed in sqfs_closedir().
+	 * sqfs_opendir() and belong to the filesystem context.
 	 */
 	unsigned char *inode_table;
 	unsigned char *dir_table;
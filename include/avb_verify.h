@@ -28,6 +28,9 @@ struct AvbOpsData {
 	struct AvbOps ops;
 	int mmc_dev;
 	enum avb_boot_state boot_state;
+	/* partition read to its load address, see avb_set_load_addr() */
+	char load_part[PART_NAME_LEN];
+	ulong load_addr;
 #ifdef CONFIG_OPTEE_TA_AVB
 	struct udevice *tee;
 	u32 session;
@@ -48,6 +51,7 @@ enum mmc_io_type {
 
 AvbOps *avb_ops_alloc(int boot_device);
 void avb_ops_free(AvbOps *ops);
+void avb_set_load_addr(AvbOps *ops, const char *partition, ulong addr);
 
 char *avb_set_state(AvbOps *ops, enum avb_boot_state boot_state);
 char *avb_set_enforce_verity(const char *cmdline);
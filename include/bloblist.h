@@ -120,6 +120,7 @@ enum bloblist_tag_t {
 	 * be BLOBLISTT_<vendor>_<purpose_here>
 	 */
 	BLOBLISTT_VENDOR_AREA = 0xc000,
+	BLOBLISTT_SPACEMIT_EFUSE = 0xc001,	/* K1 efuse banks, read by SPL */
 
 	/* Tags after this are not allocated for now */
 	BLOBLISTT_EXPANSION = 0x10000,
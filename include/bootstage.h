@@ -329,6 +329,23 @@ uint32_t bootstage_start(enum bootstage_id id, const char *name);
  */
 uint32_t bootstage_accum(enum bootstage_id id);
 
+/**
+ * Set the total time of a bootstage activity
+ *
+ * This is like bootstage_start() / bootstage_accum(), for activities whose
+ * time is measured elsewhere. The record is an accumulator, so it is shown in
+ * the 'Accumulated time' part of the report.
+ *
+ * @param id	Bootstage id to record this time against, or
+ *		BOOTSTAGE_ID_ALLOC to allocate a new one
+ * @param name	Textual name to display for this id in the report (NULL to
+ *		keep the current one)
+ * @param time_us	Total time spent in this activity, in microseconds
+ * Return: bootstage id used, or 0 if there is no space for the record
+ */
+enum bootstage_id bootstage_set_accum(enum bootstage_id id, const char *name,
+				      uint32_t time_us);
+
 /* Print a report about boot time */
 void bootstage_report(void);
 
@@ -428,6 +445,13 @@ static inline uint32_t bootstage_accum(enum bootstage_id id)
 	return 0;
 }
 
+static inline enum bootstage_id bootstage_set_accum(enum bootstage_id id,
+						    const char *name,
+						    uint32_t time_us)
+{
+	return 0;
+}
+
 static inline int bootstage_stash(void *base, int size)
 {
 	return 0;	/* Pretend to succeed */
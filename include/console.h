@@ -133,6 +133,70 @@ static inline int console_in_puts(const char *str)
 
 #endif /* !CONFIG_CONSOLE_RECORD */
 
+#if CONFIG_IS_ENABLED(CONSOLE_DEFER)
+/**
+ * console_defer_init() - Set up deferred serial output
+ *
+ * This allocates the ring buffer and starts using it
+ *
+ * Return: 0 if OK, -ENOMEM if out of memory
+ */
+int console_defer_init(void);
+
+/**
+ * console_defer_enable() - Start or stop using the ring buffer
+ *
+ * When stopping, any pending output is sent first. The history is kept.
+ *
+ * @enable: true to write serial output to the ring, false to write it directly
+ * Return: 0 if OK, -ENOSYS if there is no ring buffer
+ */
+int console_defer_enable(bool enable);
+
+/**
+ * console_defer_poll() - Send pending output which fits in the UART
+ *
+ * This does not wait, so can be called from polling loops
+ */
+void console_defer_poll(void);
+
+/**
+ * console_defer_flush() - Send all pending output, waiting for the UART
+ *
+ * Call this before anything which may stop the output from being sent later,
+ * such as a reset or jumping to an OS.
+ */
+void console_defer_flush(void);
+
+/**
+ * console_log_show() - Write the console history to the console
+ *
+ * This shows the most recent CONFIG_CONSOLE_DEFER_SIZE bytes of console
+ * output since console_defer_init() or console_log_clear()
+ */
+void console_log_show(void);
+
+/**
+ * console_log_clear() - Clear the console history
+ */
+void console_log_clear(void);
+#else
+static inline int console_defer_init(void)
+{
+	return 0;
+}
+
+static inline int console_defer_enable(bool enable)
+{
+	return -ENOSYS;
+}
+
+static inline void console_defer_poll(void) {}
+static inline void console_defer_flush(void) {}
+static inline void console_log_show(void) {}
+static inline void console_log_clear(void) {}
+#endif
+
 /**
  * console_announce_r() - print a U-Boot console on non-serial consoles
  *
@@ -0,0 +1,121 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Per-call-site statistics for busy-wait delays and polling loops
+ */
+
+#ifndef __DELAY_STATS_H
+#define __DELAY_STATS_H
+
+#include <linux/types.h>
+
+/**
+ * enum delay_stats_type - type of busy-wait being recorded
+ *
+ * @DELAY_STATS_UDELAY: a call to udelay() / mdelay() / ndelay()
+ * @DELAY_STATS_POLL: a read_poll_timeout() loop, or one of its variants
+ */
+enum delay_stats_type {
+	DELAY_STATS_UDELAY,
+	DELAY_STATS_POLL,
+};
+
+/**
+ * struct delay_site - statistics for one call site
+ *
+ * @site: Address of the call site, as in the u-boot ELF file (i.e. with the
+ *	relocation offset removed)
+ * @type: Type of busy-wait (enum delay_stats_type)
+ * @count: Number of times this site was called
+ * @timeouts: Number of times the polling loop timed out (polls only)
+ * @total: Total time spent waiting, in timer ticks
+ * @max: Longest single wait, in timer ticks
+ * @bootstage_id: Bootstage record for this site, once exported (else 0)
+ */
+struct delay_site {
+	ulong site;
+	u8 type;
+	u16 bootstage_id;
+	u32 count;
+	u32 timeouts;
+	u64 total;
+	u64 max;
+};
+
+#if CONFIG_IS_ENABLED(DELAY_STATS)
+
+/* Address of the current code location */
+#define DELAY_STATS_HERE	({ __label__ __here; __here: (ulong)&&__here; })
+
+/**
+ * delay_stats_add() - Record a busy-wait
+ *
+ * @site: Address of the call site (before any relocation is removed)
+ * @type: Type of busy-wait (enum delay_stats_type)
+ * @start: Timer tick value (from get_ticks()) when the wait started
+ * @timeout: true if this was a polling loop which timed out
+ */
+void delay_stats_add(ulong site, enum delay_stats_type type, u64 start,
+		     bool timeout);
+
+/**
+ * delay_stats_get() - Get the statistics recorded so far
+ *
+ * Sites are kept by delay_stats_reset(), so some may have a zero count.
+ *
+ * @sitesp: Returns a pointer to the array of sites, in order of first use
+ * Return: number of sites in the array
+ */
+int delay_stats_get(const struct delay_site **sitesp);
+
+/**
+ * delay_stats_reset() - Clear all statistics recorded so far
+ */
+void delay_stats_reset(void);
+
+/**
+ * delay_stats_show() - Print the statistics, longest total wait first
+ *
+ * @min_us: Don't show sites with a total wait time less than this
+ */
+void delay_stats_show(ulong min_us);
+
+/**
+ * delay_stats_bootstage() - Add the statistics to bootstage
+ *
+ * Each call site with a total wait time of at least @min_us is added as an
+ * accumulated bootstage record, so it is included in the bootstage report and
+ * in the /bootstage node passed to the OS.
+ *
+ * @min_us: Don't add sites with a total wait time less than this
+ * Return: number of records added
+ */
+int delay_stats_bootstage(ulong min_us);
+
+/* Used by read_poll_timeout() */
+#define delay_stats_start()		get_ticks()
+#define delay_stats_poll(start, ret)	\
+	delay_stats_add(DELAY_STATS_HERE, DELAY_STATS_POLL, start, ret)
+
+#else
+
+static inline int delay_stats_get(const struct delay_site **sitesp)
+{
+	*sitesp = NULL;
+
+	return 0;
+}
+
+static inline void delay_stats_reset(void) {}
+static inline void delay_stats_show(ulong min_us) {}
+
+static inline int delay_stats_bootstage(ulong min_us)
+{
+	return 0;
+}
+
+#define delay_stats_start()		0
+#define delay_stats_poll(start, ret)	do { (void)(start); } while (0)
+
+#endif
+
+#endif /* __DELAY_STATS_H */
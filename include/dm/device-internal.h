@@ -192,6 +192,22 @@ int device_of_to_plat(struct udevice *dev);
  */
 int device_probe(struct udevice *dev);
 
+/**
+ * device_probe_async() - Probe a device, without waiting for it to be ready
+ *
+ * This is like device_probe(), but if the driver has a probe_ready() method
+ * it does not wait for the device to be ready. The device is marked with
+ * DM_FLAG_PROBE_PENDING, and the next device_probe() waits for it and
+ * completes the probe. Probing several devices this way lets their waits
+ * overlap. device_remove() cancels a pending probe without waiting.
+ *
+ * Without CONFIG_DM_ASYNC_PROBE this is the same as device_probe().
+ *
+ * @dev: Pointer to device to probe
+ * Return: 0 if OK, -ve on error
+ */
+int device_probe_async(struct udevice *dev);
+
 /**
  * device_remove() - Remove a device, de-activating it
  *
@@ -84,6 +84,13 @@ struct driver_info;
 /* Device must be probed after it was bound */
 #define DM_FLAG_PROBE_AFTER_BIND	(1 << 15)
 
+/*
+ * Device was probed with device_probe_async() and its driver has not yet
+ * reported that it is ready. The next device_probe() waits for it, while
+ * device_remove() cancels it.
+ */
+#define DM_FLAG_PROBE_PENDING		(1 << 16)
+
 /*
  * One or multiple of these flags are passed to device_remove() so that
  * a selective device removal as specified by the remove-stage and the
@@ -338,6 +345,11 @@ struct udevice_id {
  * for each.
  * @bind: Called to bind a device to its driver
  * @probe: Called to probe a device, i.e. activate it
+ * @probe_ready: Called after @probe to check whether the device is ready for
+ * use. It returns -EAGAIN while it is not, 0 when it is, or another error if
+ * it will never be (e.g. on a timeout). With this, @probe only needs to start
+ * slow operations such as link training, so that device_probe_async() can
+ * leave them to finish while other devices are probed.
  * @remove: Called to remove a device, i.e. de-activate it
  * @unbind: Called to unbind a device from its driver
  * @of_to_plat: Called before probe to decode device tree data
@@ -373,6 +385,7 @@ struct driver {
 	const struct udevice_id *of_match;
 	int (*bind)(struct udevice *dev);
 	int (*probe)(struct udevice *dev);
+	int (*probe_ready)(struct udevice *dev);
 	int (*remove)(struct udevice *dev);
 	int (*unbind)(struct udevice *dev);
 	int (*of_to_plat)(struct udevice *dev);
@@ -490,6 +490,18 @@ int of_count_phandle_with_args(const struct device_node *np,
  */
 int of_alias_scan(void);
 
+/**
+ * of_index_scan() - Build the phandle and compatible-string indexes
+ *
+ * This builds lookup tables for of_find_node_by_phandle() and
+ * of_find_compatible_node() from the control tree (gd->of_root), so that they
+ * do not need to walk the tree. It does nothing unless CONFIG_OF_LIVE_INDEX is
+ * enabled. Lookups fall back to walking the tree if the control tree changes.
+ *
+ * Return: 0 if OK, -ENOMEM if not enough memory
+ */
+int of_index_scan(void);
+
 /**
  * of_alias_get_id - Get alias id for the given device_node
  *
@@ -426,6 +426,19 @@ int uclass_first_device_drvdata(enum uclass_id id, ulong driver_data,
  */
 int uclass_probe_all(enum uclass_id id);
 
+/**
+ * uclass_probe_all_async() - Start probing all devices in a uclass
+ *
+ * This calls device_probe_async() on each device in the uclass, so that
+ * devices which are slow to become ready (e.g. waiting for a link) can do so
+ * at the same time, while the caller continues. Errors from individual
+ * devices are ignored; they are reported again when the device is used.
+ *
+ * @id: uclass ID to look up
+ * Return: 0 if OK, other -ve on error
+ */
+int uclass_probe_all_async(enum uclass_id id);
+
 /**
  * uclass_id_count() - Count the number of devices in a uclass
  *
@@ -97,6 +97,9 @@ void env_relocate(void);
  * environment is loaded from storage, i.e. GD_FLG_ENV_READY is 0). In that
  * case this function calls env_get_f().
  *
+ * With CONFIG_SPL_ENV_VIEW the returned value points into the environment
+ * itself and must not be modified.
+ *
  * @varname:	Variable to look up
  * Return: value of variable, or NULL if not found
  */
@@ -296,6 +299,9 @@ int env_select(const char *name);
  * This imports the environment from a buffer. The format for each variable is
  * var=value\0 with a double \0 at the end of the buffer.
  *
+ * With CONFIG_SPL_ENV_VIEW the data is kept as it is, for env_get() to read,
+ * and @flags is ignored.
+ *
  * @buf: Buffer containing the environment (struct environemnt_s *)
  * @check: non-zero to check the CRC at the start of the environment, 0 to
  *	ignore it
@@ -26,6 +26,7 @@ struct disk_partition;
 			 sizeof(dir_entry))
 
 #define FATBUFBLOCKS	6
+#define FATBUFWINDOWS	16	/* FAT windows cached, at most 32 */
 #define FATBUFSIZE	(mydata->sect_size * FATBUFBLOCKS)
 #define FAT12BUFSIZE	((FATBUFSIZE*2)/3)
 #define FAT16BUFSIZE	(FATBUFSIZE/2)
@@ -168,20 +169,23 @@ typedef struct dir_slot {
  * (see FAT32 accesses)
  */
 typedef struct {
-	__u8	*fatbuf;	/* Current FAT buffer */
+	__u8	*fatbuf;	/* FATBUFWINDOWS FAT buffers of FATBUFSIZE */
 	int	fatsize;	/* Size of FAT in bits */
 	__u32	fatlength;	/* Length of FAT in sectors */
 	__u16	fat_sect;	/* Starting sector of the FAT */
-	__u8	fat_dirty;      /* Set if fatbuf has been modified */
+	__u32	fat_dirty;      /* Bit set for each modified FAT buffer */
 	__u32	rootdir_sect;	/* Start sector of root directory */
 	__u16	sect_size;	/* Size of sectors in bytes */
 	__u16	clust_size;	/* Size of clusters in sectors */
 	int	data_begin;	/* The sector of the first cluster, can be negative */
-	int	fatbufnum;	/* Used by get_fatent, init to -1 */
+	int	fatbufnum[FATBUFWINDOWS];	/* FAT window held, or -1 */
+	__u32	fatbufused[FATBUFWINDOWS];	/* When last used */
+	__u32	fatbuftick;	/* Count of FAT buffer uses */
 	int	rootdir_size;	/* Size of root dir for non-FAT32 */
 	__u32	root_cluster;	/* First cluster of root dir for FAT32 */
 	u32	total_sect;	/* Number of sectors */
 	int	fats;		/* Number of FATs */
+	__u32	volume_id;	/* Volume serial number */
 } fsdata;
 
 struct fat_itr;
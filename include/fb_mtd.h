@@ -44,6 +44,20 @@ int _fb_mtd_erase(struct mtd_info *mtd, u32 erase_size);
 int _fb_mtd_write(struct mtd_info *mtd, void *buffer, u32 offset,
 			  size_t length, size_t *written);
 
+/**
+ * @brief write an image to the start of a mtd part, touching only what changes.
+ *
+ * On NOR flash the sectors already holding the image are skipped, erased
+ * sectors are only programmed, and the rest erased with the largest erase
+ * commands that fit. Other flashes are erased and written as a whole.
+ *
+ * @param mtd: mtd dev.
+ * @param buffer: the image.
+ * @param length: the image size.
+ * @return int
+ */
+int _fb_mtd_update(struct mtd_info *mtd, void *buffer, u32 length);
+
 /**
  * @brief read data to mtd part.
  * 
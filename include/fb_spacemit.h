@@ -7,6 +7,7 @@
 #define _FB_SPACEMIT_H_
 
 #include <mtd.h>
+#include <u-boot/sha256.h>
 
 /*define max partition number*/
 #define MAX_PARTITION_NUM (20)
@@ -166,6 +167,34 @@ struct flash_dev {
 					u32 download_bytes);
 };
 
+/* prefix of the fastboot flash target that takes a block-hash manifest */
+#define FB_BLOCKHASH_PREFIX ("blockhash:")
+/* suffix of the manifest file next to an image in recovery flashing */
+#define FB_BLOCKHASH_SUFFIX (".bhm")
+
+/**
+ * struct fb_blockhash - block-hash manifest of an image
+ *
+ * @part_name: partition the manifest was given for
+ * @image_size: size of the image in bytes
+ * @chunk_size: bytes covered by each hash
+ * @count: number of hashes
+ * @hash: SHA256 of each chunk of the image
+ * @buf: chunk sized buffer to read the device into
+ * @skipped: bytes found already up to date on the device
+ * @written: bytes written to the device
+ */
+struct fb_blockhash {
+	char part_name[32];
+	u64 image_size;
+	u32 chunk_size;
+	u32 count;
+	u8 (*hash)[SHA256_SUM_LEN];
+	void *buf;
+	u64 skipped;
+	u64 written;
+};
+
 /**
  * @brief boot info struct
  *
@@ -368,4 +397,93 @@ int get_available_blk_dev(char **blk_dev, int *index);
 */
 int get_available_boot_blk_dev(char **blk_dev, int *index);
 
+/**
+ * @brief parse a block-hash manifest.
+ *
+ * @param bh manifest to fill in, any previous one is freed.
+ * @param part_name partition the manifest is for.
+ * @param buf manifest text.
+ * @param len manifest size.
+ * @return int 0 on success, -EINVAL if the manifest is malformed.
+ */
+int fb_blockhash_load(struct fb_blockhash *bh, const char *part_name,
+		      const char *buf, size_t len);
+
+/**
+ * @brief free the hashes and buffer of a manifest.
+ */
+void fb_blockhash_free(struct fb_blockhash *bh);
+
+/**
+ * @brief write a piece of the image, skipping the chunks that the device
+ * already holds. Each chunk written is read back and checked, so there is
+ * no need for compare_blk_image_val() afterwards.
+ *
+ * @param start block the piece is written at.
+ * @param offset byte offset of the piece in the image.
+ * @param buf piece data.
+ * @param len piece size.
+ * @return int 0 on success, -EBADMSG if the data does not match the
+ * manifest, -EIO on a device error.
+ */
+int fb_blockhash_write_blk(struct fb_blockhash *bh, struct blk_desc *dev_desc,
+			   lbaint_t start, u64 offset, const void *buf, u64 len);
+
+/**
+ * @brief print how many bytes were skipped and written.
+ */
+void fb_blockhash_report(const struct fb_blockhash *bh);
+
+/**
+ * @brief keep the manifest downloaded for a later 'fastboot flash'.
+ *
+ * @param part_name partition the manifest is for.
+ */
+void fastboot_flash_blockhash(const char *part_name, void *download_buffer,
+			      u32 download_bytes, char *response);
+
+#if CONFIG_IS_ENABLED(SPACEMIT_FLASH_BLOCKHASH)
+/**
+ * @brief check that a piece of the image can be flashed by chunk.
+ *
+ * @param offset byte offset of the piece in the image.
+ * @param len size of the piece.
+ * @param blksz block size of the device.
+ * @return bool true if the piece starts on a chunk and ends on one, or at
+ * the end of the image.
+ */
+bool fb_blockhash_covers(const struct fb_blockhash *bh, u64 offset, u64 len,
+			 ulong blksz);
+
+/**
+ * @brief flash a piece of an image over fastboot with the manifest sent
+ * for its partition, and answer the host.
+ *
+ * @param start block the piece is written at.
+ * @param part_name partition being flashed.
+ * @param offset byte offset of the piece in the image.
+ * @return bool false if there is no manifest covering the piece, and the
+ * caller has to write it as usual.
+ */
+bool fastboot_blockhash_write(struct blk_desc *dev_desc, lbaint_t start,
+			      const char *part_name, u64 offset,
+			      void *download_buffer, u32 download_bytes,
+			      char *response);
+#else
+static inline bool fb_blockhash_covers(const struct fb_blockhash *bh,
+				       u64 offset, u64 len, ulong blksz)
+{
+	return false;
+}
+
+static inline bool fastboot_blockhash_write(struct blk_desc *dev_desc,
+					    lbaint_t start,
+					    const char *part_name, u64 offset,
+					    void *download_buffer,
+					    u32 download_bytes, char *response)
+{
+	return false;
+}
+#endif
+
 #endif
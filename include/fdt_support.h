@@ -411,6 +411,177 @@ int fdt_valid(struct fdt_header **blobp);
  */
 int fdt_get_cells_len(const void *blob, char *nr_cells_name);
 
+/* Number of node paths which an editing session remembers */
+#define FDT_EDIT_MAX_NODES	16
+
+/**
+ * struct fdt_edit_node - A node looked up by path in an editing session
+ *
+ * @path: Path of the node (not copied, so must remain valid)
+ * @offset: Offset of the node in the FDT
+ */
+struct fdt_edit_node {
+	const char *path;
+	int offset;
+};
+
+/**
+ * struct fdt_edit_prop - A property change waiting to be applied
+ *
+ * @node: Offset of the node containing the property
+ * @name: Property name, stored after the structure
+ * @val: Property value, stored after the name
+ * @len: Length of the value in bytes
+ * @pos: Offset in the FDT struct block where the property is written (only
+ *	valid while applying)
+ * @old_size: Size of the property being replaced, in the struct block, or 0
+ *	if it is new (only valid while applying)
+ * @nameoff: Offset of the name in the strings block (only valid while
+ *	applying)
+ */
+struct fdt_edit_prop {
+	int node;
+	const char *name;
+	void *val;
+	int len;
+	int pos;
+	int old_size;
+	int nameoff;
+};
+
+/**
+ * struct fdt_edit - An FDT editing session
+ *
+ * Setting properties one at a time with fdt_setprop() moves the rest of the
+ * FDT each time a property is added or grows, and fixups which look up nodes
+ * by path scan the tree from the root each time. An editing session avoids
+ * both: node offsets are looked up once and remembered, and property changes
+ * are queued and then written in a single pass over the FDT.
+ *
+ * Nodes must not be added or removed while a session has queued changes.
+ *
+ * @fdt: FDT being edited
+ * @nodes: Nodes looked up so far
+ * @num_nodes: Number of entries in @nodes
+ * @props: Queued property changes
+ * @num_props: Number of entries in @props
+ * @max_props: Number of entries allocated in @props
+ * @err: First error which happened while queueing changes, or 0
+ * @in_place: true to make the changes one at a time with fdt_setprop(), as is
+ *	done when there is no memory for a single pass (used for testing)
+ */
+struct fdt_edit {
+	void *fdt;
+	struct fdt_edit_node nodes[FDT_EDIT_MAX_NODES];
+	int num_nodes;
+	struct fdt_edit_prop **props;
+	int num_props;
+	int max_props;
+	int err;
+	bool in_place;
+};
+
+/**
+ * fdt_edit_open() - Start an editing session
+ *
+ * @edit: Session to set up
+ * @fdt: FDT to edit
+ * @add_len: Number of bytes to add to the FDT size, to allow room for the
+ *	changes (the buffer must be large enough), or 0 to use the existing
+ *	free space
+ * Return: 0 if OK, -FDT_ERR_... on error
+ */
+int fdt_edit_open(struct fdt_edit *edit, void *fdt, int add_len);
+
+/**
+ * fdt_edit_node() - Find a node by path
+ *
+ * The offset is remembered, so later lookups of the same path (compared by
+ * string) do not scan the FDT again.
+ *
+ * @edit: Editing session
+ * @path: Path to the node. This is not copied, so must remain valid until
+ *	the session is closed.
+ * Return: node offset, or -FDT_ERR_... on error
+ */
+int fdt_edit_node(struct fdt_edit *edit, const char *path);
+
+/**
+ * fdt_edit_setprop() - Queue a change to a property
+ *
+ * The property is added if it does not exist, or replaced if it does. If it
+ * is set more than once in the same session, the last value is used. Any
+ * error is also recorded in the session and returned by fdt_edit_close().
+ *
+ * @edit: Editing session
+ * @node: Node offset, e.g. from fdt_edit_node()
+ * @name: Property name (copied)
+ * @val: Property value (copied)
+ * @len: Length of @val in bytes
+ * Return: 0 if OK, -FDT_ERR_NOSPACE if out of memory
+ */
+int fdt_edit_setprop(struct fdt_edit *edit, int node, const char *name,
+		     const void *val, int len);
+
+/**
+ * fdt_edit_setprop_u32() - Queue a change to a 32-bit integer property
+ *
+ * @edit: Editing session
+ * @node: Node offset
+ * @name: Property name
+ * @val: Value to set, in CPU byte order
+ * Return: 0 if OK, -FDT_ERR_NOSPACE if out of memory
+ */
+static inline int fdt_edit_setprop_u32(struct fdt_edit *edit, int node,
+				       const char *name, u32 val)
+{
+	fdt32_t tmp = cpu_to_fdt32(val);
+
+	return fdt_edit_setprop(edit, node, name, &tmp, sizeof(tmp));
+}
+
+/**
+ * fdt_edit_setprop_string() - Queue a change to a string property
+ *
+ * @edit: Editing session
+ * @node: Node offset
+ * @name: Property name
+ * @str: String to set, including the terminator
+ * Return: 0 if OK, -FDT_ERR_NOSPACE if out of memory
+ */
+static inline int fdt_edit_setprop_string(struct fdt_edit *edit, int node,
+					  const char *name, const char *str)
+{
+	return fdt_edit_setprop(edit, node, name, str, strlen(str) + 1);
+}
+
+/**
+ * fdt_edit_apply() - Write all queued changes to the FDT
+ *
+ * The changes are written in a single pass. Node offsets remembered by the
+ * session are updated to allow for the changes, so the session can continue
+ * to be used.
+ *
+ * A change which fails does not stop the others. If they do not all fit, or
+ * there is no memory for a single pass, they are made one at a time with
+ * fdt_setprop() and the remembered node offsets are forgotten.
+ *
+ * @edit: Editing session
+ * Return: 0 if OK, else the first error, e.g. -FDT_ERR_NOSPACE if the FDT
+ *	is too small
+ */
+int fdt_edit_apply(struct fdt_edit *edit);
+
+/**
+ * fdt_edit_close() - Apply any queued changes and end the session
+ *
+ * The queued changes are applied even if queueing some other change failed.
+ *
+ * @edit: Editing session
+ * Return: 0 if OK, else the first error from queueing or applying changes
+ */
+int fdt_edit_close(struct fdt_edit *edit);
+
 #endif /* ifdef CONFIG_OF_LIBFDT */
 
 #ifdef USE_HOSTCC
@@ -9,6 +9,22 @@
 
 #define ROUNDUP(x, y)	(((x) + ((y) - 1)) & ~((y) - 1))
 
+/**
+ * struct sparse_storage - where and how to write a sparse image
+ *
+ * @blksz: block size of the storage
+ * @start: first block of the partition
+ * @size: size of the partition in blocks
+ * @erase_size: blocks that @erase works on at a time, erased ranges are
+ *		aligned to it. 0 if there is no such constraint.
+ * @priv: private data of the storage
+ * @write: write blocks
+ * @erase: optional, discard blocks so that they read back as zero. Runs of
+ *	   zero FILL and DONT_CARE chunks are discarded with it instead of
+ *	   written. If it fails, zeros are written from then on.
+ * @reserve: skip blocks that the image does not care about
+ * @mssg: report an error
+ */
 struct sparse_storage {
 	lbaint_t	blksz;
 	lbaint_t	start;
@@ -8,10 +8,14 @@
 void __udelay(unsigned long usec);
 void udelay(unsigned long usec);
 
+#if CONFIG_IS_ENABLED(DELAY_STATS)
+void mdelay(unsigned long msec);
+#else
 static inline void mdelay(unsigned long msec)
 {
 	udelay(1000 * msec);
 }
+#endif
 
 static inline void ndelay(unsigned long nsec)
 {
@@ -6,6 +6,7 @@
 #ifndef _LINUX_IOPOLL_H
 #define _LINUX_IOPOLL_H
 
+#include <delay_stats.h>
 #include <linux/delay.h>
 #include <linux/errno.h>
 #include <linux/io.h>
@@ -29,6 +30,8 @@
 #define read_poll_timeout(op, val, cond, sleep_us, timeout_us, args...)	\
 ({ \
 	unsigned long timeout = timer_get_us() + timeout_us; \
+	__maybe_unused u64 __start = delay_stats_start(); \
+	int __ret; \
 	for (;;) { \
 		(val) = op(args); \
 		if (cond) \
@@ -40,7 +43,9 @@
 		if (sleep_us) \
 			udelay(sleep_us); \
 	} \
-	(cond) ? 0 : -ETIMEDOUT; \
+	__ret = (cond) ? 0 : -ETIMEDOUT; \
+	delay_stats_poll(__start, __ret); \
+	__ret; \
 })
 
 #define readx_poll_sleep_timeout(op, addr, val, cond, sleep_us, timeout_us) \
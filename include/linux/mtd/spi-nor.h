@@ -281,6 +281,20 @@ static inline u8 spi_nor_get_protocol_width(enum spi_nor_protocol proto)
 }
 
 #define SPI_NOR_MAX_CMD_SIZE	8
+
+/* Erase Types 1 to 4 of the SFDP Basic Flash Parameter Table */
+#define SNOR_ERASE_TYPE_MAX	4
+
+/**
+ * struct spi_nor_erase_type - an erase command the flash supports
+ * @size:	size of the sector the command erases, 0 if not supported
+ * @opcode:	the erase opcode
+ */
+struct spi_nor_erase_type {
+	u32	size;
+	u8	opcode;
+};
+
 enum spi_nor_ops {
 	SPI_NOR_OPS_READ = 0,
 	SPI_NOR_OPS_WRITE,
@@ -495,6 +509,8 @@ struct spi_flash {
  * @page_size:		the page size of the SPI NOR
  * @addr_width:		number of address bytes
  * @erase_opcode:	the opcode for erasing a sector
+ * @erase_types:	the erase commands of the flash; an erase request
+ *			uses the largest one that fits at each address
  * @read_opcode:	the read opcode
  * @read_dummy:		the dummy needed by the read operation
  * @program_opcode:	the program opcode
@@ -541,6 +557,7 @@ struct spi_nor {
 	u32			page_size;
 	u8			addr_width;
 	u8			erase_opcode;
+	struct spi_nor_erase_type erase_types[SNOR_ERASE_TYPE_MAX];
 	u8			read_opcode;
 	u8			read_dummy;
 	u8			program_opcode;
@@ -213,6 +213,8 @@ static inline bool mmc_is_tuning_cmd(uint cmdidx)
 /*
  * EXT_CSD fields
  */
+#define EXT_CSD_FLUSH_CACHE		32	/* W */
+#define EXT_CSD_CACHE_CTRL		33	/* R/W */
 #define EXT_CSD_ENH_START_ADDR		136	/* R/W */
 #define EXT_CSD_ENH_SIZE_MULT		140	/* R/W */
 #define EXT_CSD_GP_SIZE_MULT		143	/* R/W */
@@ -231,6 +233,7 @@ static inline bool mmc_is_tuning_cmd(uint cmdidx)
 #define EXT_CSD_ERASE_GROUP_DEF		175	/* R/W */
 #define EXT_CSD_BOOT_BUS_WIDTH		177
 #define EXT_CSD_PART_CONF		179	/* R/W */
+#define EXT_CSD_ERASED_MEM_CONT		181	/* RO */
 #define EXT_CSD_BUS_WIDTH		183	/* R/W */
 #define EXT_CSD_STROBE_SUPPORT		184	/* R/W */
 #define EXT_CSD_HS_TIMING		185	/* R/W */
@@ -242,6 +245,7 @@ static inline bool mmc_is_tuning_cmd(uint cmdidx)
 #define EXT_CSD_HC_ERASE_GRP_SIZE	224	/* RO */
 #define EXT_CSD_BOOT_MULT		226	/* RO */
 #define EXT_CSD_GENERIC_CMD6_TIME       248     /* RO */
+#define EXT_CSD_CACHE_SIZE		249	/* RO, 4 bytes */
 #define EXT_CSD_BKOPS_SUPPORT		502	/* RO */
 
 /*
@@ -896,6 +900,28 @@ int mmc_rpmb_route_frames(struct mmc *mmc, void *req, unsigned long reqlen,
 int mmc_set_bkops_enable(struct mmc *mmc);
 #endif
 
+/**
+ * mmc_set_cache() - turn the eMMC write cache on or off
+ *
+ * Writes are acknowledged once they are in the cache, so the cache has to
+ * be flushed, or turned off, before the data is relied upon. Turning it off
+ * flushes it first.
+ *
+ * @mmc:	MMC device
+ * @enable:	true to turn the cache on
+ * Return: 0 on success, -EOPNOTSUPP when turning on the cache of a device
+ * that has none, or another negative error
+ */
+int mmc_set_cache(struct mmc *mmc, bool enable);
+
+/**
+ * mmc_flush_cache() - write the eMMC write cache back to the flash
+ *
+ * @mmc:	MMC device
+ * Return: 0 on success, or if the cache is off, negative error otherwise
+ */
+int mmc_flush_cache(struct mmc *mmc);
+
 /**
  * Start device initialization and return immediately; it does not block on
  * polling OCR (operation condition register) status. Useful for checking
@@ -1013,6 +1039,7 @@ static inline enum dma_data_direction mmc_get_dma_dir(struct mmc_data *data)
 }
 
 #define SD_SCR_CMD23_SUPPORT   (1<<1)
+#define SD_SCR_DATA_STAT_AFTER_ERASE   (1<<23)
 static inline bool mmc_support_cmd23(struct mmc *mmc)
 {
 	return ((IS_SD(mmc) && (mmc->scr[0] & SD_SCR_CMD23_SUPPORT)) ||
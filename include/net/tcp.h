@@ -0,0 +1,232 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Minimal TCP client, for downloading files over HTTP
+ */
+
+#ifndef __TCP_H__
+#define __TCP_H__
+
+#include <net.h>
+
+/*
+ *	Internet Protocol (IP) + TCP header, without options
+ */
+struct ip_tcp_hdr {
+	u8		ip_hl_v;	/* header length and version	*/
+	u8		ip_tos;		/* type of service		*/
+	u16		ip_len;		/* total length			*/
+	u16		ip_id;		/* identification		*/
+	u16		ip_off;		/* fragment offset field	*/
+	u8		ip_ttl;		/* time to live			*/
+	u8		ip_p;		/* protocol			*/
+	u16		ip_sum;		/* checksum			*/
+	struct in_addr	ip_src;		/* Source IP address		*/
+	struct in_addr	ip_dst;		/* Destination IP address	*/
+	u16		tcp_src;	/* TCP source port		*/
+	u16		tcp_dst;	/* TCP destination port		*/
+	u32		tcp_seq;	/* sequence number		*/
+	u32		tcp_ack;	/* acknowledgment number	*/
+	u8		tcp_hlen;	/* header length (upper 4 bits)	*/
+	u8		tcp_flags;	/* flags			*/
+	u16		tcp_win;	/* window size			*/
+	u16		tcp_xsum;	/* checksum			*/
+	u16		tcp_ugr;	/* urgent pointer		*/
+} __attribute__((packed));
+
+#define IP_TCP_HDR_SIZE		(sizeof(struct ip_tcp_hdr))
+#define TCP_HDR_SIZE		(IP_TCP_HDR_SIZE - IP_HDR_SIZE)
+
+/* TCP flags, also used as the @action for net_send_ip_packet() */
+#define TCP_FIN		0x01
+#define TCP_SYN		0x02
+#define TCP_RST		0x04
+#define TCP_PUSH	0x08
+#define TCP_ACK		0x10
+
+/* TCP options */
+#define TCP_O_END	0
+#define TCP_O_NOP	1
+#define TCP_O_MSS	2
+#define TCP_O_WS	3
+
+/* Largest segment we accept: the Ethernet MTU less the IP and TCP headers */
+#define TCP_MSS		(1500 - IP_TCP_HDR_SIZE)
+
+/* Largest payload which tcp_send() accepts */
+#define TCP_TX_MAX	512
+
+/**
+ * enum tcp_state - state of the connection
+ *
+ * Only the states needed by an active opener which receives most of the
+ * data are used.
+ *
+ * @TCP_CLOSED: No connection
+ * @TCP_SYN_SENT: SYN sent, waiting for SYN+ACK
+ * @TCP_ESTABLISHED: Connection open
+ * @TCP_CLOSE_WAIT: The peer has sent FIN; we can still send
+ */
+enum tcp_state {
+	TCP_CLOSED,
+	TCP_SYN_SENT,
+	TCP_ESTABLISHED,
+	TCP_CLOSE_WAIT,
+};
+
+/**
+ * enum tcp_event - events reported to the tcp handler
+ *
+ * @TCP_EV_CONNECTED: The connection is open and data can be sent
+ * @TCP_EV_DATA: Data has been received
+ * @TCP_EV_CLOSED: The peer has closed its side of the connection
+ * @TCP_EV_RESET: The connection was reset, or could not be opened
+ */
+enum tcp_event {
+	TCP_EV_CONNECTED,
+	TCP_EV_DATA,
+	TCP_EV_CLOSED,
+	TCP_EV_RESET,
+};
+
+/**
+ * struct tcp_stats - statistics for the current connection
+ *
+ * @segs: Number of data segments received
+ * @ooo_segs: Number of segments received out of order
+ * @dup_segs: Number of segments received which were already acknowledged
+ * @acks: Number of ACKs sent
+ * @dup_acks: Number of duplicate ACKs sent, to request a fast retransmit
+ * @retransmits: Number of segments which we had to retransmit
+ */
+struct tcp_stats {
+	u32 segs;
+	u32 ooo_segs;
+	u32 dup_segs;
+	u32 acks;
+	u32 dup_acks;
+	u32 retransmits;
+};
+
+/**
+ * rxhand_tcp() - handler for TCP events
+ *
+ * For @TCP_EV_DATA, data is normally passed in order, and tcp_get_rx_len()
+ * already includes it. Data which arrives after a lost segment is also
+ * passed, if the handler can store it directly at its offset; this saves the
+ * peer retransmitting it once the gap is filled. The handler may call
+ * tcp_close() or tcp_abort().
+ *
+ * @event: Event which happened (enum tcp_event)
+ * @offset: Offset of @data in the received stream (TCP_EV_DATA only)
+ * @data: Received data (TCP_EV_DATA only)
+ * @len: Length of @data (TCP_EV_DATA only)
+ * Return: 0 if OK, -EAGAIN if out-of-order data could not be stored, other
+ * -ve error to reset the connection
+ */
+typedef int rxhand_tcp(enum tcp_event event, ulong offset, const uchar *data,
+		       uint len);
+
+/**
+ * tcp_set_tcp_header() - Set up the IP and TCP headers for a segment
+ *
+ * Called by net_send_ip_packet(). SYN segments have the MSS and window scale
+ * options appended; these overwrite the start of the payload, which must be
+ * empty.
+ *
+ * @pkt: Start of the IP header
+ * @dest: Destination IP address
+ * @dport: Destination port
+ * @sport: Source port
+ * @payload_len: Length of data after the TCP header
+ * @action: TCP flags to send
+ * @tcp_seq_num: Sequence number
+ * @tcp_ack_num: Acknowledgment number
+ * Return: size of the IP and TCP headers, including options
+ */
+int tcp_set_tcp_header(uchar *pkt, struct in_addr dest, int dport, int sport,
+		       int payload_len, u8 action, u32 tcp_seq_num,
+		       u32 tcp_ack_num);
+
+/**
+ * tcp_receive() - Process a received TCP segment
+ *
+ * @ip: Start of the IP header
+ * @len: Length of the IP datagram
+ */
+void tcp_receive(struct ip_tcp_hdr *ip, int len);
+
+/**
+ * tcp_set_tcp_handler() - Set the handler for TCP events
+ *
+ * @f: Handler to use, or NULL for none
+ */
+void tcp_set_tcp_handler(rxhand_tcp *f);
+
+/**
+ * tcp_connect() - Start opening a connection
+ *
+ * The handler is called with @TCP_EV_CONNECTED once it is open. Any previous
+ * connection is forgotten. This must be called from within net_loop().
+ *
+ * @dest: IP address of the server
+ * @dport: Port to connect to
+ */
+void tcp_connect(struct in_addr dest, int dport);
+
+/**
+ * tcp_send() - Send data on the connection
+ *
+ * The data is copied so that it can be retransmitted if needed. Only one
+ * send can be outstanding at a time.
+ *
+ * @data: Data to send
+ * @len: Length of data, at most TCP_TX_MAX
+ * Return: 0 if OK, -ENOTCONN if not connected, -EBUSY if previous data is not
+ * yet acknowledged, -E2BIG if @len is too large
+ */
+int tcp_send(const void *data, uint len);
+
+/**
+ * tcp_close() - Close the connection
+ *
+ * This sends FIN but does not wait for the peer to close its side; any more
+ * data from the peer is ignored.
+ */
+void tcp_close(void);
+
+/**
+ * tcp_abort() - Reset the connection and forget about it
+ */
+void tcp_abort(void);
+
+/**
+ * tcp_poll() - Handle timers for the connection
+ *
+ * This sends delayed ACKs and retransmits unacknowledged segments. It is
+ * called from the net_loop() on each iteration.
+ */
+void tcp_poll(void);
+
+/**
+ * tcp_get_state() - Get the state of the connection
+ *
+ * Return: current state
+ */
+enum tcp_state tcp_get_state(void);
+
+/**
+ * tcp_get_rx_len() - Get the number of bytes received in order
+ *
+ * Return: length of the received stream, not counting any data held after a
+ * gap
+ */
+ulong tcp_get_rx_len(void);
+
+/**
+ * tcp_get_stats() - Get statistics for the connection
+ *
+ * Return: statistics for the current (or last) connection
+ */
+const struct tcp_stats *tcp_get_stats(void);
+
+#endif /* __TCP_H__ */
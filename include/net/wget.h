@@ -0,0 +1,71 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * HTTP client, for downloading files over TCP
+ */
+
+#ifndef __WGET_H__
+#define __WGET_H__
+
+#include <linux/types.h>
+
+/* Default HTTP port */
+#define WGET_HTTP_PORT		80
+
+/**
+ * wget_start() - Start an HTTP download
+ *
+ * This is called by net_loop() for the WGET protocol. The file named by
+ * net_boot_file_name, in the form [host:]path, is downloaded to
+ * image_load_addr.
+ */
+void wget_start(void);
+
+#if defined(CONFIG_CMD_WGET)
+
+/**
+ * wget_set_range() - Download only part of the next file
+ *
+ * This applies to the next download only: the wget command resets it once
+ * the download finishes. The server must support range requests, or the
+ * download fails (unless @offset is 0, in which case the whole file is
+ * accepted).
+ *
+ * @offset: Offset of the first byte to download
+ * @size: Number of bytes to download, or 0 for the rest of the file
+ */
+void wget_set_range(ulong offset, ulong size);
+
+/**
+ * wget_get_total_size() - Get the size of the file last downloaded
+ *
+ * For a range request, this is the size of the whole file as reported by the
+ * server, not just the part which was downloaded.
+ *
+ * Return: size in bytes, or 0 if not known
+ */
+ulong wget_get_total_size(void);
+
+/**
+ * wget_get_status() - Get the HTTP status of the last download
+ *
+ * Return: HTTP status code (e.g. 200 or 404), or 0 if there was no response
+ */
+int wget_get_status(void);
+
+#else
+
+static inline void wget_set_range(ulong offset, ulong size) {}
+
+static inline ulong wget_get_total_size(void)
+{
+	return 0;
+}
+
+static inline int wget_get_status(void)
+{
+	return 0;
+}
+
+#endif
+
+#endif /* __WGET_H__ */
@@ -365,4 +365,15 @@ void serial_puts(const char *str);
 int serial_getc(void);
 int serial_tstc(void);
 
+/**
+ * serial_try_putc() - Write a character to the serial console, without waiting
+ *
+ * No '\r' is added before '\n'; the caller must do that if needed.
+ *
+ * @ch: Character to write
+ * Return: 0 if OK, -EAGAIN if the UART has no room for it (try again later),
+ *	-ENODEV if there is no serial console, other -ve on error
+ */
+int serial_try_putc(const char ch);
+
 #endif
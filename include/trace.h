@@ -36,9 +36,13 @@ struct trace_output_func {
 	uint32_t call_count;		/* Number of times called */
 };
 
-/* A header at the start of the trace output buffer */
+/*
+ * A header at the start of each chunk in the trace output buffer. There is a
+ * TRACE_CHUNK_CALLS chunk for each CPU which made any calls.
+ */
 struct trace_output_hdr {
 	enum trace_chunk_type type;	/* Record type */
+	uint32_t cpu;			/* CPU number, for TRACE_CHUNK_CALLS */
 	size_t rec_count;		/* Number of records */
 };
 
@@ -77,6 +81,17 @@ struct trace_call {
 	uint32_t flags;		/* Flags and timestamp */
 };
 
+/**
+ * Dump the function call records into a buffer
+ *
+ * This writes a chunk for each CPU, each with a struct trace_output_hdr and
+ * then the struct trace_call records. Timestamps are in microseconds.
+ *
+ * @param buff		Buffer in which to place data, or NULL to count size
+ * @param buff_size	Size of buffer
+ * @param needed	Returns number of bytes used / needed
+ * Return: 0 if ok, -ENOSPC if the buffer is too small
+ */
 int trace_list_calls(void *buff, size_t buff_size, size_t *needed);
 
 /**
@@ -85,6 +85,20 @@ uint32_t crc32_wd(uint32_t crc, const unsigned char *buf, uint len,
  */
 uint32_t crc32_no_comp(uint32_t crc, const unsigned char *buf, uint len);
 
+/**
+ * crc32_table_update() - Calculate CRC32 with the table only
+ *
+ * This gives the same result as crc32_no_comp(), but never uses the CPU's
+ * CRC or carry-less multiply instructions. It serves as a reference for
+ * testing those, and handles the lengths they do not.
+ *
+ * @crc: Input crc to chain from a previous calculation
+ * @buf: Bytes to checksum
+ * @len: Number of bytes to checksum
+ * Return: checksum value
+ */
+uint32_t crc32_table_update(uint32_t crc, const unsigned char *buf, uint len);
+
 /**
  * crc32_wd_buf - Perform CRC32 on a buffer and return result in buffer
  *
@@ -96,6 +110,37 @@ uint32_t crc32_no_comp(uint32_t crc, const unsigned char *buf, uint len);
 void crc32_wd_buf(const uint8_t *input, uint ilen, uint8_t *output,
 		  uint chunk_sz);
 
+/* lib/crc32_clmul.c */
+
+/* Minimum length for which the CLMUL versions are worth setting up */
+#define CRC32_CLMUL_MIN		64
+
+/**
+ * crc32_clmul() - Calculate CRC32 using carry-less multiplication
+ *
+ * This gives the same result as crc32_no_comp(), i.e. there is no one's
+ * complement on input or output.
+ *
+ * @crc: Input crc to chain from a previous calculation
+ * @buf: Bytes to checksum, which must be 8-byte aligned
+ * @len: Number of bytes to checksum, which must be a non-zero multiple of 16
+ * Return: checksum value
+ */
+uint32_t crc32_clmul(uint32_t crc, const uint8_t *buf, size_t len);
+
+/**
+ * crc32c_clmul() - Calculate CRC32C using carry-less multiplication
+ *
+ * This gives the same result as crc32c_cal() with a table set up for the
+ * Castagnoli polynomial (0x82f63b78).
+ *
+ * @crc: Input crc to chain from a previous calculation
+ * @buf: Bytes to checksum, which must be 8-byte aligned
+ * @len: Number of bytes to checksum, which must be a non-zero multiple of 16
+ * Return: checksum value
+ */
+uint32_t crc32c_clmul(uint32_t crc, const uint8_t *buf, size_t len);
+
 /* lib/crc32c.c */
 
 /**
@@ -123,4 +168,19 @@ void crc32c_init(uint32_t *crc32c_table, uint32_t pol);
 uint32_t crc32c_cal(uint32_t crc, const char *data, int length,
 		    uint32_t *crc32c_table);
 
+/**
+ * crc32c_table_update() - Perform CRC32 on a buffer with the table only
+ *
+ * This gives the same result as crc32c_cal(), but never uses carry-less
+ * multiplication, so it can be used to check that.
+ *
+ * @crc: Previous crc (use 0 at start)
+ * @data: Data bytes to checksum
+ * @length: Number of bytes to process
+ * @crc32c_table: CRC table
+ * Return: checksum value
+ */
+uint32_t crc32c_table_update(uint32_t crc, const char *data, int length,
+			     uint32_t *crc32c_table);
+
 #endif /* _UBOOT_CRC_H */
@@ -67,6 +67,25 @@ enum video_format {
 	VIDEO_X2R10G10B10,
 };
 
+/**
+ * struct video_damage - Region of the frame buffer changed since the last sync
+ *
+ * All drawing operations between two calls to video_sync() are merged into a
+ * single bounding rectangle. The region is empty when @xend <= @xstart or
+ * @yend <= @ystart.
+ *
+ * @xstart:	First damaged pixel column
+ * @ystart:	First damaged pixel row
+ * @xend:	Column after the last damaged pixel
+ * @yend:	Row after the last damaged pixel
+ */
+struct video_damage {
+	int xstart;
+	int ystart;
+	int xend;
+	int yend;
+};
+
 /**
  * struct video_priv - Device information used by the video uclass
  *
@@ -91,6 +110,12 @@ enum video_format {
  *		the LCD is updated
  * @fg_col_idx:	Foreground color code (bit 3 = bold, bit 0-2 = color)
  * @bg_col_idx:	Background color code (bit 3 = bold, bit 0-2 = color)
+ * @damage:	Region updated since the last video_sync() (only used with
+ *		CONFIG_VIDEO_DAMAGE)
+ * @scroll_base:	Start of the memory used for hardware scrolling, or NULL
+ *		if not supported. @fb moves forward through this memory as the
+ *		display scrolls; see video_scroll()
+ * @scroll_size:	Size of the memory at @scroll_base, in bytes
  */
 struct video_priv {
 	/* Things set up by the driver: */
@@ -115,6 +140,9 @@ struct video_priv {
 	bool flush_dcache;
 	u8 fg_col_idx;
 	u8 bg_col_idx;
+	struct video_damage damage;
+	void *scroll_base;
+	int scroll_size;
 };
 
 /**
@@ -124,9 +152,16 @@ struct video_priv {
  *		For these devices implement video_sync hook to call a sync
  *		function. vid is pointer to video device udevice. Function
  *		should return 0 on success video_sync and error code otherwise
+ * @set_base:	Set the address the display scans out from. This is used for
+ *		hardware scrolling: if the driver provides it and allocates
+ *		at least twice the frame-buffer size in struct video_uc_plat,
+ *		the uclass scrolls by moving the frame buffer forward instead
+ *		of copying it. fb is the new start of the visible frame
+ *		buffer. Returns 0 on success, else an error code
  */
 struct video_ops {
 	int (*video_sync)(struct udevice *vid);
+	int (*set_base)(struct udevice *vid, void *fb);
 };
 
 #define video_get_ops(dev)        ((struct video_ops *)(dev)->driver->ops)
@@ -199,6 +234,47 @@ void video_sync_all(void);
 int video_bmp_display(struct udevice *dev, ulong bmp_image, int x, int y,
 		      bool align);
 
+/**
+ * video_img_valid() - Check for a pre-converted splash image
+ *
+ * @img_addr:	Address of the image
+ * Return: true if there is a valid image header at @img_addr
+ */
+bool video_img_valid(ulong img_addr);
+
+/**
+ * video_img_display() - Display a pre-converted splash image
+ *
+ * This decompresses the image (see include/video_img.h) directly into the
+ * frame buffer. The image must use the pixel format of the display.
+ *
+ * @dev:	Device to display the image on
+ * @img_addr:	Address of the image
+ * @x:		X position in pixels from the left
+ * @y:		Y position in pixels from the top
+ * @align:	true to adjust the coordinates, as with video_bmp_display()
+ * Return: 0 if OK, -EINVAL if the image is not valid, -EPROTONOSUPPORT if it
+ *	does not match the display format, other -ve on error
+ */
+int video_img_display(struct udevice *dev, ulong img_addr, int x, int y,
+		      bool align);
+
+/**
+ * video_splash_align_axis() - Align a single coordinate
+ *
+ * - if a coordinate is 0x7fff then the image will be centred in
+ *   that direction
+ * - if a coordinate is -ve then it will be offset to the
+ *   left/top of the centre by that many pixels
+ * - if a coordinate is positive it will be used unchanged.
+ *
+ * @axis:	Input and output coordinate
+ * @panel_size:	Size of panel in pixels for that axis
+ * @picture_size:	Size of image in pixels for that axis
+ */
+void video_splash_align_axis(int *axis, unsigned long panel_size,
+			     unsigned long picture_size);
+
 /**
  * video_get_xsize() - Get the width of the display in pixels
  *
@@ -231,7 +307,39 @@ void video_set_flush_dcache(struct udevice *dev, bool flush);
  */
 void video_set_default_colors(struct udevice *dev, bool invert);
 
-#ifdef CONFIG_VIDEO_COPY
+/**
+ * video_scroll() - Scroll the display up by moving the scan-out address
+ *
+ * This moves the visible frame buffer forward by @lines pixel rows and fills
+ * the newly exposed rows at the bottom with the background colour. When the
+ * end of the scroll memory is reached, the visible part is copied back to the
+ * start, so most scrolls only touch the rows that are cleared.
+ *
+ * @vid:	Video device to scroll
+ * @lines:	Number of pixel rows to scroll by
+ * Return: 0 if OK, -ENOSYS if hardware scrolling is not available, -EINVAL
+ *	if @lines is out of range, other -ve on error
+ */
+int video_scroll(struct udevice *vid, int lines);
+
+/**
+ * video_damage() - Record that a region of the frame buffer has changed
+ *
+ * With CONFIG_VIDEO_DAMAGE the region is merged into the damage rectangle
+ * and the copy / cache flush is deferred to the next video_sync(). Otherwise
+ * the region is synced to the copy frame buffer straight away.
+ *
+ * The region is clipped to the display.
+ *
+ * @vid:	Video device being updated
+ * @x:		Left edge of the region, in pixels
+ * @y:		Top edge of the region, in pixels
+ * @width:	Width of the region, in pixels
+ * @height:	Height of the region, in pixels
+ */
+void video_damage(struct udevice *vid, int x, int y, int width, int height);
+
+#if defined(CONFIG_VIDEO_COPY) || defined(CONFIG_VIDEO_DAMAGE)
 /**
  * vidconsole_sync_copy() - Sync back to the copy framebuffer
  *
@@ -240,6 +348,10 @@ void video_set_default_colors(struct udevice *dev, bool invert);
  *
  * @from and @to can be in either order. The region between them is synced.
  *
+ * With CONFIG_VIDEO_DAMAGE the copy is not done immediately. Instead the
+ * frame-buffer lines covering the region are marked as damaged and are
+ * copied by the next video_sync().
+ *
  * @dev: Vidconsole device being updated
  * @from: Start/end address within the framebuffer (->fb)
  * @to: Other address within the frame buffer
@@ -256,7 +256,20 @@ void vidconsole_position_cursor(struct udevice *dev, unsigned col,
  */
 u32 vid_console_color(struct video_priv *priv, unsigned int idx);
 
-#ifdef CONFIG_VIDEO_COPY
+/**
+ * console_truetype_set_glyph_cache() - Select whether to use the glyph cache
+ *
+ * The TrueType console uses its glyph cache if
+ * CONFIG_CONSOLE_TRUETYPE_GLYPH_CACHE is enabled. On sandbox the cache can be
+ * turned on with this for testing, without changing the output of other
+ * tests. Elsewhere it can only be turned off.
+ *
+ * @dev:	TrueType console device
+ * @enable:	true to use the glyph cache
+ */
+void console_truetype_set_glyph_cache(struct udevice *dev, bool enable);
+
+#if defined(CONFIG_VIDEO_COPY) || defined(CONFIG_VIDEO_DAMAGE)
 /**
  * vidconsole_sync_copy() - Sync back to the copy framebuffer
  *
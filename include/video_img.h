@@ -0,0 +1,52 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Layout of a pre-converted splash image
+ *
+ * The pixel data is stored in the native frame-buffer format of the panel
+ * (one of enum video_log2_bpp / enum video_format), row after row with no
+ * padding, optionally compressed as a single LZ4 frame. This allows it to be
+ * decompressed straight into the frame buffer without any per-pixel
+ * conversion. Images are created with tools/mkvideoimg.py
+ */
+
+#ifndef _VIDEO_IMG_H_
+#define _VIDEO_IMG_H_
+
+#include <linux/types.h>
+
+#define VIDEO_IMG_MAGIC		"UVIM"
+#define VIDEO_IMG_MAGIC_LEN	4
+
+enum video_img_comp {
+	VIDEO_IMG_COMP_NONE	= 0,
+	VIDEO_IMG_COMP_LZ4,
+};
+
+/**
+ * struct video_img_header - Header of a pre-converted splash image
+ *
+ * All fields are little-endian
+ *
+ * @magic:	VIDEO_IMG_MAGIC
+ * @hdr_size:	Size of this header, i.e. offset of the pixel data
+ * @data_size:	Size of the (possibly compressed) pixel data in bytes
+ * @width:	Image width in pixels
+ * @height:	Image height in pixels
+ * @bpix:	Pixel depth (enum video_log2_bpp)
+ * @format:	Pixel format (enum video_format)
+ * @comp:	Compression of the pixel data (enum video_img_comp)
+ * @reserved:	Must be zero
+ */
+struct __packed video_img_header {
+	char magic[VIDEO_IMG_MAGIC_LEN];
+	__le32 hdr_size;
+	__le32 data_size;
+	__le16 width;
+	__le16 height;
+	u8 bpix;
+	u8 format;
+	u8 comp;
+	u8 reserved;
+};
+
+#endif
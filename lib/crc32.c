@@ -179,17 +179,10 @@ const uint32_t * ZEXPORT get_crc_table()
 
 /* ========================================================================= */
 
-/* No ones complement version. JFFS2 (and other things ?)
- * don't use ones compliment in their CRC calculations.
- */
-uint32_t __efi_runtime crc32_no_comp(uint32_t crc, const Bytef *buf, uInt len)
+#ifndef CONFIG_ARM64_CRC32
+uint32_t __efi_runtime crc32_table_update(uint32_t crc, const Bytef *buf,
+					  uInt len)
 {
-#ifdef CONFIG_ARM64_CRC32
-    crc = cpu_to_le32(crc);
-    while (len--)
-        crc = __builtin_aarch64_crc32b(crc, *buf++);
-    return le32_to_cpu(crc);
-#else
     const uint32_t *tab = crc_table;
     const uint32_t *b =(const uint32_t *)buf;
     size_t rem_len;
@@ -227,6 +220,37 @@ uint32_t __efi_runtime crc32_no_comp(uint32_t crc, const Bytef *buf, uInt len)
     }
 
     return le32_to_cpu(crc);
+}
+#endif
+
+/* No ones complement version. JFFS2 (and other things ?)
+ * don't use ones compliment in their CRC calculations.
+ */
+uint32_t __efi_runtime crc32_no_comp(uint32_t crc, const Bytef *buf, uInt len)
+{
+#ifdef CONFIG_ARM64_CRC32
+    crc = cpu_to_le32(crc);
+    while (len--)
+        crc = __builtin_aarch64_crc32b(crc, *buf++);
+    return le32_to_cpu(crc);
+#else
+#if defined(CONFIG_CRC32_CLMUL) && defined(CONFIG_RISCV_ISA_ZBC) && \
+	!defined(USE_HOSTCC)
+    if (len >= CRC32_CLMUL_MIN) {
+	 uInt head = -(ulong)buf & 7;
+	 uInt n;
+
+	 /* Align it for 64-bit loads, then fold 16 bytes at a time */
+	 crc = crc32_table_update(crc, buf, head);
+	 buf += head;
+	 len -= head;
+	 n = len & ~15;
+	 crc = crc32_clmul(crc, buf, n);
+	 buf += n;
+	 len -= n;
+    }
+#endif
+    return crc32_table_update(crc, buf, len);
 #endif
 }
 #undef DO_CRC
@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * CRC32 and CRC32C using carry-less multiplication
+ *
+ * The data is folded 16 bytes at a time into a 128-bit accumulator, which is
+ * then reduced to the 32-bit CRC with two Barrett reductions. Everything is
+ * bit-reflected, as for the table-driven versions in crc32.c and crc32c.c.
+ *
+ * The constants are, with P the CRC polynomial and rev64() reversing the bit
+ * order of a 64-bit value:
+ *
+ *	fold_lo = rev64(x^191 mod P)
+ *	fold_hi = rev64(x^127 mod P)
+ *	quot    = rev64(floor(x^96 / P), without its x^64 term)
+ *	poly    = P, bit-reflected, without its x^32 term
+ *
+ * The powers are one less than the fold distance, since the product of two
+ * reflected values comes out one bit lower than a plain carry-less multiply.
+ */
+
+#include <common.h>
+#include <efi_loader.h>
+#include <u-boot/crc.h>
+
+struct crc32_clmul_consts {
+	u64 fold_lo;
+	u64 fold_hi;
+	u64 quot;
+	u64 poly;
+};
+
+static const struct crc32_clmul_consts __efi_runtime_rodata crc32_consts = {
+	.fold_lo	= 0x65673b4600000000ULL,
+	.fold_hi	= 0x9ba54c6f00000000ULL,
+	.quot		= 0x5a72d812fb808b20ULL,
+	.poly		= 0xedb88320,
+};
+
+static const struct crc32_clmul_consts __efi_runtime_rodata crc32c_consts = {
+	.fold_lo	= 0x3743f7bd00000000ULL,
+	.fold_hi	= 0x3171d43000000000ULL,
+	.quot		= 0xa434f61c6f5389f8ULL,
+	.poly		= 0x82f63b78,
+};
+
+#ifdef CONFIG_RISCV_ISA_ZBC
+static inline u64 clmul(u64 a, u64 b)
+{
+	u64 r;
+
+	asm ("clmul %0, %1, %2" : "=r" (r) : "r" (a), "r" (b));
+
+	return r;
+}
+
+static inline u64 clmulh(u64 a, u64 b)
+{
+	u64 r;
+
+	asm ("clmulh %0, %1, %2" : "=r" (r) : "r" (a), "r" (b));
+
+	return r;
+}
+
+static inline u64 clmulr(u64 a, u64 b)
+{
+	u64 r;
+
+	asm ("clmulr %0, %1, %2" : "=r" (r) : "r" (a), "r" (b));
+
+	return r;
+}
+#else
+/*
+ * Plain C versions, so that the algorithm can be checked on sandbox. These
+ * are much slower than the table, so crc32() does not use them.
+ */
+static u64 __efi_runtime clmul_full(u64 a, u64 b, u64 *hi)
+{
+	u64 lo = 0, h = 0;
+	int i;
+
+	for (i = 0; i < 64; i++) {
+		if (b & (1ULL << i)) {
+			lo ^= a << i;
+			if (i)
+				h ^= a >> (64 - i);
+		}
+	}
+	*hi = h;
+
+	return lo;
+}
+
+static inline u64 clmul(u64 a, u64 b)
+{
+	u64 hi;
+
+	return clmul_full(a, b, &hi);
+}
+
+static inline u64 clmulh(u64 a, u64 b)
+{
+	u64 hi;
+
+	clmul_full(a, b, &hi);
+
+	return hi;
+}
+
+/* bits 63..126 of the product */
+static inline u64 clmulr(u64 a, u64 b)
+{
+	u64 hi, lo;
+
+	lo = clmul_full(a, b, &hi);
+
+	return hi << 1 | lo >> 63;
+}
+#endif
+
+/* Reduce 64 bits of message, with the CRC already added in, to a new CRC */
+static inline u32 __efi_runtime
+crc32_barrett(u64 s, const struct crc32_clmul_consts *k)
+{
+	u64 t;
+
+	t = clmul(s, k->quot) << 1;
+	t ^= s;
+
+	return clmulr(t, k->poly << 32) >> 32;
+}
+
+/* @buf must be 8-byte aligned and @len a non-zero multiple of 16 */
+static u32 __efi_runtime crc32_fold(u32 crc, const u8 *buf, size_t len,
+				    const struct crc32_clmul_consts *k)
+{
+	const u64 *p = (const u64 *)buf;
+	const u64 *end = p + len / sizeof(u64);
+	u64 x0, x1, n0, n1;
+
+	x0 = le64_to_cpu(p[0]) ^ crc;
+	x1 = le64_to_cpu(p[1]);
+	for (p += 2; p < end; p += 2) {
+		n0 = clmul(x0, k->fold_lo) ^ clmul(x1, k->fold_hi);
+		n1 = clmulh(x0, k->fold_lo) ^ clmulh(x1, k->fold_hi);
+		x0 = n0 ^ le64_to_cpu(p[0]);
+		x1 = n1 ^ le64_to_cpu(p[1]);
+	}
+
+	crc = crc32_barrett(x0, k);
+
+	return crc32_barrett(x1 ^ crc, k);
+}
+
+uint32_t __efi_runtime crc32_clmul(uint32_t crc, const uint8_t *buf,
+				   size_t len)
+{
+	return crc32_fold(crc, buf, len, &crc32_consts);
+}
+
+uint32_t __efi_runtime crc32c_clmul(uint32_t crc, const uint8_t *buf,
+				    size_t len)
+{
+	return crc32_fold(crc, buf, len, &crc32c_consts);
+}
@@ -12,9 +12,10 @@
 
 #include <common.h>
 #include <compiler.h>
+#include <u-boot/crc.h>
 
-uint32_t crc32c_cal(uint32_t crc, const char *data, int length,
-		    uint32_t *crc32c_table)
+uint32_t crc32c_table_update(uint32_t crc, const char *data, int length,
+			     uint32_t *crc32c_table)
 {
 	while (length--)
 		crc = crc32c_table[(u8)(crc ^ *data++)] ^ (crc >> 8);
@@ -22,6 +23,31 @@ uint32_t crc32c_cal(uint32_t crc, const char *data, int length,
 	return crc;
 }
 
+uint32_t crc32c_cal(uint32_t crc, const char *data, int length,
+		    uint32_t *crc32c_table)
+{
+#if IS_ENABLED(CONFIG_CRC32_CLMUL) && IS_ENABLED(CONFIG_RISCV_ISA_ZBC)
+	/*
+	 * Entry 0x80 of a table is its polynomial, so this spots a table for
+	 * the Castagnoli polynomial, which the CLMUL version can replace
+	 */
+	if (length >= CRC32_CLMUL_MIN && crc32c_table[0x80] == 0x82f63b78) {
+		int head = -(ulong)data & 7;
+		int n;
+
+		crc = crc32c_table_update(crc, data, head, crc32c_table);
+		data += head;
+		length -= head;
+		n = length & ~15;
+		crc = crc32c_clmul(crc, (const uint8_t *)data, n);
+		data += n;
+		length -= n;
+	}
+#endif
+
+	return crc32c_table_update(crc, data, length, crc32c_table);
+}
+
 void crc32c_init(uint32_t *crc32c_table, uint32_t pol)
 {
 	int i, j;
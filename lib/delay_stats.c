@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Per-call-site statistics for busy-wait delays and polling loops
+ *
+ * Each udelay() and read_poll_timeout() call site gets an entry in a small
+ * table, recording how often it was called and how long it waited. Sites are
+ * identified by their address, so use addr2line on the u-boot ELF file to
+ * find the source line.
+ */
+
+#include <common.h>
+#include <bootstage.h>
+#include <delay_stats.h>
+#include <malloc.h>
+#include <time.h>
+#include <asm/global_data.h>
+#include <linux/math64.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/*
+ * This is in the data section so that it can be used before relocation, when
+ * BSS is not available. It is copied to the relocated image along with the
+ * rest of the data.
+ */
+static struct delay_site delay_sites[CONFIG_DELAY_STATS_SITES]
+	__section(".data");
+static int delay_site_count __section(".data");
+static u32 delay_dropped __section(".data");
+
+void delay_stats_add(ulong site, enum delay_stats_type type, u64 start,
+		     bool timeout)
+{
+	u64 ticks = get_ticks() - start;
+	struct delay_site *ds;
+	int i;
+
+	/* Use the link-time address, so sites match across relocation */
+	if (gd->flags & GD_FLG_RELOC)
+		site -= gd->reloc_off;
+
+	for (i = 0, ds = delay_sites; i < delay_site_count; i++, ds++) {
+		if (ds->site == site)
+			break;
+	}
+	if (i == delay_site_count) {
+		if (delay_site_count == CONFIG_DELAY_STATS_SITES) {
+			delay_dropped++;
+			return;
+		}
+		delay_site_count++;
+		ds->site = site;
+		ds->type = type;
+	}
+
+	ds->count++;
+	if (timeout)
+		ds->timeouts++;
+	ds->total += ticks;
+	if (ticks > ds->max)
+		ds->max = ticks;
+}
+
+int delay_stats_get(const struct delay_site **sitesp)
+{
+	*sitesp = delay_sites;
+
+	return delay_site_count;
+}
+
+void delay_stats_reset(void)
+{
+	int i;
+
+	/* Keep the sites, so that exporting again updates the same records */
+	for (i = 0; i < delay_site_count; i++) {
+		struct delay_site *ds = &delay_sites[i];
+
+		ds->count = 0;
+		ds->timeouts = 0;
+		ds->total = 0;
+		ds->max = 0;
+	}
+	delay_dropped = 0;
+}
+
+static ulong ticks_to_us(u64 ticks)
+{
+	return div_u64(ticks * 1000000, get_tbclk());
+}
+
+void delay_stats_show(ulong min_us)
+{
+	bool shown[CONFIG_DELAY_STATS_SITES] = {};
+	u64 total = 0;
+	int used = 0;
+	int i;
+
+	printf("%-10s %-5s %8s %8s %12s %10s\n", "Site", "Type", "Count",
+	       "Timeouts", "Total us", "Max us");
+
+	/* Small table, so a selection sort by total time is fine */
+	while (1) {
+		struct delay_site *ds, *best = NULL;
+		int best_idx = 0;
+
+		for (i = 0, ds = delay_sites; i < delay_site_count; i++, ds++) {
+			if (!ds->count || shown[i])
+				continue;
+			if (!best || ds->total > best->total) {
+				best = ds;
+				best_idx = i;
+			}
+		}
+		if (!best || ticks_to_us(best->total) < min_us)
+			break;
+		shown[best_idx] = true;
+		printf("%08lx   %-5s %8u %8u %12lu %10lu\n", best->site,
+		       best->type == DELAY_STATS_POLL ? "poll" : "delay",
+		       best->count, best->timeouts, ticks_to_us(best->total),
+		       ticks_to_us(best->max));
+	}
+
+	for (i = 0; i < delay_site_count; i++) {
+		if (delay_sites[i].count)
+			used++;
+		total += delay_sites[i].total;
+	}
+	printf("%d sites, total %lu us\n", used, ticks_to_us(total));
+	if (delay_dropped)
+		printf("%u calls dropped: increase CONFIG_DELAY_STATS_SITES\n",
+		       delay_dropped);
+}
+
+int delay_stats_bootstage(ulong min_us)
+{
+	int count = 0;
+	int i;
+
+	for (i = 0; i < delay_site_count; i++) {
+		struct delay_site *ds = &delay_sites[i];
+		ulong us = ticks_to_us(ds->total);
+		enum bootstage_id id;
+		char *name = NULL;
+
+		if (!ds->bootstage_id && us < min_us)
+			continue;
+		if (!ds->bootstage_id) {
+			name = malloc(20);
+			if (!name)
+				return -ENOMEM;
+			snprintf(name, 20, "%s@%08lx",
+				 ds->type == DELAY_STATS_POLL ? "poll" : "delay",
+				 ds->site);
+		}
+		id = bootstage_set_accum(ds->bootstage_id ? : BOOTSTAGE_ID_ALLOC,
+					 name, us);
+		if (!id) {
+			free(name);
+			break;
+		}
+		ds->bootstage_id = id;
+		count++;
+	}
+
+	return count;
+}
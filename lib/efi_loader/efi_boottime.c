@@ -7,6 +7,7 @@
 
 #include <common.h>
 #include <bootm.h>
+#include <console.h>
 #include <div64.h>
 #include <dm/device.h>
 #include <dm/root.h>
@@ -2173,6 +2174,9 @@ static efi_status_t EFIAPI efi_exit_boot_services(efi_handle_t image_handle,
 			list_del(&evt->link);
 	}
 
+	/* the OS does not know about the ring, so send it all now */
+	console_defer_enable(false);
+
 	if (!efi_st_keep_devices) {
 		bootm_disable_interrupts();
 		if (IS_ENABLED(CONFIG_USB_DEVICE))
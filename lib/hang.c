@@ -9,6 +9,7 @@
 
 #include <common.h>
 #include <bootstage.h>
+#include <console.h>
 #include <hang.h>
 #include <os.h>
 
@@ -27,6 +28,7 @@ void hang(void)
 		 CONFIG_IS_ENABLED(SERIAL))
 	puts("### ERROR ### Please RESET the board ###\n");
 #endif
+	console_defer_flush();
 	bootstage_error(BOOTSTAGE_ID_NEED_RESET);
 	if (IS_ENABLED(CONFIG_SANDBOX))
 		os_exit(1);
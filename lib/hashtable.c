@@ -256,7 +256,8 @@ static inline int _compare_and_overwrite_entry(struct env_entry item,
 			}
 
 			/* If there is a callback, call it */
-			if (do_callback(&htab->table[idx].entry, item.key,
+			if (!(flag & H_DEFER_CALLBACK) &&
+			    do_callback(&htab->table[idx].entry, item.key,
 					item.data, env_op_overwrite, flag)) {
 				debug("callback() rejected setting variable "
 					"%s, skipping it!\n", item.key);
@@ -392,8 +393,14 @@ int hsearch_r(struct env_entry item, enum env_action action,
 
 		++htab->filled;
 
-		/* This is a new entry, so look up a possible callback */
-		env_callback_init(&htab->table[idx].entry);
+		/*
+		 * This is a new entry, so look up a possible callback (unless
+		 * the caller does that once the whole import is done)
+		 */
+		if (flag & H_DEFER_CALLBACK)
+			htab->table[idx].entry.callback = NULL;
+		else
+			env_callback_init(&htab->table[idx].entry);
 		/* Also look for flags */
 		env_flags_init(&htab->table[idx].entry);
 
@@ -409,7 +416,8 @@ int hsearch_r(struct env_entry item, enum env_action action,
 		}
 
 		/* If there is a callback, call it */
-		if (do_callback(&htab->table[idx].entry, item.key, item.data,
+		if (!(flag & H_DEFER_CALLBACK) &&
+		    do_callback(&htab->table[idx].entry, item.key, item.data,
 				env_op_create, flag)) {
 			debug("callback() rejected setting variable "
 				"%s, skipping it!\n", item.key);
@@ -752,6 +760,55 @@ static int drop_var_from_set(const char *name, int nvars, char * vars[])
 	return res;
 }
 
+/*
+ * Count the entries in an import buffer. Escaped separators in a value are
+ * counted as well, so this may overestimate but never underestimates.
+ */
+static int himport_count(const char *env, size_t size, const char sep)
+{
+	const char *p = env, *end = env + size;
+	int count = 0;
+
+	while (p < end && *p) {
+		++count;
+		while (p < end && *p && *p != sep)
+			++p;
+		if (p >= end || *p != sep)
+			break;
+		++p;
+	}
+
+	return count;
+}
+
+/*
+ * Look up the callbacks for the entries created by an import and run them,
+ * in the order the entries appear in the imported data. Doing this once the
+ * import is complete means that the ".callbacks" association list is final,
+ * and that each callback sees the whole of the imported environment.
+ */
+static void himport_run_callbacks(struct hsearch_data *htab, const int *idx,
+				  int count, int flag)
+{
+	int i;
+
+	for (i = 0; i < count; i++) {
+		struct env_entry_node *node = &htab->table[idx[i]];
+		struct env_entry *ep = &node->entry;
+
+		/* deleted again later in the import */
+		if (node->used <= 0)
+			continue;
+
+		env_callback_init(ep);
+		if (do_callback(ep, ep->key, ep->data, env_op_create, flag)) {
+			debug("callback() rejected setting variable "
+				"%s, skipping it!\n", ep->key);
+			_hdelete(ep->key, htab, ep, idx[i]);
+		}
+	}
+}
+
 /*
  * Import linearized data into hash table.
  *
@@ -796,6 +853,8 @@ int himport_r(struct hsearch_data *htab,
 {
 	char *data, *sp, *dp, *name, *value;
 	char *localvars[nvars];
+	int *created = NULL;
+	int count, ncreated = 0;
 	int i;
 
 	/* Test for correct arguments.  */
@@ -813,6 +872,7 @@ int himport_r(struct hsearch_data *htab,
 	memcpy(data, env, size);
 	data[size] = '\0';
 	dp = data;
+	count = himport_count(data, size, sep);
 
 	/* make a local copy of the list of variables */
 	if (nvars)
@@ -853,6 +913,9 @@ int himport_r(struct hsearch_data *htab,
 
 		if (nent > CONFIG_ENV_MAX_ENTRIES)
 			nent = CONFIG_ENV_MAX_ENTRIES;
+		/* but keep the table at most half full with what we import */
+		if (nent < 2 * count)
+			nent = 2 * count;
 
 		debug("Create Hash Table: N=%d\n", nent);
 
@@ -860,9 +923,19 @@ int himport_r(struct hsearch_data *htab,
 			free(data);
 			return 0;
 		}
+
+		/*
+		 * Every entry is new, so nothing needs to be preserved if a
+		 * callback rejects its value: defer the callbacks and run them
+		 * in one pass at the end. If we cannot track the new entries,
+		 * fall back to calling them one at a time.
+		 */
+		if (count)
+			created = malloc(count * sizeof(*created));
 	}
 
 	if (!size) {
+		free(created);
 		free(data);
 		return 1;		/* everything OK */
 	}
@@ -929,6 +1002,10 @@ int himport_r(struct hsearch_data *htab,
 		if (*name == 0) {
 			debug("INSERT: unable to use an empty key\n");
 			__set_errno(EINVAL);
+			if (created)
+				himport_run_callbacks(htab, created, ncreated,
+						      flag);
+			free(created);
 			free(data);
 			return 0;
 		}
@@ -941,7 +1018,18 @@ int himport_r(struct hsearch_data *htab,
 		e.key = name;
 		e.data = value;
 
-		hsearch_r(e, ENV_ENTER, &rv, htab, flag);
+		if (created) {
+			unsigned int filled = htab->filled;
+
+			hsearch_r(e, ENV_ENTER, &rv, htab,
+				  flag | H_DEFER_CALLBACK);
+			if (rv && htab->filled != filled && ncreated < count)
+				created[ncreated++] = container_of(rv,
+					struct env_entry_node, entry) -
+					htab->table;
+		} else {
+			hsearch_r(e, ENV_ENTER, &rv, htab, flag);
+		}
 #if !CONFIG_IS_ENABLED(ENV_WRITEABLE_LIST)
 		if (rv == NULL) {
 			printf("himport_r: can't insert \"%s=%s\" into hash table\n",
@@ -957,6 +1045,11 @@ int himport_r(struct hsearch_data *htab,
 	debug("INSERT: free(data = %p)\n", data);
 	free(data);
 
+	if (created) {
+		himport_run_callbacks(htab, created, ncreated, flag);
+		free(created);
+	}
+
 	if (flag & H_NOCLEAR)
 		goto end;
 
@@ -114,6 +114,98 @@ write_fail:
 	return -1;
 }
 
+/*
+ * A run of zero FILL and DONT_CARE chunks, which is discarded in one go
+ * rather than chunk by chunk. @zero is set if any of it must read as zero.
+ */
+struct sparse_zero_run {
+	lbaint_t	start;
+	lbaint_t	blkcnt;
+	bool		zero;
+};
+
+/*
+ * Write @blkcnt blocks of the pattern in @fill_buf, @fill_buf_num_blks at a
+ * time. Returns the blocks advanced, which might be more than @blkcnt with
+ * NAND bad-blocks, or -1 on error.
+ */
+static lbaint_t write_sparse_fill(struct sparse_storage *info, lbaint_t blk,
+				  lbaint_t blkcnt, uint32_t *fill_buf,
+				  lbaint_t fill_buf_num_blks, char *response)
+{
+	lbaint_t blks, n, i;
+	lbaint_t start = blk;
+
+	for (i = 0; i < blkcnt; i += n) {
+		n = min(blkcnt - i, fill_buf_num_blks);
+
+		/* blks might be > n (eg. NAND bad-blocks) */
+		blks = info->write(info, blk, n, fill_buf);
+		if (IS_ERR_VALUE(blks) || blks < n) {
+			printf("%s: %s " LBAFU " [" LBAFU "]\n", __func__,
+			       "Write failed, block #", blk, n);
+			info->mssg("flash write failure", response);
+			return -1;
+		}
+		blk += blks;
+	}
+
+	return blk - start;
+}
+
+/*
+ * Discard a run of zero FILL and DONT_CARE chunks. Only the part aligned to
+ * the erase size is erased, since erasing a partial erase group would take
+ * the blocks around it along. If the run has to read as zero, what is left
+ * at either end, or all of it if the erase fails, is written with zeros.
+ */
+static int flush_sparse_zero_run(struct sparse_storage *info,
+				 struct sparse_zero_run *run,
+				 uint32_t *zero_buf, lbaint_t fill_buf_num_blks,
+				 uint64_t *bytes_discarded, char *response)
+{
+	lbaint_t align = max(info->erase_size, (lbaint_t)1);
+	lbaint_t first, end, blks;
+
+	if (!run->blkcnt)
+		return 0;
+
+	first = lldiv(run->start + align - 1, align) * align;
+	end = lldiv(run->start + run->blkcnt, align) * align;
+	if (info->erase && first < end) {
+		blks = info->erase(info, first, end - first, NULL);
+		if (!IS_ERR_VALUE(blks) && blks == end - first) {
+			*bytes_discarded += ((u64)blks) * info->blksz;
+		} else {
+			/* the device cannot discard, write zeros from now on */
+			printf("%s: Discard failed, block #" LBAFU " [" LBAFU "]\n",
+			       __func__, first, end - first);
+			info->erase = NULL;
+			first = end = run->start;
+		}
+	} else {
+		first = end = run->start;
+	}
+
+	if (run->zero) {
+		if (first > run->start &&
+		    write_sparse_fill(info, run->start, first - run->start,
+				      zero_buf, fill_buf_num_blks,
+				      response) == -1)
+			return -1;
+		if (run->start + run->blkcnt > end &&
+		    write_sparse_fill(info, end, run->start + run->blkcnt - end,
+				      zero_buf, fill_buf_num_blks,
+				      response) == -1)
+			return -1;
+	}
+
+	run->blkcnt = 0;
+	run->zero = false;
+
+	return 0;
+}
+
 int write_sparse_image(struct sparse_storage *info,
 		       const char *part_name, void *data, char *response)
 {
@@ -121,19 +213,26 @@ int write_sparse_image(struct sparse_storage *info,
 	lbaint_t blkcnt;
 	lbaint_t blks;
 	uint64_t bytes_written = 0;
+	uint64_t bytes_discarded = 0;
 	unsigned int chunk;
 	unsigned int offset;
 	uint64_t chunk_data_sz;
 	uint32_t *fill_buf = NULL;
+	uint32_t *zero_buf = NULL;
 	uint32_t fill_val;
+	uint32_t fill_buf_val = 0;
 	sparse_header_t *sparse_header;
 	chunk_header_t *chunk_header;
+	struct sparse_zero_run run = { .blkcnt = 0 };
 	uint32_t total_blocks = 0;
-	int fill_buf_num_blks;
+	lbaint_t fill_buf_num_blks;
+	size_t fill_buf_size;
+	int ret = -1;
 	int i;
-	int j;
 
 	fill_buf_num_blks = CONFIG_IMAGE_SPARSE_FILLBUF_SIZE / info->blksz;
+	fill_buf_size = ROUNDUP(info->blksz * fill_buf_num_blks,
+				ARCH_DMA_MINALIGN);
 
 	/* Read and skip over sparse image header */
 	sparse_header = (sparse_header_t *)data;
@@ -205,7 +304,7 @@ int write_sparse_image(struct sparse_storage *info,
 			    (sparse_header->chunk_hdr_sz + chunk_data_sz)) {
 				info->mssg("Bogus chunk size for chunk type Raw",
 					   response);
-				return -1;
+				goto out;
 			}
 
 			if (blk + blkcnt > info->start + info->size) {
@@ -214,13 +313,18 @@ int write_sparse_image(struct sparse_storage *info,
 				    __func__);
 				info->mssg("Request would exceed partition size!",
 					   response);
-				return -1;
+				goto out;
 			}
 
+			if (flush_sparse_zero_run(info, &run, zero_buf,
+						  fill_buf_num_blks,
+						  &bytes_discarded, response))
+				goto out;
+
 			blks = write_sparse_chunk_raw(info, blk, blkcnt,
 						      data, response);
 			if (blks < 0)
-				return -1;
+				goto out;
 
 			blk += blks;
 			bytes_written += ((u64)blkcnt) * info->blksz;
@@ -232,78 +336,96 @@ int write_sparse_image(struct sparse_storage *info,
 			if (chunk_header->total_sz !=
 			    (sparse_header->chunk_hdr_sz + sizeof(uint32_t))) {
 				info->mssg("Bogus chunk size for chunk type FILL", response);
-				return -1;
-			}
-
-			fill_buf = (uint32_t *)
-				   memalign(ARCH_DMA_MINALIGN,
-					    ROUNDUP(
-						info->blksz * fill_buf_num_blks,
-						ARCH_DMA_MINALIGN));
-			if (!fill_buf) {
-				info->mssg("Malloc failed for: CHUNK_TYPE_FILL",
-					   response);
-				return -1;
+				goto out;
 			}
 
 			fill_val = *(uint32_t *)data;
 			data = (char *)data + sizeof(uint32_t);
 
-			for (i = 0;
-			     i < (info->blksz * fill_buf_num_blks /
-				  sizeof(fill_val));
-			     i++)
-				fill_buf[i] = fill_val;
-
 			if (blk + blkcnt > info->start + info->size) {
 				printf(
 				    "%s: Request would exceed partition size!\n",
 				    __func__);
 				info->mssg("Request would exceed partition size!",
 					   response);
-				return -1;
+				goto out;
 			}
 
-			for (i = 0; i < blkcnt;) {
-				j = blkcnt - i;
-				if (j > fill_buf_num_blks){
-					if (blk % fill_buf_num_blks){
-						/*align blk addr*/
-						j = fill_buf_num_blks - (blk % fill_buf_num_blks);
-					}else{
-						j = fill_buf_num_blks;
-					}
-				}
-
-				if (fill_val == 0 && j == fill_buf_num_blks
-					&& info->erase !=NULL){
-					blks = info->erase(info, blk, j, fill_buf);
-				}else {
-					blks = info->write(info, blk, j, fill_buf);
+			if (!zero_buf && fill_val == 0) {
+				zero_buf = memalign(ARCH_DMA_MINALIGN,
+						    fill_buf_size);
+				if (!zero_buf) {
+					info->mssg("Malloc failed for: CHUNK_TYPE_FILL",
+						   response);
+					goto out;
 				}
+				memset(zero_buf, 0, fill_buf_size);
+			}
 
-				/* blks might be > j (eg. NAND bad-blocks) */
-				if (blks < j) {
-					printf("%s: %s " LBAFU " [%d]\n",
-					       __func__,
-					       "Write failed, block #",
-					       blk, j);
-					info->mssg("flash write failure",
-						   response);
-					free(fill_buf);
-					return -1;
+			if (fill_val == 0 && info->erase) {
+				if (!run.blkcnt)
+					run.start = blk;
+				run.blkcnt += blkcnt;
+				run.zero = true;
+				blk += blkcnt;
+			} else {
+				if (flush_sparse_zero_run(info, &run, zero_buf,
+							  fill_buf_num_blks,
+							  &bytes_discarded,
+							  response))
+					goto out;
+
+				if (fill_val == 0) {
+					blks = write_sparse_fill(info, blk, blkcnt,
+								 zero_buf,
+								 fill_buf_num_blks,
+								 response);
+				} else {
+					if (!fill_buf) {
+						fill_buf = memalign(ARCH_DMA_MINALIGN,
+								    fill_buf_size);
+						if (!fill_buf) {
+							info->mssg("Malloc failed for: CHUNK_TYPE_FILL",
+								   response);
+							goto out;
+						}
+						fill_buf_val = ~fill_val;
+					}
+					/* refill only when the pattern changes */
+					if (fill_buf_val != fill_val) {
+						for (i = 0;
+						     i < fill_buf_size / sizeof(fill_val);
+						     i++)
+							fill_buf[i] = fill_val;
+						fill_buf_val = fill_val;
+					}
+					blks = write_sparse_fill(info, blk, blkcnt,
+								 fill_buf,
+								 fill_buf_num_blks,
+								 response);
 				}
+				if (blks == -1)
+					goto out;
 				blk += blks;
-				i += j;
 			}
 			bytes_written += ((u64)blkcnt) * info->blksz;
 			total_blocks += DIV_ROUND_UP_ULL(chunk_data_sz,
 							 sparse_header->blk_sz);
-			free(fill_buf);
 			break;
 
 		case CHUNK_TYPE_DONT_CARE:
-			blk += info->reserve(info, blk, blkcnt);
+			if (info->erase) {
+				/* never discard past the end of the partition */
+				if (blk + blkcnt > info->start + info->size)
+					blkcnt = blk < info->start + info->size ?
+						 info->start + info->size - blk : 0;
+				if (!run.blkcnt)
+					run.start = blk;
+				run.blkcnt += blkcnt;
+				blk += blkcnt;
+			} else {
+				blk += info->reserve(info, blk, blkcnt);
+			}
 			total_blocks += chunk_header->chunk_sz;
 			break;
 
@@ -312,7 +434,7 @@ int write_sparse_image(struct sparse_storage *info,
 			    sparse_header->chunk_hdr_sz) {
 				info->mssg("Bogus chunk size for chunk type Dont Care",
 					   response);
-				return -1;
+				goto out;
 			}
 			total_blocks += chunk_header->chunk_sz;
 			data += chunk_data_sz;
@@ -322,18 +444,29 @@ int write_sparse_image(struct sparse_storage *info,
 			printf("%s: Unknown chunk type: %x\n", __func__,
 			       chunk_header->chunk_type);
 			info->mssg("Unknown chunk type", response);
-			return -1;
+			goto out;
 		}
 	}
 
+	if (flush_sparse_zero_run(info, &run, zero_buf, fill_buf_num_blks,
+				  &bytes_discarded, response))
+		goto out;
+
 	debug("Wrote %d blocks, expected to write %d blocks\n",
 	      total_blocks, sparse_header->total_blks);
 	printf("........ wrote %llu bytes to '%s'\n", bytes_written, part_name);
+	if (bytes_discarded)
+		printf("........ discarded %llu bytes of '%s'\n",
+		       bytes_discarded, part_name);
 
 	if (total_blocks != sparse_header->total_blks) {
 		info->mssg("sparse image write failure", response);
-		return -1;
+		goto out;
 	}
 
-	return 0;
+	ret = 0;
+out:
+	free(fill_buf);
+	free(zero_buf);
+	return ret;
 }
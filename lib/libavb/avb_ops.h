@@ -312,6 +312,28 @@ struct AvbOps {
       size_t public_key_metadata_length,
       bool* out_is_trusted,
       uint32_t* out_rollback_index_location);
+
+  /* Hashes |salt| of |salt_len| bytes followed by the first |num_bytes| of
+   * the partition with name |partition| (NUL-terminated UTF-8 string),
+   * reading the partition a piece at a time instead of loading it whole.
+   * |hash_algorithm| is "sha256" or "sha512" and the digest, of
+   * |digest_len| bytes, is stored in |out_digest|.
+   *
+   * This is only used with AVB_SLOT_VERIFY_FLAGS_STREAM_HASH, for
+   * partitions which are not preloaded. If |hash_algorithm| is not
+   * supported, AVB_IO_RESULT_ERROR_NO_SUCH_VALUE is returned and the
+   * partition is loaded and hashed as usual.
+   *
+   * Returns AVB_IO_RESULT_OK on success, otherwise an error code.
+   */
+  AvbIOResult (*hash_partition)(AvbOps* ops,
+                                const char* partition,
+                                const char* hash_algorithm,
+                                const uint8_t* salt,
+                                size_t salt_len,
+                                uint64_t num_bytes,
+                                uint8_t* out_digest,
+                                size_t digest_len);
 };
 
 #ifdef __cplusplus
@@ -57,11 +57,13 @@ static inline bool result_should_continue(AvbSlotVerifyResult result) {
   return false;
 }
 
-static AvbSlotVerifyResult load_full_partition(AvbOps* ops,
-                                               const char* part_name,
-                                               uint64_t image_size,
-                                               uint8_t** out_image_buf,
-                                               bool* out_image_preloaded) {
+/* Gets the partition in |out_image_buf| if it is preloaded, leaving
+ * |out_image_buf| NULL otherwise. */
+static AvbSlotVerifyResult load_preloaded_partition(AvbOps* ops,
+                                                    const char* part_name,
+                                                    uint64_t image_size,
+                                                    uint8_t** out_image_buf,
+                                                    bool* out_image_preloaded) {
   size_t part_num_read;
   AvbIOResult io_ret;
 
@@ -76,7 +78,6 @@ static AvbSlotVerifyResult load_full_partition(AvbOps* ops,
     return AVB_SLOT_VERIFY_RESULT_ERROR_INVALID_METADATA;
   }
 
-  /* Try use a preloaded one. */
   if (ops->get_preloaded_partition != NULL) {
     io_ret = ops->get_preloaded_partition(
         ops, part_name, image_size, out_image_buf, &part_num_read);
@@ -96,6 +97,25 @@ static AvbSlotVerifyResult load_full_partition(AvbOps* ops,
     }
   }
 
+  return AVB_SLOT_VERIFY_RESULT_OK;
+}
+
+static AvbSlotVerifyResult load_full_partition(AvbOps* ops,
+                                               const char* part_name,
+                                               uint64_t image_size,
+                                               uint8_t** out_image_buf,
+                                               bool* out_image_preloaded) {
+  size_t part_num_read;
+  AvbSlotVerifyResult ret;
+  AvbIOResult io_ret;
+
+  /* Try use a preloaded one. */
+  ret = load_preloaded_partition(
+      ops, part_name, image_size, out_image_buf, out_image_preloaded);
+  if (ret != AVB_SLOT_VERIFY_RESULT_OK) {
+    return ret;
+  }
+
   /* Allocate and copy the partition. */
   if (!*out_image_preloaded) {
     *out_image_buf = avb_malloc(image_size);
@@ -262,6 +282,7 @@ static AvbSlotVerifyResult load_and_verify_hash_partition(
     AvbOps* ops,
     const char* const* requested_partitions,
     const char* ab_suffix,
+    AvbSlotVerifyFlags flags,
     bool allow_verification_error,
     const AvbDescriptor* descriptor,
     AvbSlotVerifyData* slot_data) {
@@ -274,7 +295,8 @@ static AvbSlotVerifyResult load_and_verify_hash_partition(
   AvbIOResult io_ret;
   uint8_t* image_buf = NULL;
   bool image_preloaded = false;
-  uint8_t* digest;
+  uint8_t* digest = NULL;
+  uint8_t digest_buf[AVB_SHA512_DIGEST_SIZE];
   size_t digest_len;
   const char* found;
   uint64_t image_size;
@@ -363,23 +385,70 @@ static AvbSlotVerifyResult load_and_verify_hash_partition(
     avb_debugv(part_name, ": Loading entire partition.\n", NULL);
   }
 
-  ret = load_full_partition(
-      ops, part_name, image_size, &image_buf, &image_preloaded);
-  if (ret != AVB_SLOT_VERIFY_RESULT_OK) {
-    goto out;
+  // If we allow verification error and the whole partition is smaller than
+  // image size in hash descriptor, we just hash the whole partition.
+  uint64_t image_size_to_hash = hash_desc.image_size;
+  if (image_size_to_hash > image_size) {
+    image_size_to_hash = image_size;
+  }
+
+  /* Hash the partition while reading it, unless it is preloaded. */
+  bool stream_hash = (flags & AVB_SLOT_VERIFY_FLAGS_STREAM_HASH) &&
+                     ops->hash_partition != NULL;
+  if (stream_hash) {
+    ret = load_preloaded_partition(
+        ops, part_name, image_size, &image_buf, &image_preloaded);
+    if (ret != AVB_SLOT_VERIFY_RESULT_OK) {
+      goto out;
+    }
+  }
+  if (stream_hash && image_buf == NULL) {
+    if (avb_strcmp((const char*)hash_desc.hash_algorithm, "sha256") == 0) {
+      digest_len = AVB_SHA256_DIGEST_SIZE;
+    } else if (avb_strcmp((const char*)hash_desc.hash_algorithm, "sha512") ==
+               0) {
+      digest_len = AVB_SHA512_DIGEST_SIZE;
+    } else {
+      avb_errorv(part_name, ": Unsupported hash algorithm.\n", NULL);
+      ret = AVB_SLOT_VERIFY_RESULT_ERROR_INVALID_METADATA;
+      goto out;
+    }
+
+    io_ret = ops->hash_partition(ops,
+                                 part_name,
+                                 (const char*)hash_desc.hash_algorithm,
+                                 desc_salt,
+                                 hash_desc.salt_len,
+                                 image_size_to_hash,
+                                 digest_buf,
+                                 digest_len);
+    if (io_ret == AVB_IO_RESULT_ERROR_OOM) {
+      ret = AVB_SLOT_VERIFY_RESULT_ERROR_OOM;
+      goto out;
+    } else if (io_ret == AVB_IO_RESULT_OK) {
+      digest = digest_buf;
+    } else if (io_ret != AVB_IO_RESULT_ERROR_NO_SUCH_VALUE) {
+      avb_errorv(part_name, ": Error hashing data from partition.\n", NULL);
+      ret = AVB_SLOT_VERIFY_RESULT_ERROR_IO;
+      goto out;
+    }
+  }
+
+  if (digest == NULL && image_buf == NULL) {
+    ret = load_full_partition(
+        ops, part_name, image_size, &image_buf, &image_preloaded);
+    if (ret != AVB_SLOT_VERIFY_RESULT_OK) {
+      goto out;
+    }
   }
   // Although only one of the type might be used, we have to defined the
   // structure here so that they would live outside the 'if/else' scope to be
   // used later.
   AvbSHA256Ctx sha256_ctx;
   AvbSHA512Ctx sha512_ctx;
-  size_t image_size_to_hash = hash_desc.image_size;
-  // If we allow verification error and the whole partition is smaller than
-  // image size in hash descriptor, we just hash the whole partition.
-  if (image_size_to_hash > image_size) {
-    image_size_to_hash = image_size;
-  }
-  if (avb_strcmp((const char*)hash_desc.hash_algorithm, "sha256") == 0) {
+  if (digest != NULL) {
+    /* Already hashed while reading the partition. */
+  } else if (avb_strcmp((const char*)hash_desc.hash_algorithm, "sha256") == 0) {
     avb_sha256_init(&sha256_ctx);
     avb_sha256_update(&sha256_ctx, desc_salt, hash_desc.salt_len);
     avb_sha256_update(&sha256_ctx, image_buf, image_size_to_hash);
@@ -947,6 +1016,7 @@ static AvbSlotVerifyResult load_and_verify_vbmeta(
         sub_ret = load_and_verify_hash_partition(ops,
                                                  requested_partitions,
                                                  ab_suffix,
+                                                 flags,
                                                  allow_verification_error,
                                                  descriptors[n],
                                                  slot_data);
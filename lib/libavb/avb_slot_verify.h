@@ -107,12 +107,20 @@ typedef enum {
  * vbmeta structs. This flag is useful when booting into recovery on a device
  * not using A/B - see section "Booting into recovery" in README.md for
  * more information.
+ *
+ * If the AVB_SLOT_VERIFY_FLAGS_STREAM_HASH flag is set and the
+ * |hash_partition| operation is available, partitions with a hash
+ * descriptor which are not preloaded are hashed while being read, without
+ * loading them whole. Such partitions are then not in |loaded_partitions|
+ * of |out_data|, so this flag is for callers which only want the
+ * verification result, or which preload the partitions they boot.
  */
 typedef enum {
   AVB_SLOT_VERIFY_FLAGS_NONE = 0,
   AVB_SLOT_VERIFY_FLAGS_ALLOW_VERIFICATION_ERROR = (1 << 0),
   AVB_SLOT_VERIFY_FLAGS_RESTART_CAUSED_BY_HASHTREE_CORRUPTION = (1 << 1),
   AVB_SLOT_VERIFY_FLAGS_NO_VBMETA_PARTITION = (1 << 2),
+  AVB_SLOT_VERIFY_FLAGS_STREAM_HASH = (1 << 3),
 } AvbSlotVerifyFlags;
 
 /* Get a textual representation of |result|. */
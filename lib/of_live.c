@@ -318,6 +318,11 @@ int of_live_build(const void *fdt_blob, struct device_node **rootp)
 		debug("Failed to scan live tree aliases: err=%d\n", ret);
 		return ret;
 	}
+	ret = of_index_scan();
+	if (ret) {
+		debug("Failed to index live tree: err=%d\n", ret);
+		return ret;
+	}
 	debug("%s: stop\n", __func__);
 
 	return ret;
@@ -10,6 +10,7 @@
  */
 
 #include <common.h>
+#include <console.h>
 #include <hang.h>
 #if !defined(CONFIG_PANIC_HANG)
 #include <command.h>
@@ -21,6 +22,7 @@ static void panic_finish(void) __attribute__ ((noreturn));
 static void panic_finish(void)
 {
 	putc('\n');
+	console_defer_flush();
 #if defined(CONFIG_PANIC_HANG)
 	hang();
 #else
@@ -6,7 +6,9 @@
 
 #include <common.h>
 #include <clock_legacy.h>
+#include <console.h>
 #include <bootstage.h>
+#include <delay_stats.h>
 #include <dm.h>
 #include <errno.h>
 #include <init.h>
@@ -193,14 +195,41 @@ void __weak __udelay(unsigned long usec)
 
 /* ------------------------------------------------------------------------- */
 
-void udelay(unsigned long usec)
+static void udelay_wait(unsigned long usec)
 {
 	ulong kv;
 
 	do {
 		WATCHDOG_RESET();
+		console_defer_poll();
 		kv = usec > CONFIG_WD_PERIOD ? CONFIG_WD_PERIOD : usec;
 		__udelay(kv);
 		usec -= kv;
 	} while(usec);
 }
+
+void udelay(unsigned long usec)
+{
+	__maybe_unused u64 start = delay_stats_start();
+
+	udelay_wait(usec);
+
+#if CONFIG_IS_ENABLED(DELAY_STATS)
+	delay_stats_add((ulong)__builtin_return_address(0), DELAY_STATS_UDELAY,
+			start, false);
+#endif
+}
+
+#if CONFIG_IS_ENABLED(DELAY_STATS)
+/* Not inline here, so that each mdelay() call is recorded once, at its site */
+void mdelay(unsigned long msec)
+{
+	u64 start = delay_stats_start();
+
+	while (msec--)
+		udelay_wait(1000);
+
+	delay_stats_add((ulong)__builtin_return_address(0), DELAY_STATS_UDELAY,
+			start, false);
+}
+#endif
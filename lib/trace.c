@@ -6,16 +6,43 @@
 #include <common.h>
 #include <mapmem.h>
 #include <time.h>
+#include <timer.h>
 #include <trace.h>
 #include <asm/global_data.h>
 #include <asm/io.h>
 #include <asm/sections.h>
+#include <linux/math64.h>
+#ifdef CONFIG_RISCV
+#include <asm/csr.h>
+#endif
 
 DECLARE_GLOBAL_DATA_PTR;
 
 static char trace_enabled __section(".data");
 static char trace_inited __section(".data");
 
+/*
+ * Secondary harts on RISC-V run code too (e.g. smp_call_function()), so each
+ * hart has its own call list and depth, to keep the call records nested.
+ * Hart slot 0 is always the boot hart.
+ */
+#if defined(CONFIG_RISCV) && CONFIG_IS_ENABLED(SMP)
+#define TRACE_HARTS	CONFIG_NR_CPUS
+#else
+#define TRACE_HARTS	1
+#endif
+
+/* Function trace list for one hart */
+struct trace_hart {
+	struct trace_call *ftrace;	/* The function call records */
+	ulong ftrace_size;	/* Num. of ftrace records we have space for */
+	ulong ftrace_count;	/* Num. of ftrace records written */
+	ulong ftrace_too_deep_count;	/* Functions that were too deep */
+
+	int depth;
+	int max_depth;
+};
+
 /* The header block at the start of the trace memory area */
 struct trace_hdr {
 	int func_count;		/* Total number of function call sites */
@@ -25,19 +52,16 @@ struct trace_hdr {
 
 	/*
 	 * Call count for each function. This is indexed by the word offset
-	 * of the function from gd->relocaddr
+	 * of the function from gd->relocaddr. Secondary harts update this
+	 * without locking, so the counts are approximate if they are busy.
 	 */
 	uintptr_t *call_accum;
 
-	/* Function trace list */
-	struct trace_call *ftrace;	/* The function call records */
-	ulong ftrace_size;	/* Num. of ftrace records we have space for */
-	ulong ftrace_count;	/* Num. of ftrace records written */
-	ulong ftrace_too_deep_count;	/* Functions that were too deep */
+	/* Timestamp when tracing started, in trace_get_time() units */
+	u64 start_time;
 
-	int depth;
 	int depth_limit;
-	int max_depth;
+	struct trace_hart hart[TRACE_HARTS];
 };
 
 static struct trace_hdr *hdr;	/* Pointer to start of trace buffer */
@@ -58,6 +82,84 @@ static inline uintptr_t __attribute__((no_instrument_function))
 	return offset / FUNC_SITE_SIZE;
 }
 
+#if defined(CONFIG_RISCV) && CONFIG_IS_ENABLED(RISCV_SMODE)
+
+/*
+ * Read the time CSR directly: it is much cheaper than going through the timer
+ * driver and cannot recurse into the trace code. The raw count is recorded
+ * and converted to microseconds when the trace is written out.
+ */
+static inline u64 __attribute__((no_instrument_function)) trace_get_time(void)
+{
+	return csr_read(CSR_TIME);
+}
+
+/* The time CSR runs at the rate of the RISC-V timer */
+static inline ulong __attribute__((no_instrument_function))
+		trace_get_rate(void)
+{
+	if (IS_ENABLED(CONFIG_TIMER_EARLY))
+		return timer_early_get_rate();
+
+	return get_tbclk();
+}
+
+#else
+
+static inline u64 __attribute__((no_instrument_function)) trace_get_time(void)
+{
+	return timer_get_us();
+}
+
+static inline ulong __attribute__((no_instrument_function))
+		trace_get_rate(void)
+{
+	return 1000000;
+}
+
+#endif
+
+#if TRACE_HARTS > 1
+
+/*
+ * Get the trace buffer for this hart, whose ID is kept in tp, or NULL if
+ * there is none since the ID is out of range
+ */
+static inline struct trace_hart *__attribute__((no_instrument_function))
+		trace_cur_hart(void)
+{
+	ulong hart, slot;
+
+	asm ("mv %0, tp" : "=r" (hart));
+	if (hart >= TRACE_HARTS)
+		return NULL;
+	slot = hart - gd->arch.boot_hart;
+	if (hart < gd->arch.boot_hart)
+		slot += TRACE_HARTS;
+
+	return &hdr->hart[slot];
+}
+
+static int trace_slot_to_hart(int slot)
+{
+	return (slot + gd->arch.boot_hart) % TRACE_HARTS;
+}
+
+#else
+
+static inline struct trace_hart *__attribute__((no_instrument_function))
+		trace_cur_hart(void)
+{
+	return &hdr->hart[0];
+}
+
+static int trace_slot_to_hart(int slot)
+{
+	return 0;
+}
+
+#endif
+
 #if defined(CONFIG_EFI_LOADER) && (defined(CONFIG_ARM) || defined(CONFIG_RISCV))
 
 /**
@@ -101,33 +203,35 @@ static void __attribute__((no_instrument_function)) trace_swap_gd(void)
 
 #endif
 
-static void __attribute__((no_instrument_function)) add_ftrace(void *func_ptr,
-				void *caller, ulong flags)
+static void __attribute__((no_instrument_function)) add_ftrace(
+		struct trace_hart *th, void *func_ptr, void *caller, ulong flags)
 {
-	if (hdr->depth > hdr->depth_limit) {
-		hdr->ftrace_too_deep_count++;
+	if (th->depth > hdr->depth_limit) {
+		th->ftrace_too_deep_count++;
 		return;
 	}
-	if (hdr->ftrace_count < hdr->ftrace_size) {
-		struct trace_call *rec = &hdr->ftrace[hdr->ftrace_count];
+	if (th->ftrace_count < th->ftrace_size) {
+		struct trace_call *rec = &th->ftrace[th->ftrace_count];
 
 		rec->func = func_ptr_to_num(func_ptr);
 		rec->caller = func_ptr_to_num(caller);
-		rec->flags = flags | (timer_get_us() & FUNCF_TIMESTAMP_MASK);
+		rec->flags = flags | (trace_get_time() & FUNCF_TIMESTAMP_MASK);
 	}
-	hdr->ftrace_count++;
+	th->ftrace_count++;
 }
 
 static void __attribute__((no_instrument_function)) add_textbase(void)
 {
-	if (hdr->ftrace_count < hdr->ftrace_size) {
-		struct trace_call *rec = &hdr->ftrace[hdr->ftrace_count];
+	struct trace_hart *th = &hdr->hart[0];
+
+	if (th->ftrace_count < th->ftrace_size) {
+		struct trace_call *rec = &th->ftrace[th->ftrace_count];
 
 		rec->func = CONFIG_SYS_TEXT_BASE;
 		rec->caller = 0;
 		rec->flags = FUNCF_TEXTBASE;
 	}
-	hdr->ftrace_count++;
+	th->ftrace_count++;
 }
 
 /**
@@ -143,10 +247,16 @@ void __attribute__((no_instrument_function)) __cyg_profile_func_enter(
 		void *func_ptr, void *caller)
 {
 	if (trace_enabled) {
+		struct trace_hart *th;
 		int func;
 
 		trace_swap_gd();
-		add_ftrace(func_ptr, caller, FUNCF_ENTRY);
+		th = trace_cur_hart();
+		if (!th) {
+			trace_swap_gd();
+			return;
+		}
+		add_ftrace(th, func_ptr, caller, FUNCF_ENTRY);
 		func = func_ptr_to_num(func_ptr);
 		if (func < hdr->func_count) {
 			hdr->call_accum[func]++;
@@ -154,9 +264,9 @@ void __attribute__((no_instrument_function)) __cyg_profile_func_enter(
 		} else {
 			hdr->untracked_count++;
 		}
-		hdr->depth++;
-		if (hdr->depth > hdr->depth_limit)
-			hdr->max_depth = hdr->depth;
+		th->depth++;
+		if (th->depth > hdr->depth_limit)
+			th->max_depth = th->depth;
 		trace_swap_gd();
 	}
 }
@@ -171,9 +281,14 @@ void __attribute__((no_instrument_function)) __cyg_profile_func_exit(
 		void *func_ptr, void *caller)
 {
 	if (trace_enabled) {
+		struct trace_hart *th;
+
 		trace_swap_gd();
-		add_ftrace(func_ptr, caller, FUNCF_EXIT);
-		hdr->depth--;
+		th = trace_cur_hart();
+		if (th) {
+			add_ftrace(th, func_ptr, caller, FUNCF_EXIT);
+			th->depth--;
+		}
 		trace_swap_gd();
 	}
 }
@@ -249,39 +364,66 @@ int trace_list_functions(void *buff, size_t buff_size, size_t *needed)
  */
 int trace_list_calls(void *buff, size_t buff_size, size_t *needed)
 {
-	struct trace_output_hdr *output_hdr = NULL;
+	ulong rate = trace_get_rate();
 	void *end, *ptr = buff;
-	size_t rec, upto;
-	size_t count;
+	int slot;
 
 	end = buff ? buff + buff_size : NULL;
 
-	/* Place some header information */
-	if (ptr + sizeof(struct trace_output_hdr) < end)
-		output_hdr = ptr;
-	ptr += sizeof(struct trace_output_hdr);
+	/* Write a chunk for each hart which made any calls */
+	for (slot = 0; slot < TRACE_HARTS; slot++) {
+		struct trace_output_hdr *output_hdr = NULL;
+		struct trace_hart *th = &hdr->hart[slot];
+		u64 base = hdr->start_time & ~(u64)FUNCF_TIMESTAMP_MASK;
+		u32 prev = hdr->start_time & FUNCF_TIMESTAMP_MASK;
+		size_t rec, upto;
+		size_t count;
+
+		count = min(th->ftrace_count, th->ftrace_size);
+		if (slot && !count)
+			continue;
 
-	/* Add information about each call */
-	count = hdr->ftrace_count;
-	if (count > hdr->ftrace_size)
-		count = hdr->ftrace_size;
-	for (rec = upto = 0; rec < count; rec++) {
-		if (ptr + sizeof(struct trace_call) < end) {
-			struct trace_call *call = &hdr->ftrace[rec];
-			struct trace_call *out = ptr;
-
-			out->func = call->func * FUNC_SITE_SIZE;
-			out->caller = call->caller * FUNC_SITE_SIZE;
-			out->flags = call->flags;
-			upto++;
+		/* Place some header information */
+		if (ptr + sizeof(struct trace_output_hdr) < end)
+			output_hdr = ptr;
+		ptr += sizeof(struct trace_output_hdr);
+
+		/* Add information about each call */
+		for (rec = upto = 0; rec < count; rec++) {
+			struct trace_call *call = &th->ftrace[rec];
+			u32 time = call->flags & FUNCF_TIMESTAMP_MASK;
+			bool timed = TRACE_CALL_TYPE(call) != FUNCF_TEXTBASE;
+
+			/* Only the low bits are recorded, so undo the wrapping */
+			if (timed) {
+				if (time < prev)
+					base += FUNCF_TIMESTAMP_MASK + 1;
+				prev = time;
+			}
+			if (ptr + sizeof(struct trace_call) < end) {
+				struct trace_call *out = ptr;
+
+				out->func = call->func * FUNC_SITE_SIZE;
+				out->caller = call->caller * FUNC_SITE_SIZE;
+				out->flags = call->flags;
+				if (timed) {
+					u64 us = div_u64((base + time) * 1000000,
+							 rate);
+
+					out->flags &= ~FUNCF_TIMESTAMP_MASK;
+					out->flags |= us & FUNCF_TIMESTAMP_MASK;
+				}
+				upto++;
+			}
+			ptr += sizeof(struct trace_call);
 		}
-		ptr += sizeof(struct trace_call);
-	}
 
-	/* Update the header */
-	if (output_hdr) {
-		output_hdr->rec_count = upto;
-		output_hdr->type = TRACE_CHUNK_CALLS;
+		/* Update the header */
+		if (output_hdr) {
+			output_hdr->rec_count = upto;
+			output_hdr->type = TRACE_CHUNK_CALLS;
+			output_hdr->cpu = trace_slot_to_hart(slot);
+		}
 	}
 
 	/* Work out how must of the buffer we used */
@@ -297,7 +439,9 @@ int trace_list_calls(void *buff, size_t buff_size, size_t *needed)
  */
 void trace_print_stats(void)
 {
-	ulong count;
+	ulong count = 0, total = 0, too_deep = 0;
+	int max_depth = 0;
+	int slot;
 
 #ifndef FTRACE
 	puts("Warning: make U-Boot with FTRACE to enable function instrumenting.\n");
@@ -313,20 +457,65 @@ void trace_print_stats(void)
 	puts(" function calls\n");
 	print_grouped_ull(hdr->untracked_count, 10);
 	puts(" untracked function calls\n");
-	count = min(hdr->ftrace_count, hdr->ftrace_size);
+	for (slot = 0; slot < TRACE_HARTS; slot++) {
+		struct trace_hart *th = &hdr->hart[slot];
+
+		count += min(th->ftrace_count, th->ftrace_size);
+		total += th->ftrace_count;
+		too_deep += th->ftrace_too_deep_count;
+		max_depth = max(max_depth, th->max_depth);
+	}
 	print_grouped_ull(count, 10);
 	puts(" traced function calls");
-	if (hdr->ftrace_count > hdr->ftrace_size) {
-		printf(" (%lu dropped due to overflow)",
-		       hdr->ftrace_count - hdr->ftrace_size);
-	}
+	if (total > count)
+		printf(" (%lu dropped due to overflow)", total - count);
 	puts("\n");
-	printf("%15d maximum observed call depth\n", hdr->max_depth);
+	for (slot = 0; slot < TRACE_HARTS; slot++) {
+		struct trace_hart *th = &hdr->hart[slot];
+
+		if (TRACE_HARTS == 1 || !th->ftrace_count)
+			continue;
+		print_grouped_ull(min(th->ftrace_count, th->ftrace_size), 10);
+		printf(" on hart %d", trace_slot_to_hart(slot));
+		if (th->ftrace_count > th->ftrace_size)
+			printf(" (%lu dropped)", th->ftrace_count - th->ftrace_size);
+		puts("\n");
+	}
+	printf("%15d maximum observed call depth\n", max_depth);
 	printf("%15d call depth limit\n", hdr->depth_limit);
-	print_grouped_ull(hdr->ftrace_too_deep_count, 10);
+	print_grouped_ull(too_deep, 10);
 	puts(" calls not traced due to depth\n");
 }
 
+/**
+ * trace_setup_harts() - share out the space for the call records
+ *
+ * @buf:	Start of space for the call records
+ * @size:	Size of space in bytes
+ * @secondary:	true to give the secondary harts some space, false to give it
+ *		all to the boot hart
+ */
+static void __attribute__((no_instrument_function)) trace_setup_harts(
+		char *buf, size_t size, bool secondary)
+{
+	size_t hart_size = 0;
+	int slot;
+
+#if TRACE_HARTS > 1
+	/* The boot hart does most of the work, so gets what is left over */
+	if (secondary && size > CONFIG_TRACE_HART_SIZE * TRACE_HARTS)
+		hart_size = CONFIG_TRACE_HART_SIZE;
+	size -= hart_size * (TRACE_HARTS - 1);
+#endif
+	for (slot = 0; slot < TRACE_HARTS; slot++) {
+		struct trace_hart *th = &hdr->hart[slot];
+
+		th->ftrace = (struct trace_call *)buf;
+		th->ftrace_size = (slot ? hart_size : size) / sizeof(*th->ftrace);
+		buf += slot ? hart_size : size;
+	}
+}
+
 void __attribute__((no_instrument_function)) trace_set_enabled(int enabled)
 {
 	trace_enabled = enabled != 0;
@@ -360,8 +549,8 @@ int __attribute__((no_instrument_function)) trace_init(void *buff,
 		trace_enabled = 0;
 		hdr = map_sysmem(CONFIG_TRACE_EARLY_ADDR,
 				 CONFIG_TRACE_EARLY_SIZE);
-		end = (char *)&hdr->ftrace[min(hdr->ftrace_count,
-					       hdr->ftrace_size)];
+		end = (char *)&hdr->hart[0].ftrace[min(hdr->hart[0].ftrace_count,
+						       hdr->hart[0].ftrace_size)];
 		used = end - (char *)hdr;
 		printf("trace: copying %08lx bytes of early data from %x to %08lx\n",
 		       used, CONFIG_TRACE_EARLY_ADDR,
@@ -380,14 +569,23 @@ int __attribute__((no_instrument_function)) trace_init(void *buff,
 		return -ENOSPC;
 	}
 
-	if (was_disabled)
+	if (was_disabled) {
 		memset(hdr, '\0', needed);
+		hdr->start_time = trace_get_time();
+	} else {
+		int slot;
+
+		/* Only the boot hart's early records are copied */
+		for (slot = 1; slot < TRACE_HARTS; slot++) {
+			hdr->hart[slot].ftrace_count = 0;
+			hdr->hart[slot].ftrace_too_deep_count = 0;
+		}
+	}
 	hdr->func_count = func_count;
 	hdr->call_accum = (uintptr_t *)(hdr + 1);
 
 	/* Use any remaining space for the timed function trace */
-	hdr->ftrace = (struct trace_call *)(buff + needed);
-	hdr->ftrace_size = (buff_size - needed) / sizeof(*hdr->ftrace);
+	trace_setup_harts(buff + needed, buff_size - needed, true);
 	add_textbase();
 
 	puts("trace: enabled\n");
@@ -425,10 +623,10 @@ int __attribute__((no_instrument_function)) trace_early_init(void)
 	memset(hdr, '\0', needed);
 	hdr->call_accum = (uintptr_t *)(hdr + 1);
 	hdr->func_count = func_count;
+	hdr->start_time = trace_get_time();
 
 	/* Use any remaining space for the timed function trace */
-	hdr->ftrace = (struct trace_call *)((char *)hdr + needed);
-	hdr->ftrace_size = (buff_size - needed) / sizeof(*hdr->ftrace);
+	trace_setup_harts((char *)hdr + needed, buff_size - needed, false);
 	add_textbase();
 	hdr->depth_limit = CONFIG_TRACE_EARLY_CALL_DEPTH_LIMIT;
 	printf("trace: early enable at %08x\n", CONFIG_TRACE_EARLY_ADDR);
@@ -0,0 +1,518 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Minimal TCP client, for downloading files over HTTP
+ *
+ * This supports a single connection which we open, which sends small
+ * requests and receives a large amount of data in return. The data is passed
+ * straight to the handler, which normally stores it at its final location,
+ * so the receive window does not depend on any buffer here and can be large.
+ *
+ * A large window is advertised (with window scaling), so that the peer can
+ * keep the link busy. Without SACK the peer cannot tell which segments have
+ * been lost, so out-of-order segments are acknowledged at once with a
+ * duplicate ACK; after three of these the peer retransmits the missing
+ * segment without waiting for its retransmission timer. Data received after
+ * the gap is still passed to the handler if it can store it, so that a
+ * single retransmission fills the gap and the next ACK covers everything.
+ */
+
+#include <common.h>
+#include <log.h>
+#include <net.h>
+#include <rand.h>
+#include <time.h>
+#include <asm/unaligned.h>
+#include <net/tcp.h>
+
+/* Milliseconds to wait for a second segment before sending an ACK */
+#define TCP_ACK_DELAY_MS	10
+
+/* Initial retransmission timeout, doubled on each retry */
+#define TCP_RTO_MS		500
+#define TCP_RTO_MAX_MS		8000
+#define TCP_MAX_RETRIES		6
+
+/**
+ * struct tcp_conn - state of the connection
+ *
+ * Sequence numbers are as in RFC 793.
+ *
+ * @state: Current state
+ * @remote_ip: IP address of the peer
+ * @remote_ether: Ethernet address of the peer (filled in by ARP)
+ * @remote_port: Port number of the peer
+ * @local_port: Our port number
+ * @iss: Initial send sequence number
+ * @snd_una: Oldest unacknowledged sequence number
+ * @snd_nxt: Next sequence number to send
+ * @irs: Initial receive sequence number
+ * @rcv_nxt: Next sequence number expected
+ * @rcv_wscale: Scale for the window we advertise (0 if the peer does not
+ *	support window scaling)
+ * @ooo_start: Start of data held after a gap (valid if @ooo_end != 0)
+ * @ooo_end: End of data held after a gap, or 0 if none
+ * @ack_pending: Number of segments received but not yet acknowledged
+ * @ack_time: Time when the first unacknowledged segment arrived
+ * @rtx_time: Time when the oldest unacknowledged segment was sent
+ * @rto: Current retransmission timeout in milliseconds
+ * @retries: Number of retransmissions of the oldest segment
+ * @tx_flags: Flags sent with @tx_buf (TCP_SYN or TCP_PUSH)
+ * @tx_len: Number of bytes in @tx_buf
+ * @tx_buf: Data sent but not yet acknowledged, for retransmission
+ * @stats: Statistics for this connection
+ */
+struct tcp_conn {
+	enum tcp_state state;
+	struct in_addr remote_ip;
+	uchar remote_ether[ARP_HLEN];
+	int remote_port;
+	int local_port;
+	u32 iss;
+	u32 snd_una;
+	u32 snd_nxt;
+	u32 irs;
+	u32 rcv_nxt;
+	u8 rcv_wscale;
+	u32 ooo_start;
+	u32 ooo_end;
+	uint ack_pending;
+	ulong ack_time;
+	ulong rtx_time;
+	ulong rto;
+	int retries;
+	u8 tx_flags;
+	uint tx_len;
+	uchar tx_buf[TCP_TX_MAX];
+	struct tcp_stats stats;
+};
+
+static struct tcp_conn tcp;
+static rxhand_tcp *tcp_handler;
+
+/* Pseudo header used for the checksum */
+struct tcp_pseudo_hdr {
+	struct in_addr src;
+	struct in_addr dst;
+	u8 zero;
+	u8 proto;
+	u16 len;
+} __attribute__((packed));
+
+static u16 tcp_checksum(struct ip_tcp_hdr *ip, uint tcp_len)
+{
+	struct tcp_pseudo_hdr ph;
+	uint sum;
+
+	net_copy_ip(&ph.src, &ip->ip_src);
+	net_copy_ip(&ph.dst, &ip->ip_dst);
+	ph.zero = 0;
+	ph.proto = IPPROTO_TCP;
+	ph.len = htons(tcp_len);
+	sum = compute_ip_checksum(&ph, sizeof(ph));
+
+	return add_ip_checksums(sizeof(ph), sum,
+				compute_ip_checksum(&ip->tcp_src, tcp_len));
+}
+
+/* Window scale advertised in our SYN, so that the window fits in 16 bits */
+static u8 tcp_our_wscale(void)
+{
+	u8 shift = 0;
+
+	while ((CONFIG_TCP_RCV_WINDOW >> shift) > 0xffff && shift < 14)
+		shift++;
+
+	return shift;
+}
+
+static u16 tcp_window(u8 action)
+{
+	ulong win = CONFIG_TCP_RCV_WINDOW;
+
+	/* The window in a SYN is never scaled */
+	if (!(action & TCP_SYN))
+		win >>= tcp.rcv_wscale;
+
+	return min(win, 0xffffUL);
+}
+
+int tcp_set_tcp_header(uchar *pkt, struct in_addr dest, int dport, int sport,
+		       int payload_len, u8 action, u32 tcp_seq_num,
+		       u32 tcp_ack_num)
+{
+	struct ip_tcp_hdr *ip = (struct ip_tcp_hdr *)pkt;
+	uchar *opt = pkt + IP_TCP_HDR_SIZE;
+	int hdr_len = IP_TCP_HDR_SIZE;
+
+	if (action & TCP_SYN) {
+		opt[0] = TCP_O_MSS;
+		opt[1] = 4;
+		put_unaligned_be16(TCP_MSS, opt + 2);
+		opt[4] = TCP_O_NOP;
+		opt[5] = TCP_O_WS;
+		opt[6] = 3;
+		opt[7] = tcp_our_wscale();
+		hdr_len += 8;
+	}
+
+	/* Zero the byte after odd-length data so that the checksum works */
+	if (payload_len & 1)
+		pkt[hdr_len + payload_len] = 0;
+
+	net_set_ip_header(pkt, dest, net_ip, hdr_len + payload_len,
+			  IPPROTO_TCP);
+
+	ip->tcp_src = htons(sport);
+	ip->tcp_dst = htons(dport);
+	ip->tcp_seq = htonl(tcp_seq_num);
+	ip->tcp_ack = htonl(action & TCP_ACK ? tcp_ack_num : 0);
+	ip->tcp_hlen = (hdr_len - IP_HDR_SIZE) << 2;
+	ip->tcp_flags = action;
+	ip->tcp_win = htons(tcp_window(action));
+	ip->tcp_ugr = 0;
+	ip->tcp_xsum = 0;
+	ip->tcp_xsum = tcp_checksum(ip, hdr_len - IP_HDR_SIZE + payload_len);
+
+	return hdr_len;
+}
+
+static int tcp_event(enum tcp_event event, ulong offset, const uchar *data,
+		     uint len)
+{
+	if (!tcp_handler)
+		return 0;
+
+	return tcp_handler(event, offset, data, len);
+}
+
+static void tcp_send_segment(u8 action, u32 seq, const void *data, uint len)
+{
+	uchar *pkt = net_tx_packet + net_eth_hdr_size() + IP_TCP_HDR_SIZE;
+
+	if (tcp.state != TCP_SYN_SENT)
+		action |= TCP_ACK;
+	if (len)
+		memcpy(pkt, data, len);
+	net_send_ip_packet(tcp.remote_ether, tcp.remote_ip, tcp.remote_port,
+			   tcp.local_port, len, IPPROTO_TCP, action, seq,
+			   tcp.rcv_nxt);
+}
+
+static void tcp_send_ack(void)
+{
+	tcp_send_segment(0, tcp.snd_nxt, NULL, 0);
+	tcp.ack_pending = 0;
+	tcp.stats.acks++;
+}
+
+/* (Re)send the oldest unacknowledged segment */
+static void tcp_send_pending(void)
+{
+	tcp_send_segment(tcp.tx_flags, tcp.snd_una, tcp.tx_buf, tcp.tx_len);
+	tcp.rtx_time = get_timer(0);
+}
+
+/* Queue a segment to be sent reliably */
+static void tcp_queue(u8 flags, const void *data, uint len)
+{
+	tcp.tx_flags = flags;
+	tcp.tx_len = len;
+	if (len)
+		memcpy(tcp.tx_buf, data, len);
+	tcp.snd_nxt = tcp.snd_una + len + (flags & TCP_SYN ? 1 : 0);
+	tcp.rto = TCP_RTO_MS;
+	tcp.retries = 0;
+	tcp.ack_pending = 0;
+	tcp_send_pending();
+}
+
+static void tcp_reset(void)
+{
+	tcp.state = TCP_CLOSED;
+	tcp_event(TCP_EV_RESET, 0, NULL, 0);
+}
+
+void tcp_set_tcp_handler(rxhand_tcp *f)
+{
+	tcp_handler = f;
+}
+
+void tcp_connect(struct in_addr dest, int dport)
+{
+	memset(&tcp, '\0', sizeof(tcp));
+	tcp.remote_ip = dest;
+	tcp.remote_port = dport;
+	tcp.local_port = 1024 + rand() % (65536 - 1024);
+	tcp.iss = rand();
+	tcp.snd_una = tcp.iss;
+	tcp.state = TCP_SYN_SENT;
+	debug("TCP: connect to %pI4:%d from port %d\n", &dest, dport,
+	      tcp.local_port);
+	tcp_queue(TCP_SYN, NULL, 0);
+}
+
+int tcp_send(const void *data, uint len)
+{
+	if (tcp.state != TCP_ESTABLISHED && tcp.state != TCP_CLOSE_WAIT)
+		return -ENOTCONN;
+	if (tcp.snd_una != tcp.snd_nxt)
+		return -EBUSY;
+	if (len > TCP_TX_MAX)
+		return -E2BIG;
+	tcp_queue(TCP_PUSH, data, len);
+
+	return 0;
+}
+
+void tcp_close(void)
+{
+	if (tcp.state != TCP_ESTABLISHED && tcp.state != TCP_CLOSE_WAIT)
+		return;
+
+	/*
+	 * Send FIN once and forget the connection: nothing more is needed from
+	 * the peer, and a stale connection must not be retransmitted by
+	 * tcp_poll() during a later net_loop()
+	 */
+	tcp_send_segment(TCP_FIN, tcp.snd_nxt, NULL, 0);
+	tcp.state = TCP_CLOSED;
+}
+
+void tcp_abort(void)
+{
+	if (tcp.state != TCP_CLOSED && tcp.state != TCP_SYN_SENT)
+		tcp_send_segment(TCP_RST, tcp.snd_nxt, NULL, 0);
+	tcp.state = TCP_CLOSED;
+}
+
+enum tcp_state tcp_get_state(void)
+{
+	return tcp.state;
+}
+
+ulong tcp_get_rx_len(void)
+{
+	if (tcp.state == TCP_SYN_SENT)
+		return 0;
+
+	return tcp.rcv_nxt - tcp.irs - 1;
+}
+
+const struct tcp_stats *tcp_get_stats(void)
+{
+	return &tcp.stats;
+}
+
+void tcp_poll(void)
+{
+	if (tcp.state == TCP_CLOSED)
+		return;
+
+	if (tcp.ack_pending && get_timer(tcp.ack_time) >= TCP_ACK_DELAY_MS)
+		tcp_send_ack();
+
+	if (tcp.snd_una == tcp.snd_nxt || get_timer(tcp.rtx_time) < tcp.rto)
+		return;
+	if (++tcp.retries > TCP_MAX_RETRIES) {
+		debug("TCP: no response from peer\n");
+		tcp_reset();
+		return;
+	}
+	tcp.stats.retransmits++;
+	tcp.rto = min(tcp.rto * 2, (ulong)TCP_RTO_MAX_MS);
+	tcp_send_pending();
+}
+
+/* Look for the window-scale option in a SYN+ACK */
+static bool tcp_peer_has_wscale(const uchar *opt, int len)
+{
+	while (len > 0) {
+		if (opt[0] == TCP_O_END)
+			break;
+		if (opt[0] == TCP_O_NOP) {
+			opt++;
+			len--;
+			continue;
+		}
+		if (len < 2 || opt[1] < 2 || opt[1] > len)
+			break;
+		if (opt[0] == TCP_O_WS)
+			return true;
+		len -= opt[1];
+		opt += opt[1];
+	}
+
+	return false;
+}
+
+static void tcp_rx_ack(u32 ack)
+{
+	/* Ignore ACKs for data we have not sent, or already acknowledged */
+	if ((s32)(ack - tcp.snd_una) <= 0 || (s32)(ack - tcp.snd_nxt) > 0)
+		return;
+	tcp.snd_una = ack;
+	if (ack == tcp.snd_nxt)
+		tcp.tx_len = 0;
+}
+
+/*
+ * Keep data received after a gap, if the handler can store it. Only a single
+ * block is tracked, which is enough to recover from a burst of losses.
+ */
+static void tcp_rx_ooo(u32 seq, const uchar *data, uint len)
+{
+	u32 end = seq + len;
+
+	if (tcp.ooo_end) {
+		/* Only allow the block to grow at either end */
+		if ((s32)(seq - tcp.ooo_end) > 0 ||
+		    (s32)(end - tcp.ooo_start) < 0)
+			return;
+		if ((s32)(seq - tcp.ooo_start) >= 0 &&
+		    (s32)(end - tcp.ooo_end) <= 0)
+			return;
+	}
+	if (tcp_event(TCP_EV_DATA, seq - tcp.irs - 1, data, len))
+		return;
+
+	if (!tcp.ooo_end) {
+		tcp.ooo_start = seq;
+		tcp.ooo_end = end;
+		return;
+	}
+	if ((s32)(seq - tcp.ooo_start) < 0)
+		tcp.ooo_start = seq;
+	if ((s32)(end - tcp.ooo_end) > 0)
+		tcp.ooo_end = end;
+}
+
+static void tcp_rx_data(u32 seq, const uchar *data, uint len, u8 flags)
+{
+	s32 off = seq - tcp.rcv_nxt;
+	int ret;
+
+	tcp.stats.segs++;
+	if (off < 0) {
+		if ((s32)(seq + len - tcp.rcv_nxt) <= 0) {
+			/* Already have all of it; our ACK may have been lost */
+			tcp.stats.dup_segs++;
+			tcp_send_ack();
+			return;
+		}
+		data -= off;
+		len += off;
+		seq = tcp.rcv_nxt;
+		off = 0;
+	}
+	if (off >= CONFIG_TCP_RCV_WINDOW)
+		return;
+	/* Drop the part beyond the window we advertised */
+	if (off + len > CONFIG_TCP_RCV_WINDOW)
+		len = CONFIG_TCP_RCV_WINDOW - off;
+
+	if (off > 0) {
+		tcp.stats.ooo_segs++;
+		tcp_rx_ooo(seq, data, len);
+		tcp.stats.dup_acks++;
+		tcp_send_ack();
+		return;
+	}
+
+	tcp.rcv_nxt += len;
+	if (tcp.ooo_end && (s32)(tcp.rcv_nxt - tcp.ooo_start) >= 0) {
+		/* The gap is filled, so acknowledge everything at once */
+		if ((s32)(tcp.ooo_end - tcp.rcv_nxt) > 0)
+			tcp.rcv_nxt = tcp.ooo_end;
+		tcp.ooo_end = 0;
+		tcp.ack_pending = 1;
+	}
+
+	ret = tcp_event(TCP_EV_DATA, seq - tcp.irs - 1, data, len);
+	if (ret) {
+		debug("TCP: handler failed (err=%d)\n", ret);
+		tcp_abort();
+		return;
+	}
+	if (tcp.state == TCP_CLOSED)
+		return;
+
+	/* While there is still a gap, keep telling the peer about it */
+	if (tcp.ooo_end) {
+		tcp_send_ack();
+		return;
+	}
+
+	/* ACK every second segment, as recommended by RFC 1122 */
+	if (++tcp.ack_pending >= 2 || (flags & TCP_PUSH))
+		tcp_send_ack();
+	else
+		tcp.ack_time = get_timer(0);
+}
+
+void tcp_receive(struct ip_tcp_hdr *ip, int len)
+{
+	uint tcp_len = ntohs(ip->ip_len) - IP_HDR_SIZE;
+	uint hlen = (ip->tcp_hlen >> 4) * 4;
+	struct in_addr src;
+	uint data_len;
+	u32 seq, ack;
+	u8 flags;
+
+	if (tcp.state == TCP_CLOSED)
+		return;
+	if (tcp_len < TCP_HDR_SIZE || tcp_len > len - IP_HDR_SIZE ||
+	    hlen < TCP_HDR_SIZE || hlen > tcp_len)
+		return;
+
+	src = net_read_ip(&ip->ip_src);
+	if (ntohs(ip->tcp_dst) != tcp.local_port ||
+	    ntohs(ip->tcp_src) != tcp.remote_port ||
+	    src.s_addr != tcp.remote_ip.s_addr)
+		return;
+	if (tcp_checksum(ip, tcp_len)) {
+		debug("TCP: bad checksum\n");
+		return;
+	}
+
+	flags = ip->tcp_flags;
+	seq = ntohl(ip->tcp_seq);
+	ack = ntohl(ip->tcp_ack);
+	data_len = tcp_len - hlen;
+
+	if (flags & TCP_RST) {
+		debug("TCP: connection reset by peer\n");
+		tcp_reset();
+		return;
+	}
+
+	if (tcp.state == TCP_SYN_SENT) {
+		if ((flags & (TCP_SYN | TCP_ACK)) != (TCP_SYN | TCP_ACK) ||
+		    ack != tcp.iss + 1)
+			return;
+		if (tcp_peer_has_wscale((uchar *)(ip + 1), hlen - TCP_HDR_SIZE))
+			tcp.rcv_wscale = tcp_our_wscale();
+		tcp.irs = seq;
+		tcp.rcv_nxt = seq + 1;
+		tcp_rx_ack(ack);
+		tcp.state = TCP_ESTABLISHED;
+		tcp_send_ack();
+		if (tcp_event(TCP_EV_CONNECTED, 0, NULL, 0))
+			tcp_abort();
+		return;
+	}
+
+	if (flags & TCP_ACK)
+		tcp_rx_ack(ack);
+	if (data_len)
+		tcp_rx_data(seq, (uchar *)ip + IP_HDR_SIZE + hlen, data_len,
+			    flags);
+	if (tcp.state == TCP_CLOSED)
+		return;
+
+	if ((flags & TCP_FIN) && seq + data_len == tcp.rcv_nxt) {
+		tcp.rcv_nxt++;
+		tcp_send_ack();
+		tcp.state = TCP_CLOSE_WAIT;
+		tcp_event(TCP_EV_CLOSED, 0, NULL, 0);
+	}
+}
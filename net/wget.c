@@ -0,0 +1,375 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * HTTP client, for downloading files over TCP
+ *
+ * A single GET request is sent for each download. The body is stored at the
+ * load address as it arrives, using its offset in the TCP stream, so data
+ * which arrives after a lost segment is stored too (see net/tcp.c).
+ *
+ * Range requests allow a large file to be downloaded in parts, e.g. so that
+ * each part can be written to storage before the next is fetched.
+ */
+
+#include <common.h>
+#include <display_options.h>
+#include <env.h>
+#include <image.h>
+#include <lmb.h>
+#include <log.h>
+#include <mapmem.h>
+#include <net.h>
+#include <vsprintf.h>
+#include <asm/global_data.h>
+#include <net/tcp.h>
+#include <net/wget.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Give up if nothing is received for this long */
+#define WGET_TIMEOUT_MS		10000
+
+#define WGET_PATH_MAX		256
+#define WGET_HDR_MAX		2048
+
+/* Bytes per hash mark */
+#define HASH_BYTES		(256 << 10)
+#define HASHES_PER_LINE		64
+
+enum wget_state {
+	WGET_CONNECTING,
+	WGET_HEADERS,
+	WGET_BODY,
+	WGET_DONE,
+};
+
+static enum wget_state wget_state;
+static struct in_addr wget_server_ip;
+static char wget_path[WGET_PATH_MAX];
+static char wget_hdr[WGET_HDR_MAX + 1];
+static uint wget_hdr_len;
+static ulong wget_body_start;	/* offset of the body in the TCP stream */
+static ulong wget_content_len;	/* 0 if the server did not say */
+static ulong wget_load_addr;
+static ulong wget_load_size;
+static ulong wget_range_offset;
+static ulong wget_range_size;
+static ulong wget_total_size;
+static int wget_status;
+static ulong wget_hashes;
+static ulong time_start;
+
+void wget_set_range(ulong offset, ulong size)
+{
+	wget_range_offset = offset;
+	wget_range_size = size;
+}
+
+ulong wget_get_total_size(void)
+{
+	return wget_total_size;
+}
+
+int wget_get_status(void)
+{
+	return wget_status;
+}
+
+static void wget_fail(const char *msg)
+{
+	printf("\nHTTP error: %s\n", msg);
+	wget_state = WGET_DONE;
+	net_set_state(NETLOOP_FAIL);
+}
+
+static void wget_complete(void)
+{
+	const struct tcp_stats *stats = tcp_get_stats();
+
+	wget_state = WGET_DONE;
+	tcp_close();
+
+	time_start = get_timer(time_start);
+	if (time_start > 0) {
+		puts("\n\t ");	/* Line up with "Loading: " */
+		print_size(net_boot_file_size / time_start * 1000, "/s");
+	}
+	puts("\ndone\n");
+	debug("TCP: %u segs, %u out of order, %u dups, %u acks, %u dup acks, %u retransmits\n",
+	      stats->segs, stats->ooo_segs, stats->dup_segs, stats->acks,
+	      stats->dup_acks, stats->retransmits);
+	net_set_state(NETLOOP_SUCCESS);
+}
+
+static void wget_timeout_handler(void)
+{
+	tcp_abort();
+	wget_fail("timeout");
+}
+
+static int wget_send_request(void)
+{
+	char req[TCP_TX_MAX];
+	int len;
+
+	len = snprintf(req, sizeof(req),
+		       "GET %s%s HTTP/1.1\r\n"
+		       "Host: %pI4\r\n"
+		       "User-Agent: U-Boot\r\n"
+		       "Connection: close\r\n",
+		       *wget_path == '/' ? "" : "/", wget_path,
+		       &wget_server_ip);
+	if (wget_range_offset || wget_range_size) {
+		len += snprintf(req + len, sizeof(req) - len,
+				"Range: bytes=%lu-", wget_range_offset);
+		if (wget_range_size)
+			len += snprintf(req + len, sizeof(req) - len, "%lu",
+					wget_range_offset + wget_range_size - 1);
+		len += snprintf(req + len, sizeof(req) - len, "\r\n");
+	}
+	len += snprintf(req + len, sizeof(req) - len, "\r\n");
+	if (len >= sizeof(req)) {
+		wget_fail("file name too long");
+		return -E2BIG;
+	}
+	wget_state = WGET_HEADERS;
+
+	return tcp_send(req, len);
+}
+
+/* Find the value of a header line, or return NULL if not present */
+static const char *wget_find_header(const char *name)
+{
+	int len = strlen(name);
+	const char *p;
+
+	for (p = strstr(wget_hdr, "\r\n"); p; p = strstr(p, "\r\n")) {
+		p += 2;
+		if (!strncasecmp(p, name, len) && p[len] == ':') {
+			for (p += len + 1; *p == ' '; p++)
+				;
+			return p;
+		}
+	}
+
+	return NULL;
+}
+
+static int wget_parse_headers(void)
+{
+	const char *val;
+
+	if (strncmp(wget_hdr, "HTTP/1.", 7)) {
+		wget_fail("bad response");
+		return -EPROTO;
+	}
+	wget_status = simple_strtoul(wget_hdr + 9, NULL, 10);
+
+	switch (wget_status) {
+	case 200:
+		if (wget_range_offset) {
+			wget_fail("server does not support ranges");
+			return -EPROTO;
+		}
+		break;
+	case 206:
+		break;
+	case 404:
+		wget_fail("file not found");
+		return -ENOENT;
+	default:
+		printf("\nHTTP status %d", wget_status);
+		wget_fail("request failed");
+		return -EPROTO;
+	}
+
+	val = wget_find_header("Content-Length");
+	if (val)
+		wget_content_len = simple_strtoul(val, NULL, 10);
+
+	val = wget_find_header("Content-Range");
+	if (val && wget_status == 206) {
+		val = strchr(val, '/');
+		if (val && val[1] != '*')
+			wget_total_size = simple_strtoul(val + 1, NULL, 10);
+	} else {
+		wget_total_size = wget_content_len;
+	}
+
+	/*
+	 * A server which ignores the range sends the whole file, which is
+	 * fine from offset 0 as long as we stop after the part we asked for
+	 */
+	if (wget_status == 200 && wget_range_size &&
+	    (!wget_content_len || wget_content_len > wget_range_size))
+		wget_content_len = wget_range_size;
+
+	return 0;
+}
+
+static void wget_show_progress(void)
+{
+	while (wget_hashes < net_boot_file_size / HASH_BYTES) {
+		putc('#');
+		if (!(++wget_hashes % HASHES_PER_LINE))
+			puts("\n\t ");
+	}
+}
+
+static int wget_rx_body(ulong offset, const uchar *data, uint len)
+{
+	ulong pos = offset - wget_body_start;
+	void *ptr;
+
+	if (wget_content_len) {
+		if (pos >= wget_content_len)
+			return 0;
+		len = min((ulong)len, wget_content_len - pos);
+	}
+	if (wget_load_size && pos + len > wget_load_size) {
+		wget_fail("trying to overwrite reserved memory");
+		return -ENOSPC;
+	}
+
+	ptr = map_sysmem(wget_load_addr + pos, len);
+	memcpy(ptr, data, len);
+	unmap_sysmem(ptr);
+
+	if (net_boot_file_size < pos + len) {
+		net_boot_file_size = pos + len;
+		wget_show_progress();
+	}
+
+	if (wget_content_len &&
+	    tcp_get_rx_len() - wget_body_start >= wget_content_len)
+		wget_complete();
+
+	return 0;
+}
+
+static int wget_rx_headers(ulong offset, const uchar *data, uint len)
+{
+	uint copy, used;
+	char *end;
+	int ret;
+
+	/* Data after a gap must wait until we know where the body starts */
+	if (offset != wget_hdr_len)
+		return -EAGAIN;
+
+	copy = min(len, WGET_HDR_MAX - wget_hdr_len);
+	memcpy(wget_hdr + wget_hdr_len, data, copy);
+	wget_hdr_len += copy;
+	wget_hdr[wget_hdr_len] = '\0';
+
+	end = strstr(wget_hdr, "\r\n\r\n");
+	if (!end) {
+		if (wget_hdr_len == WGET_HDR_MAX) {
+			wget_fail("headers too long");
+			return -E2BIG;
+		}
+		return 0;
+	}
+	end[2] = '\0';
+	wget_body_start = end + 4 - wget_hdr;
+
+	ret = wget_parse_headers();
+	if (ret)
+		return ret;
+	wget_state = WGET_BODY;
+
+	used = wget_body_start - offset;
+	if (len > used)
+		return wget_rx_body(wget_body_start, data + used, len - used);
+
+	return 0;
+}
+
+static int wget_handler(enum tcp_event event, ulong offset, const uchar *data,
+			uint len)
+{
+	switch (event) {
+	case TCP_EV_CONNECTED:
+		return wget_send_request();
+	case TCP_EV_DATA:
+		net_set_timeout_handler(WGET_TIMEOUT_MS, wget_timeout_handler);
+		if (wget_state == WGET_HEADERS)
+			return wget_rx_headers(offset, data, len);
+		if (wget_state == WGET_BODY)
+			return wget_rx_body(offset, data, len);
+		break;
+	case TCP_EV_CLOSED:
+		/* Without a length, the body ends when the server closes */
+		if (wget_state == WGET_BODY && !wget_content_len) {
+			wget_total_size = net_boot_file_size;
+			wget_complete();
+		} else if (wget_state != WGET_DONE) {
+			tcp_abort();
+			wget_fail("connection closed early");
+		}
+		break;
+	case TCP_EV_RESET:
+		if (wget_state != WGET_DONE)
+			wget_fail("connection reset");
+		break;
+	}
+
+	return 0;
+}
+
+/* Initialize wget_load_addr and wget_load_size from image_load_addr and lmb */
+static int wget_init_load_addr(void)
+{
+#ifdef CONFIG_LMB
+	struct lmb lmb;
+	phys_size_t max_size;
+
+	lmb_init_and_reserve(&lmb, gd->bd, (void *)gd->fdt_blob);
+
+	max_size = lmb_get_free_size(&lmb, image_load_addr);
+	if (!max_size)
+		return -1;
+
+	wget_load_size = max_size;
+#endif
+	wget_load_addr = image_load_addr;
+	return 0;
+}
+
+void wget_start(void)
+{
+	int port;
+
+	wget_state = WGET_CONNECTING;
+	wget_hdr_len = 0;
+	wget_content_len = 0;
+	wget_total_size = 0;
+	wget_status = 0;
+	wget_hashes = 0;
+
+	wget_server_ip = net_server_ip;
+	if (!net_parse_bootfile(&wget_server_ip, wget_path, WGET_PATH_MAX)) {
+		wget_fail("no file name");
+		return;
+	}
+	port = env_get_ulong("httpdstp", 10, WGET_HTTP_PORT);
+
+	if (wget_init_load_addr()) {
+		wget_fail("trying to overwrite reserved memory");
+		return;
+	}
+
+	printf("Using %s device\n", eth_get_name());
+	printf("HTTP from server %pI4:%d; our IP address is %pI4\n",
+	       &wget_server_ip, port, &net_ip);
+	printf("Filename '%s'.", wget_path);
+	if (wget_range_offset || wget_range_size)
+		printf(" Range 0x%lx+0x%lx", wget_range_offset,
+		       wget_range_size);
+	printf("\nLoad address: 0x%lx\n", wget_load_addr);
+	puts("Loading: *\b");
+
+	time_start = get_timer(0);
+	net_set_timeout_handler(WGET_TIMEOUT_MS, wget_timeout_handler);
+	tcp_set_tcp_handler(wget_handler);
+	tcp_connect(wget_server_ip, port);
+}
@@ -0,0 +1,370 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the wget command, using a fake HTTP server on the sandbox
+ * Ethernet device
+ */
+
+#include <common.h>
+#include <command.h>
+#include <dm.h>
+#include <env.h>
+#include <mapmem.h>
+#include <net.h>
+#include <vsprintf.h>
+#include <asm/eth.h>
+#include <dm/test.h>
+#include <net/tcp.h>
+#include <net/wget.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+#define BODY_SIZE	20000
+#define SEG_SIZE	1000U
+#define LOAD_ADDR	0x1000000
+
+/**
+ * struct sb_http - state of the fake HTTP server
+ *
+ * @iss: Our initial sequence number
+ * @snd_nxt: Next sequence number to send
+ * @last_ack: Last acknowledgment number received
+ * @client_nxt: Next sequence number expected from the client
+ * @drop_seg: Index of a segment to drop the first time it is sent, or -1
+ * @dropped: true once @drop_seg has been dropped
+ * @retransmits: Number of segments resent after a duplicate ACK
+ * @no_ranges: true to ignore Range headers and always send the whole file
+ * @resp_len: Length of the response, or 0 if no request received yet
+ * @resp: Response to send (headers and body)
+ */
+struct sb_http {
+	u32 iss;
+	u32 snd_nxt;
+	u32 last_ack;
+	u32 client_nxt;
+	int drop_seg;
+	bool dropped;
+	int retransmits;
+	bool no_ranges;
+	uint resp_len;
+	char resp[BODY_SIZE + 256];
+};
+
+static struct sb_http sb_http;
+
+static u8 body_byte(uint i)
+{
+	return (i * 7 + (i >> 8)) & 0xff;
+}
+
+static u16 sb_tcp_checksum(struct ip_tcp_hdr *ip, uint tcp_len)
+{
+	struct {
+		struct in_addr src;
+		struct in_addr dst;
+		u8 zero;
+		u8 proto;
+		u16 len;
+	} __packed ph;
+	uint sum;
+
+	net_copy_ip(&ph.src, &ip->ip_src);
+	net_copy_ip(&ph.dst, &ip->ip_dst);
+	ph.zero = 0;
+	ph.proto = IPPROTO_TCP;
+	ph.len = htons(tcp_len);
+	sum = compute_ip_checksum(&ph, sizeof(ph));
+
+	return add_ip_checksums(sizeof(ph), sum,
+				compute_ip_checksum(&ip->tcp_src, tcp_len));
+}
+
+/* Inject a TCP segment in reply to @req */
+static void sb_http_send(struct udevice *dev, void *req, u8 flags, u32 seq,
+			 const void *data, uint len)
+{
+	struct eth_sandbox_priv *priv = dev_get_priv(dev);
+	struct ethernet_hdr *eth = req;
+	struct ip_tcp_hdr *ip = req + ETHER_HDR_SIZE;
+	struct ethernet_hdr *eth_recv;
+	struct ip_tcp_hdr *ipr;
+	uint opt_len = flags & TCP_SYN ? 8 : 0;
+	uint tcp_len = TCP_HDR_SIZE + opt_len + len;
+	uchar *opt;
+
+	if (priv->recv_packets >= PKTBUFSRX)
+		return;
+
+	eth_recv = (void *)priv->recv_packet_buffer[priv->recv_packets];
+	memcpy(eth_recv->et_dest, eth->et_src, ARP_HLEN);
+	memcpy(eth_recv->et_src, priv->fake_host_hwaddr, ARP_HLEN);
+	eth_recv->et_protlen = htons(PROT_IP);
+
+	ipr = (void *)eth_recv + ETHER_HDR_SIZE;
+	ipr->ip_hl_v = 0x45;
+	ipr->ip_tos = 0;
+	ipr->ip_len = htons(IP_HDR_SIZE + tcp_len);
+	ipr->ip_id = 0;
+	ipr->ip_off = htons(IP_FLAGS_DFRAG);
+	ipr->ip_ttl = 64;
+	ipr->ip_p = IPPROTO_TCP;
+	ipr->ip_sum = 0;
+	net_copy_ip(&ipr->ip_src, &ip->ip_dst);
+	net_copy_ip(&ipr->ip_dst, &ip->ip_src);
+	ipr->ip_sum = compute_ip_checksum(ipr, IP_HDR_SIZE);
+
+	ipr->tcp_src = ip->tcp_dst;
+	ipr->tcp_dst = ip->tcp_src;
+	ipr->tcp_seq = htonl(seq);
+	ipr->tcp_ack = htonl(sb_http.client_nxt);
+	ipr->tcp_hlen = (TCP_HDR_SIZE + opt_len) << 2;
+	ipr->tcp_flags = flags;
+	ipr->tcp_win = htons(0xffff);
+	ipr->tcp_ugr = 0;
+
+	opt = (uchar *)(ipr + 1);
+	if (opt_len) {
+		opt[0] = TCP_O_MSS;
+		opt[1] = 4;
+		opt[2] = 1460 >> 8;
+		opt[3] = 1460 & 0xff;
+		opt[4] = TCP_O_NOP;
+		opt[5] = TCP_O_WS;
+		opt[6] = 3;
+		opt[7] = 0;
+	}
+	memcpy(opt + opt_len, data, len);
+	ipr->tcp_xsum = 0;
+	ipr->tcp_xsum = sb_tcp_checksum(ipr, tcp_len);
+
+	priv->recv_packet_length[priv->recv_packets++] =
+		ETHER_HDR_SIZE + IP_HDR_SIZE + tcp_len;
+}
+
+/* Send the response segment starting at sequence number @seq */
+static void sb_http_send_seg(struct udevice *dev, void *req, u32 seq)
+{
+	uint off = seq - sb_http.iss - 1;
+	uint len = min(SEG_SIZE, sb_http.resp_len - off);
+	u8 flags = TCP_ACK;
+
+	if (off + len == sb_http.resp_len)
+		flags |= TCP_PUSH;
+	sb_http_send(dev, req, flags, seq, sb_http.resp + off, len);
+}
+
+static void sb_http_request(const char *req)
+{
+	ulong start = 0, end = BODY_SIZE - 1;
+	const char *range;
+	int hdr_len, i;
+
+	if (strncmp(req, "GET /file.bin ", 14)) {
+		sb_http.resp_len = sprintf(sb_http.resp,
+			"HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+		return;
+	}
+
+	range = strstr(req, "Range: bytes=");
+	if (range && !sb_http.no_ranges) {
+		start = simple_strtoul(range + 13, (char **)&range, 10);
+		if (*range == '-' && range[1] != '\r')
+			end = simple_strtoul(range + 1, NULL, 10);
+		hdr_len = sprintf(sb_http.resp,
+				  "HTTP/1.1 206 Partial Content\r\n"
+				  "Content-Length: %lu\r\n"
+				  "Content-Range: bytes %lu-%lu/%u\r\n\r\n",
+				  end - start + 1, start, end, BODY_SIZE);
+	} else {
+		hdr_len = sprintf(sb_http.resp,
+				  "HTTP/1.1 200 OK\r\n"
+				  "Content-Length: %u\r\n\r\n", BODY_SIZE);
+	}
+	for (i = start; i <= end; i++)
+		sb_http.resp[hdr_len + i - start] = body_byte(i);
+	sb_http.resp_len = hdr_len + end - start + 1;
+}
+
+static int sb_http_handler(struct udevice *dev, void *packet,
+			   unsigned int len)
+{
+	struct ethernet_hdr *eth = packet;
+	struct ip_tcp_hdr *ip = packet + ETHER_HDR_SIZE;
+	uint hlen, data_len, off;
+	u32 ack;
+	int i;
+
+	if (!sandbox_eth_arp_req_to_reply(dev, packet, len))
+		return 0;
+	if (ntohs(eth->et_protlen) != PROT_IP || ip->ip_p != IPPROTO_TCP ||
+	    ntohs(ip->tcp_dst) != WGET_HTTP_PORT)
+		return 0;
+
+	hlen = (ip->tcp_hlen >> 4) * 4;
+	data_len = ntohs(ip->ip_len) - IP_HDR_SIZE - hlen;
+
+	if (ip->tcp_flags & TCP_SYN) {
+		sb_http.client_nxt = ntohl(ip->tcp_seq) + 1;
+		sb_http.snd_nxt = sb_http.iss + 1;
+		sb_http.last_ack = sb_http.snd_nxt;
+		sb_http.resp_len = 0;
+		sb_http_send(dev, packet, TCP_SYN | TCP_ACK, sb_http.iss, NULL,
+			     0);
+		return 0;
+	}
+	if (ip->tcp_flags & (TCP_RST | TCP_FIN) || !(ip->tcp_flags & TCP_ACK))
+		return 0;
+
+	if (data_len) {
+		char req[TCP_TX_MAX + 1];
+
+		memcpy(req, (void *)ip + IP_HDR_SIZE + hlen, data_len);
+		req[data_len] = '\0';
+		sb_http.client_nxt += data_len;
+		sb_http_request(req);
+	}
+	if (!sb_http.resp_len)
+		return 0;
+
+	/* Fast retransmit on the first duplicate ACK */
+	ack = ntohl(ip->tcp_ack);
+	if (!data_len && ack == sb_http.last_ack && ack != sb_http.snd_nxt) {
+		sb_http.retransmits++;
+		sb_http_send_seg(dev, packet, ack);
+		return 0;
+	}
+	sb_http.last_ack = ack;
+
+	for (i = 0; i < 2; i++) {
+		off = sb_http.snd_nxt - sb_http.iss - 1;
+		if (off >= sb_http.resp_len)
+			break;
+		if (off / SEG_SIZE == sb_http.drop_seg && !sb_http.dropped)
+			sb_http.dropped = true;
+		else
+			sb_http_send_seg(dev, packet, sb_http.snd_nxt);
+		sb_http.snd_nxt += min(SEG_SIZE, sb_http.resp_len - off);
+	}
+
+	return 0;
+}
+
+static int check_body(struct unit_test_state *uts, ulong start, ulong size)
+{
+	u8 *buf = map_sysmem(LOAD_ADDR, size);
+	ulong i;
+
+	for (i = 0; i < size; i++) {
+		if (buf[i] != body_byte(start + i)) {
+			printf("mismatch at %lx\n", i);
+			ut_asserteq(body_byte(start + i), buf[i]);
+		}
+	}
+	unmap_sysmem(buf);
+
+	return 0;
+}
+
+static void sb_http_reset(int drop_seg)
+{
+	memset(&sb_http, '\0', sizeof(sb_http));
+	sb_http.iss = 0x12345678;
+	sb_http.drop_seg = drop_seg;
+}
+
+/* Download a whole file, recovering from a lost segment */
+static int dm_test_cmd_wget(struct unit_test_state *uts)
+{
+	const struct tcp_stats *stats = tcp_get_stats();
+
+	sandbox_eth_set_tx_handler(0, sb_http_handler);
+	env_set("ethact", "eth@10002000");
+	sb_http_reset(5);
+	memset(map_sysmem(LOAD_ADDR, BODY_SIZE), '\0', BODY_SIZE);
+
+	ut_assertok(run_command("wget " __stringify(LOAD_ADDR)
+				" 1.1.2.2:/file.bin", 0));
+	ut_asserteq(BODY_SIZE, env_get_hex("filesize", 0));
+	ut_asserteq(200, wget_get_status());
+	ut_asserteq(BODY_SIZE, wget_get_total_size());
+	ut_assertok(check_body(uts, 0, BODY_SIZE));
+
+	/* The lost segment should be resent once, after a duplicate ACK */
+	ut_assert(sb_http.dropped);
+	ut_asserteq(1, sb_http.retransmits);
+	ut_asserteq(1, stats->ooo_segs);
+	ut_asserteq(1, stats->dup_acks);
+	ut_asserteq(0, stats->retransmits);
+
+	sandbox_eth_set_tx_handler(0, NULL);
+
+	return 0;
+}
+DM_TEST(dm_test_cmd_wget, UT_TESTF_SCAN_FDT);
+
+/* Download part of a file */
+static int dm_test_cmd_wget_range(struct unit_test_state *uts)
+{
+	sandbox_eth_set_tx_handler(0, sb_http_handler);
+	env_set("ethact", "eth@10002000");
+	sb_http_reset(-1);
+
+	wget_set_range(5000, 3000);
+	ut_assertok(run_command("wget " __stringify(LOAD_ADDR)
+				" 1.1.2.2:/file.bin", 0));
+	ut_asserteq(3000, env_get_hex("filesize", 0));
+	ut_asserteq(206, wget_get_status());
+	ut_asserteq(BODY_SIZE, wget_get_total_size());
+	ut_assertok(check_body(uts, 5000, 3000));
+
+	sandbox_eth_set_tx_handler(0, NULL);
+
+	return 0;
+}
+DM_TEST(dm_test_cmd_wget_range, UT_TESTF_SCAN_FDT);
+
+/* Download part of a file from a server which does not support ranges */
+static int dm_test_cmd_wget_no_range(struct unit_test_state *uts)
+{
+	sandbox_eth_set_tx_handler(0, sb_http_handler);
+	env_set("ethact", "eth@10002000");
+	sb_http_reset(-1);
+	sb_http.no_ranges = true;
+
+	/* From the start, the whole file is sent and the rest is ignored */
+	wget_set_range(0, 3000);
+	ut_assertok(run_command("wget " __stringify(LOAD_ADDR)
+				" 1.1.2.2:/file.bin", 0));
+	ut_asserteq(3000, env_get_hex("filesize", 0));
+	ut_asserteq(200, wget_get_status());
+	ut_asserteq(BODY_SIZE, wget_get_total_size());
+	ut_assertok(check_body(uts, 0, 3000));
+
+	/* Anywhere else, the data would be in the wrong place */
+	sb_http_reset(-1);
+	sb_http.no_ranges = true;
+	wget_set_range(5000, 3000);
+	ut_asserteq(1, run_command("wget " __stringify(LOAD_ADDR)
+				   " 1.1.2.2:/file.bin", 0));
+
+	sandbox_eth_set_tx_handler(0, NULL);
+
+	return 0;
+}
+DM_TEST(dm_test_cmd_wget_no_range, UT_TESTF_SCAN_FDT);
+
+/* A missing file should fail without retrying */
+static int dm_test_cmd_wget_not_found(struct unit_test_state *uts)
+{
+	sandbox_eth_set_tx_handler(0, sb_http_handler);
+	env_set("ethact", "eth@10002000");
+	sb_http_reset(-1);
+
+	ut_asserteq(1, run_command("wget " __stringify(LOAD_ADDR)
+				   " 1.1.2.2:/missing.bin", 0));
+	ut_asserteq(404, wget_get_status());
+
+	sandbox_eth_set_tx_handler(0, NULL);
+
+	return 0;
+}
+DM_TEST(dm_test_cmd_wget_not_found, UT_TESTF_SCAN_FDT);
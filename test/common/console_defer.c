@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for deferred console output
+ */
+
+#include <common.h>
+#include <command.h>
+#include <console.h>
+#include <asm/global_data.h>
+#include <asm/serial.h>
+#include <test/common.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+static int test_console_defer(struct unit_test_state *uts)
+{
+	size_t start;
+
+	/* nothing is added to the ring while the console is silent */
+	gd->flags &= ~GD_FLG_SILENT;
+	sandbox_serial_endisable(false);
+	console_log_clear();
+
+	/* the sandbox UART never fills up, so this goes out straight away */
+	start = sandbox_serial_written();
+	puts("deferred\n");
+	ut_asserteq(strlen("deferred\r\n"), sandbox_serial_written() - start);
+
+	/* the history is shown once, then cleared */
+	ut_assertok(run_command("dmesg -c", 0));
+	ut_assertok(run_command("dmesg", 0));
+	sandbox_serial_endisable(true);
+	ut_silence_console(uts);
+
+	ut_assert_nextline("deferred");
+	ut_assert_nextline("deferred");
+	ut_assert_console_end();
+
+	return 0;
+}
+COMMON_TEST(test_console_defer, UT_TESTF_CONSOLE_REC);
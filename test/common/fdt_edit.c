@@ -0,0 +1,278 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for FDT editing sessions
+ */
+
+#include <common.h>
+#include <fdt_support.h>
+#include <malloc.h>
+#include <time.h>
+#include <asm/global_data.h>
+#include <test/common.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Room for the fixups, on top of the control FDT */
+#define FIXUP_SPACE	0x1000
+
+#define SPEED_LOOPS	100
+
+/*
+ * Properties set on K1 by ft_board_setup() and fdt_chosen() before booting
+ * Linux, with typical sizes. The board-specific nodes are replaced by ones
+ * which exist in the sandbox test FDT.
+ */
+static const struct {
+	const char *path;
+	const char *name;
+	int len;
+} fixups[] = {
+	{ "/chosen", "rng-seed", 64 },
+	{ "/chosen", "bootargs", 220 },
+	{ "/chosen", "u-boot,version", 32 },
+	{ "/chosen", "linux,stdout-path", 24 },
+	{ "/", "model", 20 },
+	{ "/", "product-id", 4 },
+	{ "/", "wafer-id", 4 },
+	{ "/", "part-number", 12 },
+	{ "/cpus", "svt-dro", 4 },
+	{ "/some-bus", "wifi_addr", 17 },
+	{ "/some-bus", "bt_addr", 17 },
+};
+
+static void fixup_value(int idx, u8 *val)
+{
+	int i;
+
+	for (i = 0; i < fixups[idx].len; i++)
+		val[i] = idx * 16 + i;
+}
+
+/* Apply the fixups one at a time, the way board code usually does */
+static int fixup_by_setprop(void *fdt)
+{
+	u8 val[256];
+	int i, node, ret;
+
+	for (i = 0; i < ARRAY_SIZE(fixups); i++) {
+		node = fdt_path_offset(fdt, fixups[i].path);
+		if (node < 0)
+			return node;
+		fixup_value(i, val);
+		ret = fdt_setprop(fdt, node, fixups[i].name, val, fixups[i].len);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/*
+ * Apply the fixups using an editing session, either in one pass or, with
+ * @in_place, one at a time as when there is no memory for a pass
+ */
+static int fixup_by_edit(void *fdt, bool in_place)
+{
+	struct fdt_edit edit;
+	u8 val[256];
+	int i, ret;
+
+	ret = fdt_edit_open(&edit, fdt, 0);
+	if (ret)
+		return ret;
+	edit.in_place = in_place;
+	for (i = 0; i < ARRAY_SIZE(fixups); i++) {
+		fixup_value(i, val);
+		fdt_edit_setprop(&edit, fdt_edit_node(&edit, fixups[i].path),
+				 fixups[i].name, val, fixups[i].len);
+	}
+
+	return fdt_edit_close(&edit);
+}
+
+/* Check that every node in @fdt has the same properties in @ref */
+static int check_same(struct unit_test_state *uts, const void *fdt,
+		      const void *ref)
+{
+	int node, ref_node, prop, count, ref_count;
+
+	for (node = 0, ref_node = 0; node >= 0 || ref_node >= 0;
+	     node = fdt_next_node(fdt, node, NULL),
+	     ref_node = fdt_next_node(ref, ref_node, NULL)) {
+		ut_assert(node >= 0 && ref_node >= 0);
+		ut_asserteq_str(fdt_get_name(ref, ref_node, NULL),
+				fdt_get_name(fdt, node, NULL));
+
+		count = 0;
+		fdt_for_each_property_offset(prop, fdt, node) {
+			const void *val, *ref_val;
+			const char *name;
+			int len, ref_len;
+
+			val = fdt_getprop_by_offset(fdt, prop, &name, &len);
+			ref_val = fdt_getprop(ref, ref_node, name, &ref_len);
+			ut_assertnonnull(ref_val);
+			ut_asserteq(ref_len, len);
+			ut_asserteq_mem(ref_val, val, len);
+			count++;
+		}
+		ref_count = 0;
+		fdt_for_each_property_offset(prop, ref, ref_node)
+			ref_count++;
+		ut_asserteq(ref_count, count);
+	}
+
+	return 0;
+}
+
+static void *copy_fdt(void)
+{
+	int size = fdt_totalsize(gd->fdt_blob) + FIXUP_SPACE;
+	void *fdt;
+
+	fdt = malloc(size);
+	if (fdt && fdt_open_into(gd->fdt_blob, fdt, size)) {
+		free(fdt);
+		return NULL;
+	}
+
+	return fdt;
+}
+
+/* An editing session must give the same result as fdt_setprop() */
+static int test_fdt_edit(struct unit_test_state *uts)
+{
+	void *fdt, *ref;
+
+	fdt = copy_fdt();
+	ut_assertnonnull(fdt);
+	ref = copy_fdt();
+	ut_assertnonnull(ref);
+
+	ut_assertok(fixup_by_setprop(ref));
+	ut_assertok(fixup_by_edit(fdt, false));
+	ut_assertok(fdt_check_header(fdt));
+	ut_assertok(check_same(uts, fdt, ref));
+
+	/* Running the fixups again replaces the properties in place */
+	ut_assertok(fixup_by_edit(fdt, false));
+	ut_assertok(check_same(uts, fdt, ref));
+
+	free(ref);
+	free(fdt);
+
+	return 0;
+}
+COMMON_TEST(test_fdt_edit, 0);
+
+/*
+ * Making the changes one at a time must give the same result, even though
+ * each one moves the nodes after it
+ */
+static int test_fdt_edit_in_place(struct unit_test_state *uts)
+{
+	void *fdt, *ref;
+
+	fdt = copy_fdt();
+	ut_assertnonnull(fdt);
+	ref = copy_fdt();
+	ut_assertnonnull(ref);
+
+	ut_assertok(fixup_by_setprop(ref));
+	ut_assertok(fixup_by_edit(fdt, true));
+	ut_assertok(fdt_check_header(fdt));
+	ut_assertok(check_same(uts, fdt, ref));
+
+	ut_assertok(fixup_by_edit(fdt, true));
+	ut_assertok(check_same(uts, fdt, ref));
+
+	free(ref);
+	free(fdt);
+
+	return 0;
+}
+COMMON_TEST(test_fdt_edit_in_place, 0);
+
+/* Remembered node offsets must follow the changes */
+static int test_fdt_edit_nodes(struct unit_test_state *uts)
+{
+	struct fdt_edit edit;
+	const char *path;
+	int node, i;
+	void *fdt;
+
+	fdt = copy_fdt();
+	ut_assertnonnull(fdt);
+
+	ut_assertok(fdt_edit_open(&edit, fdt, 0));
+	for (i = 0; i < ARRAY_SIZE(fixups); i++) {
+		node = fdt_edit_node(&edit, fixups[i].path);
+		ut_assert(node >= 0);
+		ut_assertok(fdt_edit_setprop_string(&edit, node,
+						    fixups[i].name, "value"));
+	}
+	ut_assertok(fdt_edit_apply(&edit));
+
+	for (i = 0; i < edit.num_nodes; i++) {
+		path = edit.nodes[i].path;
+		ut_asserteq(fdt_path_offset(fdt, path),
+			    fdt_edit_node(&edit, path));
+	}
+
+	/*
+	 * A missing node is reported when the session is closed, but the other
+	 * changes are still made
+	 */
+	node = fdt_edit_node(&edit, "/no-such-node");
+	ut_asserteq(-FDT_ERR_NOTFOUND, node);
+	ut_asserteq(-FDT_ERR_NOTFOUND,
+		    fdt_edit_setprop_u32(&edit, node, "prop", 1));
+	ut_assertok(fdt_edit_setprop_string(&edit, fdt_edit_node(&edit, "/"),
+					    "model", "other"));
+	ut_asserteq(-FDT_ERR_NOTFOUND, fdt_edit_close(&edit));
+	ut_asserteq_str("other", fdt_getprop(fdt, 0, "model", NULL));
+	free(fdt);
+
+	return 0;
+}
+COMMON_TEST(test_fdt_edit_nodes, 0);
+
+/* Show the time taken by each method, for comparison on real hardware */
+static int test_fdt_edit_speed(struct unit_test_state *uts)
+{
+	ulong start, setprop_us, edit_us;
+	void *fdt, *ref;
+	int i, size;
+
+	ref = copy_fdt();
+	ut_assertnonnull(ref);
+	fdt = copy_fdt();
+	ut_assertnonnull(fdt);
+	size = fdt_totalsize(ref);
+
+	start = timer_get_us();
+	for (i = 0; i < SPEED_LOOPS; i++) {
+		memcpy(fdt, ref, size);
+		ut_assertok(fixup_by_setprop(fdt));
+	}
+	setprop_us = timer_get_us() - start;
+
+	start = timer_get_us();
+	for (i = 0; i < SPEED_LOOPS; i++) {
+		memcpy(fdt, ref, size);
+		ut_assertok(fixup_by_edit(fdt, false));
+	}
+	edit_us = timer_get_us() - start;
+
+	printf("FDT size %d bytes, %d properties\n", size,
+	       (int)ARRAY_SIZE(fixups));
+	printf("fdt_setprop: %lu us per fixup\n", setprop_us / SPEED_LOOPS);
+	printf("fdt_edit:    %lu us per fixup\n", edit_us / SPEED_LOOPS);
+	free(fdt);
+	free(ref);
+
+	return 0;
+}
+COMMON_TEST(test_fdt_edit_speed, 0);
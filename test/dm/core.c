@@ -81,6 +81,16 @@ static struct driver_info driver_info_act_dma_vital_clk = {
 	.name = "test_act_dma_vital_clk_drv",
 };
 
+static struct driver_info driver_info_async = {
+	.name = "test_async_drv",
+	.plat = &test_pdata_manual,
+};
+
+static struct driver_info driver_info_async_fail = {
+	.name = "test_async_fail_drv",
+	.plat = &test_pdata_manual,
+};
+
 void dm_leak_check_start(struct unit_test_state *uts)
 {
 	uts->start = mallinfo();
@@ -1011,6 +1021,69 @@ static int dm_test_remove_vital(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_remove_vital, 0);
 
+/* Test that a device can finish probing later */
+static int dm_test_probe_async(struct unit_test_state *uts)
+{
+	struct dm_test_priv *priv;
+	struct udevice *dev;
+
+	ut_assertok(device_bind_by_name(uts->root, false, &driver_info_async,
+					&dev));
+	ut_assertok(device_probe_async(dev));
+	ut_asserteq(true, device_active(dev));
+	priv = dev_get_priv(dev);
+	if (CONFIG_IS_ENABLED(DM_ASYNC_PROBE)) {
+		ut_assert(dev_get_flags(dev) & DM_FLAG_PROBE_PENDING);
+		ut_asserteq(0, priv->ping_total);
+	} else {
+		ut_asserteq(3, priv->ping_total);
+	}
+
+	/* a normal probe waits for the device to be ready */
+	ut_assertok(device_probe(dev));
+	ut_assert(!(dev_get_flags(dev) & DM_FLAG_PROBE_PENDING));
+	ut_asserteq(3, priv->ping_total);
+
+	/* the second probe does nothing */
+	ut_assertok(device_probe(dev));
+	ut_asserteq(3, priv->ping_total);
+
+	/* removing a pending device cancels the probe without waiting */
+	ut_assertok(device_remove(dev, DM_REMOVE_NORMAL));
+	ut_assertok(device_probe_async(dev));
+	memset(dm_testdrv_op_count, '\0', sizeof(dm_testdrv_op_count));
+	ut_assertok(device_remove(dev, DM_REMOVE_NORMAL));
+	ut_asserteq(false, device_active(dev));
+	ut_assert(!(dev_get_flags(dev) & DM_FLAG_PROBE_PENDING));
+	if (CONFIG_IS_ENABLED(DM_ASYNC_PROBE)) {
+		ut_asserteq(0, dm_testdrv_op_count[DM_TEST_OP_POST_PROBE]);
+		ut_asserteq(0, dm_testdrv_op_count[DM_TEST_OP_PRE_REMOVE]);
+	}
+	ut_assertok(device_unbind(dev));
+
+	return 0;
+}
+DM_TEST(dm_test_probe_async, 0);
+
+/* Test that a device which never gets ready is not seen by its uclass */
+static int dm_test_probe_async_fail(struct unit_test_state *uts)
+{
+	struct udevice *dev;
+
+	ut_assertok(device_bind_by_name(uts->root, false,
+					&driver_info_async_fail, &dev));
+	memset(dm_testdrv_op_count, '\0', sizeof(dm_testdrv_op_count));
+	ut_asserteq(-EIO, device_probe(dev));
+	ut_asserteq(false, device_active(dev));
+	ut_asserteq(1, dm_testdrv_op_count[DM_TEST_OP_REMOVE]);
+	ut_asserteq(0, dm_testdrv_op_count[DM_TEST_OP_POST_PROBE]);
+	ut_asserteq(0, dm_testdrv_op_count[DM_TEST_OP_PRE_REMOVE]);
+	ut_assertok(device_unbind(dev));
+
+	return 0;
+}
+DM_TEST(dm_test_probe_async_fail, 0);
+
 static int dm_test_uclass_before_ready(struct unit_test_state *uts)
 {
 	struct uclass *uc;
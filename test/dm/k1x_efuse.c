@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Test for the efuse shadow kept by the Spacemit K1 efuse driver
+ */
+
+#include <common.h>
+#include <bloblist.h>
+#include <dm.h>
+#include <mapmem.h>
+#include <misc.h>
+#include <asm/io.h>
+#include <asm/state.h>
+#include <asm/test.h>
+#include <dm/device-internal.h>
+#include <dm/lists.h>
+#include <dm/test.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+#define EFUSE_BASE		0x7f00000
+#define EFUSE_BANK9_OFFSET	0x220
+#define EFUSE_STATUS		0x184
+#define FUSE_READY		BIT(1)
+#define FUSE_BANK_BYTES		32
+#define SHADOW_SIZE		(12 * FUSE_BANK_BYTES)
+
+static int get_efuse(struct unit_test_state *uts, struct udevice **devp)
+{
+	return uclass_get_device_by_driver(UCLASS_MISC,
+					   DM_DRIVER_GET(spacemit_k1x_efuse),
+					   devp);
+}
+
+/* Test that the efuse banks are read once and then handed on in a bloblist */
+static int dm_test_k1x_efuse_shadow(struct unit_test_state *uts)
+{
+	struct udevice *dev, *parent;
+	u8 buf[FUSE_BANK_BYTES];
+	u8 *regs, *shadow;
+	ofnode node;
+	int i;
+
+	state_set_skip_delays(true);
+	sandbox_set_enable_memio(true);
+	ut_assertok(bloblist_new(CONFIG_BLOBLIST_ADDR, CONFIG_BLOBLIST_SIZE, 0));
+
+	/* fake efuse: ready, with a pattern in bank 9 */
+	regs = map_sysmem(EFUSE_BASE, 0x400);
+	memset(regs, '\0', 0x400);
+	writel(FUSE_READY, regs + EFUSE_STATUS);
+	for (i = 0; i < FUSE_BANK_BYTES; i++)
+		regs[EFUSE_BANK9_OFFSET + i] = i + 1;
+
+	/* the first read comes from the hardware, and fills in the shadow */
+	ut_assertok(get_efuse(uts, &dev));
+	ut_assertok(misc_read(dev, 9 * FUSE_BANK_BYTES, buf, sizeof(buf)));
+	ut_asserteq_mem(regs + EFUSE_BANK9_OFFSET, buf, sizeof(buf));
+	shadow = bloblist_find(BLOBLISTT_SPACEMIT_EFUSE, SHADOW_SIZE);
+	ut_assertnonnull(shadow);
+	ut_asserteq_mem(buf, shadow + 9 * FUSE_BANK_BYTES, sizeof(buf));
+
+	/* change the fuses: the device keeps serving its copy */
+	memset(regs + EFUSE_BANK9_OFFSET, 0xaa, FUSE_BANK_BYTES);
+	ut_assertok(misc_read(dev, 9 * FUSE_BANK_BYTES + 4, buf, 4));
+	ut_asserteq(5, buf[0]);
+
+	/* a new device, as in the next boot phase, uses the shadow */
+	node = dev_ofnode(dev);
+	parent = dev_get_parent(dev);
+	ut_assertok(device_remove(dev, DM_REMOVE_NORMAL));
+	ut_assertok(device_unbind(dev));
+	ut_assertok(lists_bind_fdt(parent, node, &dev, NULL, false));
+	ut_assertok(misc_read(dev, 9 * FUSE_BANK_BYTES, buf, sizeof(buf)));
+	ut_asserteq(1, buf[0]);
+	ut_asserteq(FUSE_BANK_BYTES, buf[FUSE_BANK_BYTES - 1]);
+
+	/* without a shadow, the hardware is read again */
+	ut_assertok(bloblist_new(CONFIG_BLOBLIST_ADDR, CONFIG_BLOBLIST_SIZE, 0));
+	ut_assertok(device_remove(dev, DM_REMOVE_NORMAL));
+	ut_assertok(device_unbind(dev));
+	ut_assertok(lists_bind_fdt(parent, node, &dev, NULL, false));
+	ut_assertok(misc_read(dev, 9 * FUSE_BANK_BYTES, buf, sizeof(buf)));
+	ut_asserteq(0xaa, buf[0]);
+	shadow = bloblist_find(BLOBLISTT_SPACEMIT_EFUSE, SHADOW_SIZE);
+	ut_assertnonnull(shadow);
+	ut_asserteq(0xaa, shadow[9 * FUSE_BANK_BYTES]);
+
+	unmap_sysmem(regs);
+	sandbox_set_enable_memio(false);
+	state_set_skip_delays(false);
+
+	return 0;
+}
+DM_TEST(dm_test_k1x_efuse_shadow, UT_TESTF_SCAN_FDT);
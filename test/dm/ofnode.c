@@ -6,6 +6,7 @@
 #include <of_live.h>
 #include <dm/device-internal.h>
 #include <dm/lists.h>
+#include <dm/of_access.h>
 #include <dm/of_extra.h>
 #include <dm/root.h>
 #include <dm/test.h>
@@ -40,6 +41,76 @@ static int dm_test_ofnode_get_by_phandle(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_ofnode_get_by_phandle, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
 
+#if CONFIG_IS_ENABLED(OF_LIVE_INDEX)
+/* Check that the live-tree indexes agree with walking the tree */
+static int dm_test_ofnode_live_index(struct unit_test_state *uts)
+{
+	const char compat[] = "denx,u-boot-fdt-test";
+	struct device_node *np, *found;
+	int walked = 0, indexed = 0;
+
+	for_each_of_allnodes(np) {
+		if (np->phandle)
+			ut_asserteq_ptr(np, of_find_node_by_phandle(np->phandle));
+		if (of_device_is_compatible(np, compat, NULL, NULL))
+			walked++;
+	}
+	ut_assert(walked > 1);
+
+	for (found = of_find_compatible_node(NULL, NULL, compat); found;
+	     found = of_find_compatible_node(found, NULL, compat)) {
+		ut_assert(of_device_is_compatible(found, compat, NULL, NULL));
+		indexed++;
+	}
+	ut_asserteq(walked, indexed);
+	ut_assertnull(of_find_compatible_node(NULL, NULL, "no,such-device"));
+
+	return 0;
+}
+DM_TEST(dm_test_ofnode_live_index, UT_TESTF_LIVE_TREE);
+
+/* Check that moving a phandle to another node is seen through the index */
+static int dm_test_ofnode_live_index_write(struct unit_test_state *uts)
+{
+	static const fdt32_t zero = 0;
+	struct device_node *np, *other;
+	const void *old, *old_other;
+	phandle handle;
+	int len, other_len;
+
+	for_each_of_allnodes(np) {
+		if (np->phandle && of_get_property(np, "phandle", NULL))
+			break;
+	}
+	ut_assertnonnull(np);
+	handle = np->phandle;
+	ut_asserteq_ptr(np, of_find_node_by_phandle(handle));
+
+	other = of_find_node_by_path("/a-test");
+	ut_assertnonnull(other);
+	ut_asserteq(0, other->phandle);
+
+	old = of_get_property(np, "phandle", &len);
+	old_other = of_get_property(other, "phandle", &other_len);
+	ut_assertok(of_write_prop(np, "phandle", sizeof(zero), &zero));
+	ut_assertok(of_write_prop(other, "phandle", len, old));
+	ut_asserteq_ptr(other, of_find_node_by_phandle(handle));
+
+	/* put things back */
+	if (!old_other) {
+		old_other = &zero;
+		other_len = sizeof(zero);
+	}
+	ut_assertok(of_write_prop(other, "phandle", other_len, old_other));
+	ut_assertok(of_write_prop(np, "phandle", len, old));
+	ut_asserteq_ptr(np, of_find_node_by_phandle(handle));
+	ut_assertok(of_index_scan());
+
+	return 0;
+}
+DM_TEST(dm_test_ofnode_live_index_write, UT_TESTF_LIVE_TREE);
+#endif
+
 static int dm_test_ofnode_by_prop_value(struct unit_test_state *uts)
 {
 	const char propname[] = "compatible";
@@ -198,3 +198,40 @@ U_BOOT_DRIVER(test_act_dma_vital_clk_drv) = {
 	.unbind	= test_manual_unbind,
 	.flags	= DM_FLAG_VITAL | DM_FLAG_ACTIVE_DMA,
 };
+
+static int test_async_probe_ready(struct udevice *dev)
+{
+	struct dm_test_priv *priv = dev_get_priv(dev);
+
+	/* pretend that the hardware takes a few polls to become ready */
+	if (++priv->ping_total < 3)
+		return -EAGAIN;
+
+	return 0;
+}
+
+U_BOOT_DRIVER(test_async_drv) = {
+	.name	= "test_async_drv",
+	.id	= UCLASS_TEST,
+	.ops	= &test_manual_ops,
+	.bind	= test_manual_bind,
+	.probe_ready	= test_async_probe_ready,
+	.unbind	= test_manual_unbind,
+	.priv_auto	= sizeof(struct dm_test_priv),
+};
+
+static int test_async_probe_fail(struct udevice *dev)
+{
+	return -EIO;
+}
+
+U_BOOT_DRIVER(test_async_fail_drv) = {
+	.name	= "test_async_fail_drv",
+	.id	= UCLASS_TEST,
+	.ops	= &test_manual_ops,
+	.bind	= test_manual_bind,
+	.remove	= test_manual_remove,
+	.probe_ready	= test_async_probe_fail,
+	.unbind	= test_manual_unbind,
+	.priv_auto	= sizeof(struct dm_test_priv),
+};
@@ -14,6 +14,7 @@
 #include <os.h>
 #include <video.h>
 #include <video_console.h>
+#include <video_img.h>
 #include <asm/test.h>
 #include <dm/test.h>
 #include <dm/uclass-internal.h>
@@ -83,6 +84,9 @@ static int compress_frame_buffer(struct unit_test_state *uts,
 
 	/* Check here that the copy frame buffer is working correctly */
 	if (IS_ENABLED(CONFIG_VIDEO_COPY)) {
+		/* With damage tracking the copy is deferred until a sync */
+		if (IS_ENABLED(CONFIG_VIDEO_DAMAGE))
+			ut_assertok(video_sync(dev, false));
 		ut_assertf(!memcmp(uc_priv->fb, uc_priv->copy_fb,
 				   uc_priv->fb_size),
 				   "Copy framebuffer does not match fb");
@@ -271,6 +275,51 @@ static int check_vidconsole_output(struct unit_test_state *uts, int rot,
 	return 0;
 }
 
+/* Test that drawing only marks the region it touched as damaged */
+static int dm_test_video_damage(struct unit_test_state *uts)
+{
+	struct video_priv *priv;
+	struct udevice *dev, *con;
+
+	if (!IS_ENABLED(CONFIG_VIDEO_DAMAGE))
+		return -EAGAIN;
+
+	ut_assertok(select_vidconsole(uts, "vidconsole0"));
+	ut_assertok(video_get_nologo(uts, &dev));
+	ut_assertok(uclass_get_device(UCLASS_VIDEO_CONSOLE, 0, &con));
+	priv = dev_get_uclass_priv(dev);
+
+	/* A sync consumes the damage left over from probing */
+	ut_assertok(video_sync(dev, true));
+	ut_assert(priv->damage.xend <= priv->damage.xstart);
+
+	vidconsole_putc_xy(con, VID_TO_POS(8), 16, 'a');
+	ut_asserteq(8, priv->damage.xstart);
+	ut_asserteq(16, priv->damage.ystart);
+	ut_asserteq(16, priv->damage.xend);
+	ut_asserteq(32, priv->damage.yend);
+
+	/* Further updates are merged into one rectangle */
+	video_damage(dev, 100, 200, 10, 10);
+	ut_asserteq(8, priv->damage.xstart);
+	ut_asserteq(16, priv->damage.ystart);
+	ut_asserteq(110, priv->damage.xend);
+	ut_asserteq(210, priv->damage.yend);
+
+	/* ...and clipped to the display */
+	video_damage(dev, 1360, 760, 100, 100);
+	ut_asserteq(1366, priv->damage.xend);
+	ut_asserteq(768, priv->damage.yend);
+
+	ut_assertok(video_sync(dev, true));
+	ut_assert(priv->damage.xend <= priv->damage.xstart);
+	if (IS_ENABLED(CONFIG_VIDEO_COPY))
+		ut_asserteq(0, memcmp(priv->fb, priv->copy_fb, priv->fb_size));
+
+	return 0;
+}
+DM_TEST(dm_test_video_damage, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
 /* Test text output through the console uclass */
 static int dm_test_video_context(struct unit_test_state *uts)
 {
@@ -506,6 +555,142 @@ static int dm_test_video_comp_bmp8(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_video_comp_bmp8, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
 
+#ifdef CONFIG_VIDEO_IMG
+/* Pixel at x, y of the 16bpp test images below */
+static u16 img_pixel(int x, int y)
+{
+	return (x & 15) << 5 | (y & 31);
+}
+
+/* LZ4 frame of a 1366x2 test image, as wide as the display */
+static const u8 img_full_lz4[] = {
+	0x04, 0x22, 0x4d, 0x18, 0x60, 0x40, 0x82, 0x64, 0x00, 0x00, 0x00, 0xff,
+	0x11, 0x00, 0x00, 0x20, 0x00, 0x40, 0x00, 0x60, 0x00, 0x80, 0x00, 0xa0,
+	0x00, 0xc0, 0x00, 0xe0, 0x00, 0x00, 0x01, 0x20, 0x01, 0x40, 0x01, 0x60,
+	0x01, 0x80, 0x01, 0xa0, 0x01, 0xc0, 0x01, 0xe0, 0x01, 0x20, 0x00, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x83, 0xff, 0x11,
+	0x01, 0x00, 0x21, 0x00, 0x41, 0x00, 0x61, 0x00, 0x81, 0x00, 0xa1, 0x00,
+	0xc1, 0x00, 0xe1, 0x00, 0x01, 0x01, 0x21, 0x01, 0x41, 0x01, 0x61, 0x01,
+	0x81, 0x01, 0xa1, 0x01, 0xc1, 0x01, 0xe1, 0x01, 0x20, 0x00, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7e, 0x50, 0x00, 0x81,
+	0x00, 0xa1, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+/* LZ4 frame of a 64x4 test image */
+static const u8 img_part_lz4[] = {
+	0x04, 0x22, 0x4d, 0x18, 0x60, 0x40, 0x82, 0x97, 0x00, 0x00, 0x00, 0xff,
+	0x11, 0x00, 0x00, 0x20, 0x00, 0x40, 0x00, 0x60, 0x00, 0x80, 0x00, 0xa0,
+	0x00, 0xc0, 0x00, 0xe0, 0x00, 0x00, 0x01, 0x20, 0x01, 0x40, 0x01, 0x60,
+	0x01, 0x80, 0x01, 0xa0, 0x01, 0xc0, 0x01, 0xe0, 0x01, 0x20, 0x00, 0x4d,
+	0xff, 0x10, 0x01, 0x00, 0x21, 0x00, 0x41, 0x00, 0x61, 0x00, 0x81, 0x00,
+	0xa1, 0x00, 0xc1, 0x00, 0xe1, 0x00, 0x01, 0x01, 0x21, 0x01, 0x41, 0x01,
+	0x61, 0x01, 0x81, 0x01, 0xa1, 0x01, 0xc1, 0x01, 0xe1, 0x20, 0x00, 0x4e,
+	0xff, 0x10, 0x02, 0x00, 0x22, 0x00, 0x42, 0x00, 0x62, 0x00, 0x82, 0x00,
+	0xa2, 0x00, 0xc2, 0x00, 0xe2, 0x00, 0x02, 0x01, 0x22, 0x01, 0x42, 0x01,
+	0x62, 0x01, 0x82, 0x01, 0xa2, 0x01, 0xc2, 0x01, 0xe2, 0x20, 0x00, 0x4e,
+	0xff, 0x10, 0x03, 0x00, 0x23, 0x00, 0x43, 0x00, 0x63, 0x00, 0x83, 0x00,
+	0xa3, 0x00, 0xc3, 0x00, 0xe3, 0x00, 0x03, 0x01, 0x23, 0x01, 0x43, 0x01,
+	0x63, 0x01, 0x83, 0x01, 0xa3, 0x01, 0xc3, 0x01, 0xe3, 0x20, 0x00, 0x49,
+	0x50, 0x01, 0xc3, 0x01, 0xe3, 0x01, 0x00, 0x00, 0x00, 0x00,
+};
+
+/**
+ * make_img() - Write a pre-converted 16bpp image to memory
+ *
+ * @addr:	Address to write the image to
+ * @width:	Image width in pixels
+ * @height:	Image height in pixels
+ * @lz4:	LZ4 frame of the pixel data, or NULL to write it uncompressed
+ * @lz4_size:	Size of @lz4
+ */
+static void make_img(ulong addr, int width, int height, const u8 *lz4,
+		     int lz4_size)
+{
+	struct video_img_header *hdr = map_sysmem(addr, 0);
+	u16 *data = (u16 *)(hdr + 1);
+	int x, y;
+
+	memcpy(hdr->magic, VIDEO_IMG_MAGIC, VIDEO_IMG_MAGIC_LEN);
+	hdr->hdr_size = cpu_to_le32(sizeof(*hdr));
+	hdr->width = cpu_to_le16(width);
+	hdr->height = cpu_to_le16(height);
+	hdr->bpix = VIDEO_BPP16;
+	hdr->format = VIDEO_UNKNOWN;
+	hdr->reserved = 0;
+	if (lz4) {
+		hdr->comp = VIDEO_IMG_COMP_LZ4;
+		hdr->data_size = cpu_to_le32(lz4_size);
+		memcpy(data, lz4, lz4_size);
+	} else {
+		hdr->comp = VIDEO_IMG_COMP_NONE;
+		hdr->data_size = cpu_to_le32(width * height * 2);
+		for (y = 0; y < height; y++) {
+			for (x = 0; x < width; x++)
+				data[y * width + x] = cpu_to_le16(img_pixel(x, y));
+		}
+	}
+}
+
+/* Check that the image is in the frame buffer at xpos, ypos */
+static int check_img(struct unit_test_state *uts, struct udevice *dev,
+		     int xpos, int ypos, int width, int height)
+{
+	struct video_priv *priv = dev_get_uclass_priv(dev);
+	u16 *line;
+	int x, y;
+
+	for (y = 0; y < height; y++) {
+		line = priv->fb + (ypos + y) * priv->line_length;
+		for (x = 0; x < width; x++)
+			ut_asserteq(img_pixel(x, y), line[xpos + x]);
+	}
+
+	return 0;
+}
+
+/* Test drawing an uncompressed pre-converted image */
+static int dm_test_video_img(struct unit_test_state *uts)
+{
+	struct udevice *dev;
+	ulong addr = 0x10000;
+
+	ut_assertok(video_get_nologo(uts, &dev));
+	make_img(addr, 64, 4, NULL, 0);
+	ut_assert(video_img_valid(addr));
+
+	ut_assertok(video_img_display(dev, addr, 10, 20, false));
+	ut_assertok(check_img(uts, dev, 10, 20, 64, 4));
+
+	return 0;
+}
+DM_TEST(dm_test_video_img, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
+/* Test drawing LZ4 images, straight to the frame buffer and through a buffer */
+static int dm_test_video_img_lz4(struct unit_test_state *uts)
+{
+	struct udevice *dev;
+	ulong addr = 0x10000;
+
+	ut_assertok(video_get_nologo(uts, &dev));
+
+	/* as wide as the display, so decompressed in the frame buffer */
+	make_img(addr, 1366, 2, img_full_lz4, sizeof(img_full_lz4));
+	ut_assertok(video_img_display(dev, addr, 0, 100, false));
+	ut_assertok(check_img(uts, dev, 0, 100, 1366, 2));
+
+	/* narrower, so decompressed to a buffer and copied */
+	make_img(addr, 64, 4, img_part_lz4, sizeof(img_part_lz4));
+	ut_assertok(video_img_display(dev, addr, 10, 20, false));
+	ut_assertok(check_img(uts, dev, 10, 20, 64, 4));
+
+	/* the first image is still there */
+	ut_assertok(check_img(uts, dev, 0, 100, 1366, 2));
+
+	return 0;
+}
+DM_TEST(dm_test_video_img_lz4, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+#endif
+
 /* Test TrueType console */
 static int dm_test_video_truetype(struct unit_test_state *uts)
 {
@@ -562,3 +747,80 @@ static int dm_test_video_truetype_bs(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_video_truetype_bs, UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
+/**
+ * check_tt_glyph_cache() - Draw characters using the TrueType glyph cache
+ *
+ * This draws characters at various sub-pixel positions, in yellow on blue so
+ * that their edges are blended with the background, then checks the result.
+ * The second row uses the glyphs cached for the first.
+ *
+ * @uts:	Test state
+ * @l2bpp:	Colour depth to use
+ * @x2r10:	true to use 30-bit colour (with @l2bpp set to VIDEO_BPP32)
+ * @expect:	Expected compressed size of the frame buffer
+ * Return: 0 if OK, -ve on error
+ */
+static int check_tt_glyph_cache(struct unit_test_state *uts,
+				enum video_log2_bpp l2bpp, bool x2r10,
+				int expect)
+{
+	static const char chars[] = "Agj%@W";
+	struct sandbox_sdl_plat *plat;
+	struct video_priv *priv;
+	struct udevice *dev, *con;
+	uint x = 0;
+	int i, ret;
+
+	ut_assertok(uclass_find_first_device(UCLASS_VIDEO, &dev));
+	ut_assertnonnull(dev);
+	plat = dev_get_plat(dev);
+	plat->font_size = 40;
+	ut_assertok(sandbox_sdl_set_bpp(dev, l2bpp));
+	ut_assertok(uclass_get_device(UCLASS_VIDEO_CONSOLE, 0, &con));
+	console_truetype_set_glyph_cache(con, true);
+
+	priv = dev_get_uclass_priv(dev);
+	if (x2r10)
+		priv->format = VIDEO_X2R10G10B10;
+	priv->colour_fg = vid_console_color(priv, VID_YELLOW);
+	priv->colour_bg = vid_console_color(priv, VID_BLUE);
+	ut_assertok(video_clear(dev));
+
+	/* A gap of 0.3 pixels moves each character to a new sub-pixel place */
+	for (i = 0; i < 24; i++) {
+		if (!(i % 12))
+			x = VID_TO_POS(10);
+		ret = vidconsole_putc_xy(con, x, 100 + i / 12 * 50,
+					 chars[i % 6]);
+		ut_assert(ret > 0);
+		x += ret + VID_FRAC_DIV * 3 / 10;
+	}
+	ut_asserteq(expect, compress_frame_buffer(uts, dev));
+
+	return 0;
+}
+
+/* Test the TrueType glyph cache at 16bpp */
+static int dm_test_video_truetype_cache16(struct unit_test_state *uts)
+{
+	return check_tt_glyph_cache(uts, VIDEO_BPP16, false, 4582);
+}
+DM_TEST(dm_test_video_truetype_cache16,
+	UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
+/* Test the TrueType glyph cache at 32bpp */
+static int dm_test_video_truetype_cache32(struct unit_test_state *uts)
+{
+	return check_tt_glyph_cache(uts, VIDEO_BPP32, false, 9560);
+}
+DM_TEST(dm_test_video_truetype_cache32,
+	UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
+
+/* Test the TrueType glyph cache with 30-bit colour */
+static int dm_test_video_truetype_cache30(struct unit_test_state *uts)
+{
+	return check_tt_glyph_cache(uts, VIDEO_BPP32, true, 10628);
+}
+DM_TEST(dm_test_video_truetype_cache30,
+	UT_TESTF_SCAN_PDATA | UT_TESTF_SCAN_FDT);
@@ -124,3 +124,48 @@ static int env_test_htab_deletes(struct unit_test_state *uts)
 }
 
 ENV_TEST(env_test_htab_deletes, 0);
+
+/*
+ * Import a buffer with more entries than the size-based heuristic allows for
+ * and a duplicate, and check that everything ends up in the table
+ */
+static int env_test_htab_import(struct unit_test_state *uts)
+{
+	struct hsearch_data htab;
+	struct env_entry item;
+	struct env_entry *ritem;
+	char buf[SIZE * 8 * 10];
+	char key[20];
+	char *p = buf;
+	int i;
+
+	for (i = 0; i < SIZE * 8; i++)
+		p += sprintf(p, "%d=%d\n", i, i);
+	p += sprintf(p, "0=dup\n");
+
+	memset(&htab, 0, sizeof(htab));
+	ut_asserteq(1, himport_r(&htab, buf, p - buf, '\n', 0, 0, 0, NULL));
+	ut_asserteq(SIZE * 8, htab.filled);
+	ut_assert(htab.size >= 2 * htab.filled);
+
+	for (i = 1; i < SIZE * 8; i++) {
+		sprintf(key, "%d", i);
+		item.callback = NULL;
+		item.flags = 0;
+		item.data = NULL;
+		item.key = key;
+		hsearch_r(item, ENV_FIND, &ritem, &htab, 0);
+		ut_assert(ritem);
+		ut_asserteq_str(key, ritem->data);
+	}
+
+	item.key = "0";
+	hsearch_r(item, ENV_FIND, &ritem, &htab, 0);
+	ut_assert(ritem);
+	ut_asserteq_str("dup", ritem->data);
+
+	hdestroy_r(&htab);
+	return 0;
+}
+
+ENV_TEST(env_test_htab_import, 0);
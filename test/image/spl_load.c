@@ -9,6 +9,8 @@
 #include <mapmem.h>
 #include <os.h>
 #include <spl.h>
+#include <asm/cache.h>
+#include <linux/libfdt.h>
 #include <test/ut.h>
 
 /* Declare a new SPL test */
@@ -89,3 +91,123 @@ static int spl_test_load(struct unit_test_state *uts)
 	return 0;
 }
 SPL_TEST(spl_test_load, 0);
+
+/* Size of the in-memory FIT used by spl_test_load_direct */
+#define DIRECT_FIT_SIZE		0x2000
+#define DIRECT_DATA_SIZE	1500
+#define DIRECT_LOAD_ADDR	0x200000
+
+/* Context for reading from an in-memory FIT */
+struct mem_ctx {
+	const u8 *fit;
+	int reads;
+};
+
+static ulong read_mem_fit(struct spl_load_info *load, ulong sector,
+			  ulong count, void *buf)
+{
+	struct mem_ctx *mem_ctx = load->priv;
+
+	memcpy(buf, mem_ctx->fit + sector * load->bl_len,
+	       count * load->bl_len);
+	mem_ctx->reads++;
+
+	return count;
+}
+
+/* Create a FIT with one firmware image whose data is external */
+static int make_direct_fit(struct unit_test_state *uts, u8 *fit,
+			   int data_offset)
+{
+	int i;
+
+	ut_assertok(fdt_create(fit, DIRECT_FIT_SIZE));
+	ut_assertok(fdt_finish_reservemap(fit));
+	ut_assertok(fdt_begin_node(fit, ""));
+	ut_assertok(fdt_begin_node(fit, "images"));
+	ut_assertok(fdt_begin_node(fit, "firmware"));
+	ut_assertok(fdt_property_string(fit, "type", "firmware"));
+	ut_assertok(fdt_property_string(fit, "os", "arm-trusted-firmware"));
+	ut_assertok(fdt_property_string(fit, "compression", "none"));
+	ut_assertok(fdt_property_u32(fit, "load", DIRECT_LOAD_ADDR));
+	ut_assertok(fdt_property_u32(fit, "data-offset", data_offset));
+	ut_assertok(fdt_property_u32(fit, "data-size", DIRECT_DATA_SIZE));
+	ut_assertok(fdt_end_node(fit));
+	ut_assertok(fdt_end_node(fit));
+	ut_assertok(fdt_begin_node(fit, "configurations"));
+	ut_assertok(fdt_property_string(fit, "default", "conf"));
+	ut_assertok(fdt_begin_node(fit, "conf"));
+	ut_assertok(fdt_property_string(fit, "firmware", "firmware"));
+	ut_assertok(fdt_end_node(fit));
+	ut_assertok(fdt_end_node(fit));
+	ut_assertok(fdt_end_node(fit));
+	ut_assertok(fdt_finish(fit));
+
+	for (i = 0; i < DIRECT_DATA_SIZE; i++)
+		fit[ALIGN(fdt_totalsize(fit), 4) + data_offset + i] = i * 7;
+
+	return 0;
+}
+
+/*
+ * External data should be read straight to its load address, without
+ * touching the memory around it, whether or not it starts and ends on a
+ * block boundary
+ */
+static int spl_test_load_direct(struct unit_test_state *uts)
+{
+	static const int data_offsets[] = { 100, 0 };
+	int i, j, start, head, rest, reads;
+	struct spl_image_info image;
+	struct spl_load_info load;
+	struct mem_ctx mem_ctx;
+	ulong load_addr;
+	u8 *fit, *dst, *src;
+
+	fit = calloc(1, DIRECT_FIT_SIZE);
+	ut_assertnonnull(fit);
+
+	for (i = 0; i < ARRAY_SIZE(data_offsets); i++) {
+		ut_assertok(make_direct_fit(uts, fit, data_offsets[i]));
+		start = ALIGN(fdt_totalsize(fit), 4) + data_offsets[i];
+
+		/* Make sure the device can DMA straight to the whole blocks */
+		head = (512 - start % 512) % 512;
+		load_addr = DIRECT_LOAD_ADDR + ALIGN(head, ARCH_DMA_MINALIGN) -
+			head;
+		ut_assertok(fdt_setprop_inplace_u32(fit,
+				fdt_path_offset(fit, "/images/firmware"),
+				"load", load_addr));
+
+		dst = map_sysmem(load_addr, DIRECT_DATA_SIZE);
+		memset(dst - 512, 0xa5, DIRECT_DATA_SIZE + 1024);
+
+		memset(&load, '\0', sizeof(load));
+		load.bl_len = 512;
+		load.read = read_mem_fit;
+		load.priv = &mem_ctx;
+		mem_ctx.fit = fit;
+		mem_ctx.reads = 0;
+		memset(&image, '\0', sizeof(image));
+		ut_assertok(spl_load_simple_fit(&image, &load, 0, fit));
+		ut_asserteq(load_addr, image.load_addr);
+		ut_asserteq(DIRECT_DATA_SIZE, image.size);
+
+		src = fit + start;
+		ut_asserteq_mem(src, dst, DIRECT_DATA_SIZE);
+		for (j = 1; j <= 512; j++) {
+			ut_asserteq(0xa5, dst[-j]);
+			ut_asserteq(0xa5, dst[DIRECT_DATA_SIZE + j - 1]);
+		}
+
+		/* The FIT itself, then the partial and whole blocks */
+		rest = DIRECT_DATA_SIZE - min(head, DIRECT_DATA_SIZE);
+		reads = 1 + !!head + !!(rest / 512) + !!(rest % 512);
+		ut_asserteq(reads, mem_ctx.reads);
+		unmap_sysmem(dst);
+	}
+	free(fit);
+
+	return 0;
+}
+SPL_TEST(spl_test_load_direct, 0);
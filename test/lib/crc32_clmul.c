@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for CRC32 / CRC32C using carry-less multiplication
+ */
+
+#include <common.h>
+#include <malloc.h>
+#include <rand.h>
+#include <time.h>
+#include <u-boot/crc.h>
+#include <linux/math64.h>
+#include <test/lib.h>
+#include <test/ut.h>
+
+#define TEST_BUF_SIZE	(64 << 10)
+
+/* Compare against the table-only versions for various lengths and seeds */
+static int lib_test_crc32_clmul(struct unit_test_state *uts)
+{
+	static const size_t lens[] = { 16, 32, 48, 64, 128, 1008, 4096 };
+	uint32_t table[256];
+	u64 *buf;
+	int i, j;
+
+	buf = malloc(4096);
+	ut_assertnonnull(buf);
+	crc32c_init(table, 0x82f63b78);
+
+	srand(0x1234);
+	for (i = 0; i < 4096 / sizeof(u64); i++)
+		buf[i] = (u64)rand() << 32 | rand();
+
+	for (i = 0; i < ARRAY_SIZE(lens); i++) {
+		for (j = 0; j < 4; j++) {
+			uint32_t crc = j ? rand() : 0;
+
+			ut_asserteq(crc32_table_update(crc, (uint8_t *)buf,
+						       lens[i]),
+				    crc32_clmul(crc, (uint8_t *)buf, lens[i]));
+			ut_asserteq(crc32c_table_update(crc, (char *)buf, lens[i],
+							 table),
+				    crc32c_clmul(crc, (uint8_t *)buf, lens[i]));
+		}
+	}
+
+	/* and the versions which pick between them, on an unaligned buffer */
+	for (i = 0; i < ARRAY_SIZE(lens); i++) {
+		size_t len = lens[i] - 3;
+
+		ut_asserteq(crc32_table_update(0, (uint8_t *)buf + 3, len),
+			    crc32_no_comp(0, (uint8_t *)buf + 3, len));
+		ut_asserteq(crc32c_table_update(0, (char *)buf + 3, len, table),
+			    crc32c_cal(0, (char *)buf + 3, len, table));
+	}
+
+	/* crc32() must still give the standard check value */
+	ut_asserteq(0xcbf43926, crc32(0, (uint8_t *)"123456789", 9));
+	free(buf);
+
+	return 0;
+}
+LIB_TEST(lib_test_crc32_clmul, 0);
+
+static ulong crc_rate(ulong bytes, ulong us)
+{
+	return us ? (ulong)div_u64((u64)bytes * 1000000 / 1024, us) : 0;
+}
+
+/* Show the throughput of each version, for comparison on real hardware */
+static int lib_test_crc32_clmul_speed(struct unit_test_state *uts)
+{
+	ulong start, table_us, clmul_us;
+	uint8_t *buf;
+	uint32_t crc;
+
+	buf = malloc(TEST_BUF_SIZE);
+	ut_assertnonnull(buf);
+	memset(buf, 0xa5, TEST_BUF_SIZE);
+
+	start = timer_get_us();
+	crc = crc32_table_update(0, buf, TEST_BUF_SIZE);
+	table_us = timer_get_us() - start;
+
+	start = timer_get_us();
+	ut_asserteq(crc, crc32_clmul(0, buf, TEST_BUF_SIZE));
+	clmul_us = timer_get_us() - start;
+
+	printf("crc32 table: %lu us, %lu KiB/s\n", table_us,
+	       crc_rate(TEST_BUF_SIZE, table_us));
+	printf("crc32 clmul: %lu us, %lu KiB/s\n", clmul_us,
+	       crc_rate(TEST_BUF_SIZE, clmul_us));
+	free(buf);
+
+	return 0;
+}
+LIB_TEST(lib_test_crc32_clmul_speed, 0);
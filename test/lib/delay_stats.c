@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for busy-wait statistics
+ */
+
+#include <common.h>
+#include <delay_stats.h>
+#include <linux/delay.h>
+#include <linux/iopoll.h>
+#include <test/lib.h>
+#include <test/ut.h>
+
+/* Find the only site of a given type which has been used */
+static const struct delay_site *find_site(struct unit_test_state *uts,
+					  enum delay_stats_type type)
+{
+	const struct delay_site *sites, *found = NULL;
+	int count, i;
+
+	count = delay_stats_get(&sites);
+	for (i = 0; i < count; i++) {
+		if (sites[i].count && sites[i].type == type) {
+			if (found)
+				return NULL;
+			found = &sites[i];
+		}
+	}
+
+	return found;
+}
+
+static int poll_count;
+
+static int poll_read(int *limit)
+{
+	return ++poll_count >= *limit;
+}
+
+static int lib_test_delay_stats(struct unit_test_state *uts)
+{
+	const struct delay_site *ds;
+	int limit, val, i;
+
+	delay_stats_reset();
+	for (i = 0; i < 3; i++)
+		udelay(100);
+	ds = find_site(uts, DELAY_STATS_UDELAY);
+	ut_assertnonnull(ds);
+	ut_asserteq(3, ds->count);
+	ut_asserteq(0, ds->timeouts);
+	ut_assert(ds->total >= ds->max);
+	ut_assert(ds->max > 0);
+
+	/* each mdelay() is one wait, however long */
+	delay_stats_reset();
+	for (i = 0; i < 2; i++)
+		mdelay(3);
+	ds = find_site(uts, DELAY_STATS_UDELAY);
+	ut_assertnonnull(ds);
+	ut_asserteq(2, ds->count);
+	ut_assert(ds->max > 0);
+
+	/* a poll which succeeds, then one which times out */
+	delay_stats_reset();
+	for (i = 0; i < 2; i++) {
+		poll_count = 0;
+		limit = i ? INT_MAX : 5;
+		ut_asserteq(i ? -ETIMEDOUT : 0,
+			    read_poll_timeout(poll_read, val, val, 0, 1000,
+					      &limit));
+	}
+	ds = find_site(uts, DELAY_STATS_POLL);
+	ut_assertnonnull(ds);
+	ut_asserteq(2, ds->count);
+	ut_asserteq(1, ds->timeouts);
+
+	return 0;
+}
+LIB_TEST(lib_test_delay_stats, 0);
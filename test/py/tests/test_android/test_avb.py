@@ -37,6 +37,30 @@ def test_avb_verify(u_boot_console):
     assert response.find(success_str)
 
 
+@pytest.mark.buildconfigspec('cmd_avb')
+@pytest.mark.buildconfigspec('cmd_mmc')
+@pytest.mark.buildconfigspec('cmd_memory')
+def test_avb_verify_load_addr(u_boot_console):
+    """Verify the boot partition at a load address and check that it is left
+    there, as read by 'avb read_part'
+    """
+
+    success_str = "Verification passed successfully"
+    size = 0x1000
+
+    response = u_boot_console.run_command('avb init %s' % str(mmc_dev))
+    assert response == ''
+    response = u_boot_console.run_command('avb verify "" %x' % temp_addr)
+    assert success_str in response
+
+    response = u_boot_console.run_command('avb read_part boot 0 %x %x' %
+                                          (size, temp_addr2))
+    assert response == 'Read %d bytes' % size
+    response = u_boot_console.run_command('cmp.b %x %x %x' %
+                                          (temp_addr, temp_addr2, size))
+    assert 'were the same' in response
+
+
 @pytest.mark.buildconfigspec('cmd_avb')
 @pytest.mark.buildconfigspec('cmd_mmc')
 def test_avb_mmc_uuid(u_boot_console):
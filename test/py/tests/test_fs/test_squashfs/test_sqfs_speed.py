@@ -0,0 +1,121 @@
+# SPDX-License-Identifier: GPL-2.0
+
+""" Times loading several files from one SquashFS image.
+
+The image holds a few large files, made of many data blocks, and many small
+files which share fragment blocks. Each file is loaded with its own sqfsload
+command, as a boot script would do, and checked against the original. The
+time taken by each load is printed, for comparison between builds and
+between CONFIG_SQUASHFS_CACHE settings.
+"""
+
+import os
+import random
+import re
+import shutil
+import pytest
+
+from sqfs_common import mksquashfs, check_mksquashfs_version
+from test_sqfs_load import original_md5sum, uboot_md5sum
+
+SPEED_SRC_DIR = 'sqfs_speed_src_dir'
+SPEED_IMAGE = 'sqfs_speed'
+
+# (name, size) of the files in the image
+BIG_FILES = [('big%d' % i, 2 * 1024 * 1024 + i * 1000) for i in range(3)]
+SMALL_FILES = [('small%02d' % i, 500 + i * 97) for i in range(20)]
+
+def generate_file(path, size, rand):
+    """ Generates a file of compressible but not trivial content.
+
+    Args:
+        path: the file's path.
+        size: the file size.
+        rand: random number generator to use.
+    """
+    words = [b'boot', b'kernel', b'initrd', b'squashfs', b'u-boot', b'fdt']
+    content = bytearray()
+    while len(content) < size:
+        content += rand.choice(words) + b'%d ' % rand.randrange(1000)
+
+    with open(path, 'wb') as file:
+        file.write(content[:size])
+
+def generate_speed_image(build_dir):
+    """ Generates the source directory and makes the SquashFS image.
+
+    Args:
+        build_dir: u-boot's build-sandbox directory.
+    Returns:
+        The path to the image.
+    """
+    root = os.path.join(build_dir, SPEED_SRC_DIR)
+    os.makedirs(root)
+    rand = random.Random(0)
+    for name, size in BIG_FILES + SMALL_FILES:
+        generate_file(os.path.join(root, name), size, rand)
+
+    image = os.path.join(build_dir, SPEED_IMAGE)
+    mksquashfs(' '.join([root, image, '-comp gzip -noappend']))
+
+    return image
+
+def clean_speed_image(build_dir):
+    """ Deletes the image and its source directory.
+
+    Args:
+        build_dir: u-boot's build-sandbox directory.
+    """
+    shutil.rmtree(os.path.join(build_dir, SPEED_SRC_DIR))
+    os.remove(os.path.join(build_dir, SPEED_IMAGE))
+
+def sqfs_timed_load(u_boot_console, name, size):
+    """ Loads a file, checks it and returns the time taken.
+
+    Args:
+        u_boot_console: provides the means to interact with U-Boot's console.
+        name: the file to load.
+        size: the file's size.
+    Returns:
+        The time taken by sqfsload, in seconds.
+    """
+    build_dir = u_boot_console.config.build_dir
+    address = '$kernel_addr_r'
+    out = u_boot_console.run_command('time sqfsload host 0 {} {}'.format(
+        address, name))
+    assert str(size) in out
+    seconds = float(re.search(r'time: ([0-9.]+) seconds', out).group(1))
+
+    u_boot_checksum = uboot_md5sum(u_boot_console, address, hex(size))
+    original_path = os.path.join(build_dir, SPEED_SRC_DIR, name)
+    assert u_boot_checksum == original_md5sum(original_path)
+
+    return seconds
+
+@pytest.mark.boardspec('sandbox')
+@pytest.mark.buildconfigspec('cmd_fs_generic')
+@pytest.mark.buildconfigspec('cmd_squashfs')
+@pytest.mark.buildconfigspec('cmd_time')
+@pytest.mark.buildconfigspec('fs_squashfs')
+@pytest.mark.requiredtool('md5sum')
+@pytest.mark.requiredtool('mksquashfs')
+def test_sqfs_speed(u_boot_console):
+    """ Loads every file in the image and reports the time taken.
+
+    Args:
+        u_boot_console: provides the means to interact with U-Boot's console.
+    """
+    build_dir = u_boot_console.config.build_dir
+
+    check_mksquashfs_version()
+    image = generate_speed_image(build_dir)
+    try:
+        u_boot_console.run_command('host bind 0 {}'.format(image))
+        big = sum(sqfs_timed_load(u_boot_console, name, size)
+                  for name, size in BIG_FILES)
+        small = sum(sqfs_timed_load(u_boot_console, name, size)
+                    for name, size in SMALL_FILES)
+        print('squashfs: %d large files in %.3f s, %d small files in %.3f s' %
+              (len(BIG_FILES), big, len(SMALL_FILES), small))
+    finally:
+        clean_speed_image(build_dir)
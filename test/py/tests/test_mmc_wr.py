@@ -6,6 +6,7 @@
 # to the eMMC or SD card, then reads it back and performs a comparison.
 
 import pytest
+import re
 import u_boot_utils
 
 """
@@ -103,3 +104,80 @@ def test_mmc_wr(u_boot_console, env__mmc_wr_config):
         response = u_boot_console.run_command(cmd)
         good_response = 'Total of %d byte(s) were the same' % (count_bytes)
         assert good_response in response
+
+def mmc_timed_write(u_boot_console, src_addr, sector, count_sectors):
+    """Writes to the current MMC device and returns the time taken.
+
+    Args:
+        u_boot_console: A U-Boot console connection.
+        src_addr: The address of the data to write.
+        sector: The first sector to write.
+        count_sectors: The number of sectors to write.
+
+    Returns:
+        The time taken by "mmc write", in seconds.
+    """
+
+    cmd = 'time mmc write %s %x %x' % (src_addr, sector, count_sectors)
+    response = u_boot_console.run_command(cmd)
+    assert '%d blocks written: OK' % count_sectors in response
+    return float(re.search(r'time: ([0-9.]+) seconds', response).group(1))
+
+@pytest.mark.buildconfigspec('cmd_mmc')
+@pytest.mark.buildconfigspec('cmd_memory')
+@pytest.mark.buildconfigspec('cmd_random')
+@pytest.mark.buildconfigspec('cmd_time')
+@pytest.mark.buildconfigspec('mmc_write_cache')
+def test_mmc_wr_cache(u_boot_console, env__mmc_wr_config):
+    """Compare "mmc write" speed with the eMMC write cache off and on.
+
+    The data written with the cache on is flushed, then read back and
+    compared.
+
+    Args:
+        u_boot_console: A U-Boot console connection.
+        env__mmc_wr_config: The single MMC configuration on which
+            to run the test. See the file-level comment above for details
+            of the format.
+
+    Returns:
+        Nothing.
+    """
+
+    if not env__mmc_wr_config['is_emmc']:
+        pytest.skip('Write cache only exists on eMMC')
+
+    devid = env__mmc_wr_config['devid']
+    partid = env__mmc_wr_config.get('partid', 0)
+    sector = env__mmc_wr_config.get('sector', 0)
+    count_sectors = env__mmc_wr_config.get('count', 1)
+    count_bytes = count_sectors * 512
+    ram_base = u_boot_utils.find_ram_base(u_boot_console)
+    src_addr = '0x%08x' % ram_base
+    dst_addr = '0x%08x' % (ram_base + count_bytes)
+
+    u_boot_console.run_command('random %s %x' % (src_addr, count_bytes))
+    response = u_boot_console.run_command('mmc dev %d %d' % (devid, partid))
+    assert 'mmc%d(part %d) is current device' % (devid, partid) in response
+
+    response = u_boot_console.run_command('mmc cache %d on' % devid)
+    if 'Device has no write cache' in response:
+        pytest.skip('Device has no write cache')
+    u_boot_console.run_command('mmc cache %d off' % devid)
+
+    uncached = mmc_timed_write(u_boot_console, src_addr, sector, count_sectors)
+
+    u_boot_console.run_command('mmc cache %d on' % devid)
+    cached = mmc_timed_write(u_boot_console, src_addr, sector, count_sectors)
+    response = u_boot_console.run_command('mmc cache %d off' % devid)
+    assert 'failed' not in response
+
+    cmd = 'mmc read %s %x %x' % (dst_addr, sector, count_sectors)
+    response = u_boot_console.run_command(cmd)
+    assert '%d blocks read: OK' % count_sectors in response
+    cmd = 'cmp.b %s %s %x' % (src_addr, dst_addr, count_bytes)
+    response = u_boot_console.run_command(cmd)
+    assert 'Total of %d byte(s) were the same' % count_bytes in response
+
+    print('mmc write: %.3f s without cache, %.3f s with cache' %
+          (uncached, cached))
@@ -0,0 +1,71 @@
+# SPDX-License-Identifier: GPL-2.0
+
+# Test attaching a UBI device by fastmap. The partition is attached by
+# scanning, a fastmap is written with "ubi fastmap", and the partition is
+# attached again, which must then use the fastmap and find the same volumes.
+# The time taken by both attaches is printed.
+
+import pytest
+import re
+
+"""
+This test relies on boardenv_* to name an MTD partition holding a UBI
+device, which the test does not modify apart from writing a fastmap:
+
+env__ubi_fastmap_config = {
+    "partition": "ubi",
+}
+"""
+
+def ubi_timed_attach(u_boot_console, partition):
+    """Attaches a partition afresh and returns the response and time taken.
+
+    Args:
+        u_boot_console: A U-Boot console connection.
+        partition: The MTD partition to attach.
+
+    Returns:
+        The response of "ubi part", and the time it took in seconds.
+    """
+
+    u_boot_console.run_command('ubi detach')
+    response = u_boot_console.run_command('time ubi part %s' % partition)
+    assert 'UBI init error' not in response
+    seconds = float(re.search(r'time: ([0-9.]+) seconds', response).group(1))
+    return response, seconds
+
+@pytest.mark.buildconfigspec('cmd_ubi')
+@pytest.mark.buildconfigspec('cmd_time')
+@pytest.mark.buildconfigspec('mtd_ubi_fastmap')
+def test_ubi_fastmap(u_boot_console):
+    """Compare the time to attach a UBI device by scanning and by fastmap.
+
+    Args:
+        u_boot_console: A U-Boot console connection.
+
+    Returns:
+        Nothing.
+    """
+
+    f = u_boot_console.config.env.get('env__ubi_fastmap_config', None)
+    if not f:
+        pytest.skip('No UBI partition configured')
+    partition = f['partition']
+
+    try:
+        _, first = ubi_timed_attach(u_boot_console, partition)
+        layout = u_boot_console.run_command('ubi info layout')
+
+        response = u_boot_console.run_command('ubi fastmap')
+        if 'too small for a fastmap' in response:
+            pytest.skip('Partition too small for a fastmap')
+        assert 'Wrote fastmap' in response
+
+        response, fast = ubi_timed_attach(u_boot_console, partition)
+        assert 'attached by fastmap' in response
+        assert u_boot_console.run_command('ubi info layout') == layout
+
+        print('ubi: first attach in %.3f s, attach by fastmap in %.3f s' %
+              (first, fast))
+    finally:
+        u_boot_console.run_command('ubi detach')
@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-2.0+
+"""Write the block-hash manifest of an image, for delta flashing.
+
+The manifest lists the SHA256 of each chunk of the image, so that U-Boot
+only writes the chunks that differ from what the device holds already:
+
+    blockhash sha256 <chunk size> <image size>
+    <sha256 of chunk 0, in hex>
+    ...
+
+flash_image looks for it in "<image>.bhm"; over fastboot it is sent with
+'fastboot flash blockhash:<partition> <manifest>' before the image.
+"""
+
+import argparse
+import hashlib
+import os
+
+MAX_CHUNK_SIZE = 4 << 20
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('image', help='image to describe')
+    parser.add_argument('-c', '--chunk-size', type=lambda x: int(x, 0),
+                        default=1 << 20, help='chunk size (default 1MiB)')
+    parser.add_argument('-o', '--output',
+                        help='manifest to write (default <image>.bhm)')
+    args = parser.parse_args()
+
+    if (not 0 < args.chunk_size <= MAX_CHUNK_SIZE or
+            args.chunk_size % 512):
+        parser.error('chunk size must be a multiple of 512, up to 4MiB')
+
+    size = os.path.getsize(args.image)
+    if not size:
+        parser.error('image is empty')
+
+    with open(args.image, 'rb') as image, \
+            open(args.output or args.image + '.bhm', 'w') as manifest:
+        manifest.write('blockhash sha256 %d %d\n' % (args.chunk_size, size))
+        while True:
+            chunk = image.read(args.chunk_size)
+            if not chunk:
+                break
+            manifest.write(hashlib.sha256(chunk).hexdigest() + '\n')
+
+
+if __name__ == '__main__':
+    main()
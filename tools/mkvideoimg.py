@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-2.0+
+
+"""
+Convert a PNG/BMP file into a pre-converted U-Boot splash image.
+
+The pixels are written in the native frame-buffer format of the target panel
+and compressed with LZ4, so that U-Boot can decompress them straight into the
+frame buffer. See include/video_img.h for the layout.
+
+Example, for a full-screen 1080p splash on a 32bpp display:
+
+    tools/mkvideoimg.py -s 1920x1080 logo.png splash.img
+"""
+
+import argparse
+import struct
+import subprocess
+import sys
+
+from PIL import Image
+
+MAGIC = b'UVIM'
+HEADER_FMT = '<4sLLHHBBBB'
+
+# enum video_log2_bpp
+VIDEO_BPP16 = 4
+VIDEO_BPP32 = 5
+
+# enum video_format
+VIDEO_UNKNOWN = 0
+VIDEO_X8B8G8R8 = 1
+VIDEO_X8R8G8B8 = 2
+VIDEO_X2R10G10B10 = 3
+
+# enum video_img_comp
+COMP_NONE = 0
+COMP_LZ4 = 1
+
+FORMATS = {
+    'rgb565': (VIDEO_BPP16, VIDEO_UNKNOWN),
+    'xrgb8888': (VIDEO_BPP32, VIDEO_X8R8G8B8),
+    'xbgr8888': (VIDEO_BPP32, VIDEO_X8B8G8R8),
+    'xrgb2101010': (VIDEO_BPP32, VIDEO_X2R10G10B10),
+}
+
+def parse_args():
+    """Parse command line arguments."""
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[1])
+    parser.add_argument('input', help='input image (PNG, BMP, ...)')
+    parser.add_argument('output', help='output splash image')
+    parser.add_argument('-f', '--format', choices=FORMATS.keys(),
+                        default='xrgb8888', help='pixel format of the display')
+    parser.add_argument('-s', '--screen', type=str,
+                        help='WxH: centre the image on a full screen of this '
+                        'size, so it can be decompressed straight into the '
+                        'frame buffer')
+    parser.add_argument('-b', '--background', type=str, default='000000',
+                        help='RRGGBB colour for the area around the image '
+                        'with --screen')
+    parser.add_argument('-n', '--no-compress', action='store_true',
+                        help='store the pixels uncompressed')
+    return parser.parse_args()
+
+def convert_pixels(img, fmt):
+    """Convert an RGB image to the raw pixel data for the display format.
+
+    Returns:
+        bytes of pixel data, row after row with no padding
+    """
+    out = bytearray()
+    for r, g, b in img.getdata():
+        if fmt == 'rgb565':
+            out += struct.pack('<H', (r >> 3) << 11 | (g >> 2) << 5 | b >> 3)
+        elif fmt == 'xrgb8888':
+            out += struct.pack('<L', r << 16 | g << 8 | b)
+        elif fmt == 'xbgr8888':
+            out += struct.pack('<L', b << 16 | g << 8 | r)
+        else:
+            out += struct.pack('<L', r << 22 | g << 12 | b << 2)
+    return bytes(out)
+
+def lz4_compress(data):
+    """Compress data as a single LZ4 frame with independent blocks."""
+    try:
+        import lz4.frame
+        return lz4.frame.compress(data, block_linked=False,
+                                  compression_level=lz4.frame.COMPRESSIONLEVEL_MAX)
+    except ImportError:
+        return subprocess.run(['lz4', '-9', '-c', '--no-frame-crc'],
+                              input=data, stdout=subprocess.PIPE,
+                              check=True).stdout
+
+def main():
+    """Create the splash image."""
+    args = parse_args()
+    img = Image.open(args.input).convert('RGB')
+
+    if args.screen:
+        width, height = (int(val) for val in args.screen.split('x'))
+        if img.width > width or img.height > height:
+            sys.exit('Image %dx%d does not fit on a %dx%d screen' %
+                     (img.width, img.height, width, height))
+        screen = Image.new('RGB', (width, height),
+                           '#' + args.background)
+        screen.paste(img, ((width - img.width) // 2,
+                           (height - img.height) // 2))
+        img = screen
+
+    bpix, fmt = FORMATS[args.format]
+    data = convert_pixels(img, args.format)
+    comp = COMP_NONE if args.no_compress else COMP_LZ4
+    if comp == COMP_LZ4:
+        data = lz4_compress(data)
+
+    hdr = struct.pack(HEADER_FMT, MAGIC, struct.calcsize(HEADER_FMT),
+                      len(data), img.width, img.height, bpix, fmt, comp, 0)
+    with open(args.output, 'wb') as outf:
+        outf.write(hdr)
+        outf.write(data)
+
+if __name__ == '__main__':
+    main()
@@ -21,6 +21,7 @@
 #include <trace.h>
 
 #define MAX_LINE_LEN 500
+#define MAX_STACK_DEPTH 200
 
 enum {
 	FUNCF_TRACE	= 1 << 0,	/* Include this function in trace */
@@ -54,6 +55,7 @@ struct trace_configline_info *trace_config_head;
 struct func_info *func_list;
 int func_count;
 struct trace_call *call_list;
+int *call_cpu;		/* CPU which made each call in call_list */
 int call_count;
 int verbose;	/* Verbosity level 0=none, 1=warn, 2=notice, 3=info, 4=debug */
 unsigned long text_offset;		/* text address of first function */
@@ -85,6 +87,7 @@ static void usage(void)
 		"\n"
 		"Commands\n"
 		"   dump-ftrace\t\tDump out textual data in ftrace format\n"
+		"   dump-flamegraph\tDump out stacks for flamegraph.pl\n"
 		"\n"
 		"Options:\n"
 		"   -m <map>\tSpecify Systen.map file\n"
@@ -205,23 +208,25 @@ static struct func_info *find_caller_by_offset(uint32_t offset)
 	return low >= 0 ? &func_list[low] : NULL;
 }
 
-static int read_calls(FILE *fin, size_t count)
+/* Read a chunk of calls, adding them to any read from previous chunks */
+static int read_calls(FILE *fin, size_t count, int cpu)
 {
 	struct trace_call *call_data;
 	int i;
 
-	notice("call count: %zu\n", count);
-	call_list = (struct trace_call *)calloc(count, sizeof(*call_data));
-	if (!call_list) {
+	notice("call count: %zu on CPU %d\n", count, cpu);
+	call_list = realloc(call_list, (call_count + count) * sizeof(*call_data));
+	call_cpu = realloc(call_cpu, (call_count + count) * sizeof(*call_cpu));
+	if (!call_list || !call_cpu) {
 		error("Cannot allocate call_list\n");
 		return -1;
 	}
-	call_count = count;
 
-	call_data = call_list;
+	call_data = call_list + call_count;
 	for (i = 0; i < count; i++, call_data++) {
 		if (read_data(fin, call_data, sizeof(*call_data)))
 			return 1;
+		call_cpu[call_count++] = cpu;
 	}
 	return 0;
 }
@@ -243,10 +248,13 @@ static int read_profile(FILE *fin, int *not_found)
 		switch (hdr.type) {
 		case TRACE_CHUNK_FUNCS:
 			/* Ignored at present */
+			if (fseek(fin, hdr.rec_count *
+				  sizeof(struct trace_output_func), SEEK_CUR))
+				return 1;
 			break;
 
 		case TRACE_CHUNK_CALLS:
-			if (read_calls(fin, hdr.rec_count))
+			if (read_calls(fin, hdr.rec_count, hdr.cpu))
 				return 1;
 			break;
 		}
@@ -520,7 +528,7 @@ static int make_ftrace(void)
 			continue;
 		}
 
-		printf("%16s-%-5d [01] %lu.%06lu: ", "uboot", 1,
+		printf("%16s-%-5d [%02d] %lu.%06lu: ", "uboot", 1, call_cpu[i],
 		       time / 1000000, time % 1000000);
 
 		out_func(call->func, 0, " <- ");
@@ -532,6 +540,112 @@ static int make_ftrace(void)
 	return 0;
 }
 
+/* Time spent with a particular call stack, in microseconds */
+struct flame_stack {
+	char *stack;
+	unsigned long us;
+};
+
+static struct flame_stack *flame_list;
+static int flame_count, flame_size;
+
+static int h_cmp_stack(const void *v1, const void *v2)
+{
+	const struct flame_stack *s1 = v1, *s2 = v2;
+
+	return strcmp(s1->stack, s2->stack);
+}
+
+/* Record @us spent in the given stack, e.g. "hart0;board_init_r;puts" */
+static int add_flame(int cpu, struct func_info **stack, int depth,
+		     unsigned long us)
+{
+	char buf[MAX_STACK_DEPTH * 40], *ptr = buf, *end = buf + sizeof(buf);
+	int i;
+
+	if (!us)
+		return 0;
+	ptr += snprintf(ptr, end - ptr, "hart%d", cpu);
+	for (i = 0; i < depth && ptr < end; i++)
+		ptr += snprintf(ptr, end - ptr, ";%s", stack[i]->name);
+
+	if (flame_count == flame_size) {
+		flame_size = flame_size ? flame_size * 2 : 1024;
+		flame_list = realloc(flame_list,
+				     flame_size * sizeof(*flame_list));
+		if (!flame_list) {
+			error("Cannot allocate flame list\n");
+			return -1;
+		}
+	}
+	flame_list[flame_count].stack = strdup(buf);
+	flame_list[flame_count].us = us;
+	flame_count++;
+
+	return 0;
+}
+
+/*
+ * Write out the 'folded' format used by flamegraph.pl: one line for each
+ * call stack, with the total time spent in the innermost function while it
+ * was called from that stack (i.e. excluding its callees). The trace must
+ * be complete at the top, since calls are matched with returns.
+ */
+static int make_flamegraph(void)
+{
+	struct func_info *stack[MAX_STACK_DEPTH];
+	unsigned long last = 0;
+	int depth = 0, cpu = -1;
+	int i, j;
+
+	for (i = 0; i < call_count; i++) {
+		struct trace_call *call = &call_list[i];
+		struct func_info *func = find_func_by_offset(call->func);
+		ulong time = call->flags & FUNCF_TIMESTAMP_MASK;
+
+		if (TRACE_CALL_TYPE(call) != FUNCF_ENTRY &&
+		    TRACE_CALL_TYPE(call) != FUNCF_EXIT)
+			continue;
+
+		/* Each CPU starts a new set of stacks */
+		if (call_cpu[i] != cpu) {
+			cpu = call_cpu[i];
+			depth = 0;
+			last = time;
+		}
+		if (add_flame(cpu, stack, depth, time - last))
+			return -1;
+		last = time;
+
+		if (TRACE_CALL_TYPE(call) == FUNCF_ENTRY) {
+			if (!func) {
+				warn("Cannot find function at %lx\n",
+				     text_offset + call->func);
+				return -1;
+			}
+			if (depth == MAX_STACK_DEPTH) {
+				error("Call stack too deep\n");
+				return -1;
+			}
+			stack[depth++] = func;
+		} else if (depth) {
+			depth--;
+		}
+	}
+
+	qsort(flame_list, flame_count, sizeof(*flame_list), h_cmp_stack);
+	for (i = 0; i < flame_count; i = j) {
+		unsigned long us = 0;
+
+		for (j = i; j < flame_count &&
+		     !strcmp(flame_list[i].stack, flame_list[j].stack); j++)
+			us += flame_list[j].us;
+		printf("%s %lu\n", flame_list[i].stack, us);
+	}
+
+	return 0;
+}
+
 static int prof_tool(int argc, char *const argv[],
 		     const char *prof_fname, const char *map_fname,
 		     const char *trace_config_fname)
@@ -552,6 +666,8 @@ static int prof_tool(int argc, char *const argv[],
 
 		if (0 == strcmp(cmd, "dump-ftrace"))
 			err = make_ftrace();
+		else if (0 == strcmp(cmd, "dump-flamegraph"))
+			err = make_flamegraph();
 		else
 			warn("Unknown command '%s'\n", cmd);
 	}